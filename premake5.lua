@@ -72,7 +72,7 @@ workspace "yacbnl"
 
     files { "src/test/*.c" }
 
-    links { "m", "criterion", "yacbnl" }
+    links { "m", "criterion", "yacbnl", "pthread" }
 
     targetdir "bin/%{cfg.buildcfg}"
     targetname "test_%{wks.name}"
@@ -39,4 +39,27 @@ uint16_t samb_twoarray_to_u16 (const atom_t arr[2]) {
   return samb_twoba_to_u16(arr[0], arr[1]);
 }
 
+/*
+  uint32_t, atom_t* ->
+
+  the four values at arr are changed to the bytes of n, most significant first,
+    as samb_u16_to_twoba does for two (see TYP_HUGE)
+*/
+void samb_u32_to_fourba (const uint32_t n, atom_t* const arr) {
+  for (atom_t i = 0; i < 4; i++) {
+    arr[i] = (atom_t) (n >> (8 * (3 - i)));
+  }
+}
+
+/*
+  atom_t* -> uint32_t
+
+  the value of four consecutive bytes, most significant first
+
+  inverse of samb_u32_to_fourba
+*/
+uint32_t samb_fourarray_to_u32 (const atom_t* const arr) {
+  return ((uint32_t) arr[0] << 24) | ((uint32_t) arr[1] << 16) | ((uint32_t) arr[2] << 8) | arr[3];
+}
+
 #endif /* end of include guard: ADDR_INTERP_H */
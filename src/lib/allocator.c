@@ -0,0 +1,131 @@
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include "bn_common.h"
+
+/*
+  the allocator every part of the library goes through, by way of the alloc
+    and zalloc macros, bn_realloc and bn_free
+
+  it is malloc, realloc and free until bn_set_allocator is given another; it
+    is not synchronised, so it should be set before the library is used, and
+    not while other threads are in it
+
+  everything the library returns must be released with bn_free (or the
+    allocator's own free) rather than with free, unless the allocator is the
+    default one
+
+  bn_pool_allocator (see pool.c) is one that keeps freed blocks for reuse
+*/
+
+static void* allocator_std_malloc (const size_t size, void* const ctx) {
+  (void) ctx;
+  return malloc(size);
+}
+
+static void* allocator_std_realloc (void* const ptr, const size_t size, void* const ctx) {
+  (void) ctx;
+  return realloc(ptr, size);
+}
+
+static void allocator_std_free (void* const ptr, void* const ctx) {
+  (void) ctx;
+  free(ptr);
+}
+
+static bn_allocator_t allocator_current = {
+  allocator_std_malloc, allocator_std_realloc, allocator_std_free, NULL
+};
+
+/*
+  bn_allocator_t* -> bool
+
+  use the given allocator for everything the library allocates from now on,
+    or the default one again if a is NULL; what is already allocated must be
+    released by the allocator that made it, and the calling thread's scratch
+    space (see scratch.c) and pooled blocks (see pool.c) are released here,
+    but other threads' must be released first
+
+  false is returned, and errno set to EINVAL, if any of the three functions
+    are missing, and the allocator is not changed
+*/
+bool bn_set_allocator (const bn_allocator_t* const a) {
+  if (NULL != a && (NULL == a->malloc_fn || NULL == a->realloc_fn || NULL == a->free_fn)) {
+    errno = EINVAL;
+    return false;
+  }
+
+  /* the calling thread's scratch blocks came from the old allocator, and the pool's lists are no use after it */
+  bn_scratch_release();
+  bn_pool_release();
+
+  if (NULL == a) {
+    const bn_allocator_t std = { allocator_std_malloc, allocator_std_realloc, allocator_std_free, NULL };
+    allocator_current = std;
+    return true;
+  }
+
+  allocator_current = *a;
+  return true;
+}
+
+/*
+  void -> bn_allocator_t
+
+  the allocator in use
+*/
+bn_allocator_t bn_get_allocator (void) {
+  return allocator_current;
+}
+
+/*
+  size_t -> void*
+
+  size bytes from the allocator, or NULL, with errno set to ENOMEM whatever
+    the allocator did with it
+*/
+void* bn_malloc (const size_t size) {
+  void* const p = allocator_current.malloc_fn(size, allocator_current.ctx);
+  if (NULL == p) { errno = ENOMEM; }
+  return p;
+}
+
+/*
+  size_t, size_t -> void*
+
+  n zeroed elements of size bytes from the allocator, or NULL, which is also
+    returned if n * size overflows; errno is set to ENOMEM either way
+*/
+void* bn_calloc (const size_t n, const size_t size) {
+  if (size && n > SIZE_MAX / size) {
+    errno = ENOMEM;
+    return NULL;
+  }
+
+  void* const p = bn_malloc(n * size);
+  if (NULL != p) { memset(p, 0, n * size); }
+  return p;
+}
+
+/*
+  void*, size_t -> void*
+
+  ptr, from the allocator, grown or shrunk to size bytes, or NULL, in which
+    case ptr is untouched and errno is set to ENOMEM
+*/
+void* bn_realloc (void* const ptr, const size_t size) {
+  void* const p = allocator_current.realloc_fn(ptr, size, allocator_current.ctx);
+  if (NULL == p) { errno = ENOMEM; }
+  return p;
+}
+
+/*
+  void* ->
+
+  release ptr, which came from the allocator, or is NULL
+*/
+void bn_free (void* const ptr) {
+  if (NULL != ptr) { allocator_current.free_fn(ptr, allocator_current.ctx); }
+}
+
+#endif /* end of include guard: ALLOCATOR_H */
@@ -3,36 +3,120 @@
 
 #include "bn_common.h"
 
-static atom_t* impl_to_digit_array_ldbl (const ldbl_t ldbl,  const atom_t metadata, const atom_t flags);
-static atom_t*  impl_to_digit_array_u64 (const uint64_t u64, const atom_t metadata, const atom_t flags);
+static size_t impl_to_digit_array_into (atom_t* const out, const size_t cap, const ldbl_t ldbl_in, const uint64_t u64, const atom_t value_flags, const atom_t metadata, const bool from_dbl);
 
-/* create the first 4 or 6 bytes at the beginning of every digit array */
-atom_t* make_array_header (const atom_t metadata, const uint16_t int_digits, const uint16_t flot_digits, const atom_t flags) {
+/*
+  the shortest digits of the positive, finite mag that read back as the same
+    long double, or with from_dbl, as the same double (which mag holds exactly)
+*/
+static atom_t factory_shortest_digits (const ldbl_t mag, const bool from_dbl, atom_t* const sig, int32_t* const dec_exp) {
+  return from_dbl ? dbl_to_shortest_digits((double) mag, sig, dec_exp) : ldbl_to_shortest_digits(mag, sig, dec_exp);
+}
+
+/*
+  atom_t*, size_t, atom_t, size_t, size_t, atom_t -> size_t
+
+  write the first 4, 6 or 10 bytes at the beginning of every digit array, or
+    the first 1 or 2 with TYP_COMPACT, into the caller's buffer out, which has
+    room for cap of them, and give the header's length; nothing is written
+    when out is NULL or cap is too small, so the length can be asked for first
 
-  const atom_t  hdrlen = meta_header_offset(metadata);
-  atom_t* const header = zalloc(atom_t, hdrlen);
+  a compact header is short (see CMP_SHORT) whenever the array is a
+    non-negative integer of at most CMP_SHORT_LEN digits, so its length should
+    be read back from it with bna_header_offset, not from metadata
+
+  0 is returned, and errno set to ERANGE, if either length is longer than
+    the addressing mode can describe (see meta_max_len), rather than cut short
+*/
+size_t make_array_header_into (atom_t* const out, const size_t cap, const atom_t metadata, const size_t int_digits, const size_t flot_digits, const atom_t flags) {
+
+  if (int_digits > meta_max_len(metadata) || flot_digits > meta_max_len(metadata)) {
+    errno = ERANGE;
+    return 0;
+  }
+
+  if ( meta_is_compact(metadata) ) {
+    /* only the bits which keep their meaning are copied */
+    const atom_t type     = (atom_t) (metadata & (TYP_COMPACT | TYP_ZENZ | TYP_PACK | TYP_BCD));
+    const bool   is_short = FL_NONE == flags && 0 == flot_digits && int_digits <= CMP_SHORT_LEN;
+    const size_t hdrlen   = is_short ? HEADER_OFFSET_SHORT : HEADER_OFFSET_COMPACT;
+
+    if (NULL == out || cap < hdrlen) { return hdrlen; }
+
+    if (is_short) {
+      out[0] = (atom_t) (type | CMP_SHORT | cmp_value_bits(int_digits));
+    } else {
+      out[0] = (atom_t) (type | cmp_value_bits(flags));
+      out[1] = (atom_t) (int_digits << 4 | flot_digits);
+    }
+    return hdrlen;
+  }
 
+  const atom_t hdrlen = meta_header_offset(metadata);
+  if (NULL == out || cap < hdrlen) { return hdrlen; }
+
+  memset(out, 0, hdrlen);
   /* first byte is the type and base */
-  header[0]          = metadata;
+  out[0]          = metadata;
   /* last byte is flags */
-  header[hdrlen - 1] = flags;
+  out[hdrlen - 1] = flags;
+
+  if ( meta_is_huge(metadata) ) {
+    samb_u32_to_fourba((uint32_t) int_digits,  out + 1);
+    samb_u32_to_fourba((uint32_t) flot_digits, out + 5);
 
-  if ( meta_is_big(metadata) ) {
+  } else if ( meta_is_big(metadata) ) {
     atom_t lens[] = { 0, 0, 0, 0 };
 
     /* set the lengths by using the addresses of the array elements */
-    samb_u16_to_twoba(int_digits,  lens + 0, lens + 1);
-    samb_u16_to_twoba(flot_digits, lens + 2, lens + 3);
+    samb_u16_to_twoba((uint16_t) int_digits,  lens + 0, lens + 1);
+    samb_u16_to_twoba((uint16_t) flot_digits, lens + 2, lens + 3);
 
     /* paste four bytes between the metadata and flags */
-    memcpy(header + 1, &lens, sz(atom_t, 4) );
+    memcpy(out + 1, &lens, sz(atom_t, 4) );
 
   } else {
-    header[1] = (atom_t) int_digits;
-    header[2] = (atom_t) flot_digits;
+    out[1] = (atom_t) int_digits;
+    out[2] = (atom_t) flot_digits;
   }
 
-  return header;
+  return hdrlen;
+}
+
+/*
+  atom_t, size_t, size_t, atom_t -> atom_t*
+
+  a new header, as made by make_array_header_into
+
+  NULL is returned, and errno set to ERANGE, if either length is longer than
+    the addressing mode can describe
+*/
+atom_t* make_array_header (const atom_t metadata, const size_t int_digits, const size_t flot_digits, const atom_t flags) {
+  atom_t header[HEADER_OFFSET_HUGE];
+
+  const size_t hdrlen = make_array_header_into(header, HEADER_OFFSET_HUGE, metadata, int_digits, flot_digits, flags);
+  if (0 == hdrlen) { return NULL; }
+
+  atom_t* const out = alloc(atom_t, hdrlen);
+  if (NULL == out) { return NULL; }
+
+  memcpy(out, header, hdrlen);
+  return out;
+}
+
+/* to_digit_array, or dbl_to_digit_array with from_dbl, measured and then laid out */
+static atom_t* impl_to_digit_array (const ldbl_t ldbl_in, const uint64_t u64, const atom_t value_flags, const atom_t metadata, const bool from_dbl) {
+  const size_t need = impl_to_digit_array_into(NULL, 0, ldbl_in, u64, value_flags, metadata, from_dbl);
+  if (0 == need) { return NULL; }
+
+  atom_t* const bna = alloc(atom_t, need);
+  if (NULL == bna) { return NULL; }
+
+  if (0 == impl_to_digit_array_into(bna, need, ldbl_in, u64, value_flags, metadata, from_dbl)) {
+    bn_free(bna);
+    return NULL;
+  }
+  return bna;
 }
 
 /*
@@ -42,193 +126,321 @@ atom_t* make_array_header (const atom_t metadata, const uint16_t int_digits, con
   primitive arguments, or zero if both are.
 
   value metadata, like signedness, infiniteness and nan-ness should be indicated in
-  flags, not some cryptic value for argument #1 ldbl_t
+  flags, not some cryptic value for argument #1 ldbl_t; an infinite or NaN
+  argument #1 only sets FL_INF or FL_NAN, with no digits
 
   for example, signed zero would best be represented by to_bn_array(0, 0, FL_SIGN, 0).
+
+  a packed array (see TYP_PACK and TYP_BCD) is packed from the base 10 one
+
+  the digits of ldbl are the shortest that read back as exactly the same long
+    double, so nothing is lost; a value which was a double should be given to
+    dbl_to_digit_array instead, for the shortest digits of the double, so
+    that 0.1 gives 0.1 and not 0.1000000000000000055511
+
+  the array is measured and laid out by to_digit_array_into, in one
+    allocation
+
+  NULL is returned and errno set to ERANGE when a part is too long for the
+    header (with TYP_COMPACT, more than CMP_MAX_LEN digits, or words, or
+    bytes), or to ENOMEM
 */
 atom_t* to_digit_array (const ldbl_t ldbl_in, const uint64_t u64, const atom_t value_flags, const atom_t metadata) {
+  return impl_to_digit_array(ldbl_in, u64, value_flags, metadata, false);
+}
 
-  const atom_t flags = ldbl_in < 0 ? value_flags | FL_SIGN : value_flags;
-  const ldbl_t ldbl  = ldbl_in < 0 ? fabsl(ldbl_in) : ldbl_in;
+/*
+  double, atom_t, atom_t -> atom_t*
 
-  // not zero so we'll use it
-  if ( ! compare_eps(ldbl, 0.f, COMPARE_EPS) ) {
-    return impl_to_digit_array_ldbl(ldbl, metadata, flags);
+  to_digit_array for a double, whose digits are the shortest that read back
+    as exactly the same double
+*/
+atom_t* dbl_to_digit_array (const double dbl, const atom_t value_flags, const atom_t metadata) {
+  return impl_to_digit_array(dbl, 0, value_flags, metadata, true);
+}
 
-  // use this instead
-  } else if ( 0 != u64 ) {
-    return impl_to_digit_array_u64(u64, metadata, flags);
+/*
+  atom_t*, size_t, atom_t*, size_t, size_t, atom_t, atom_t -> size_t
+
+  lay out a digit array with the given metadata and flags of len base 10
+    digits, of which the first int_len are the integer part, in the caller's
+    buffer out, which has room for cap atoms, and give its length; nothing is
+    written when out is NULL or cap is too small
+
+  packed and BCD arrays are as from b10_to_pk_array_into and
+    b10_to_bcd_array_into; a base 256 one is converted each time it is asked
+    for, in memory of its own
 
-  } else /* both are zero, just give zero */ {
-    return make_array_header(metadata, 0, 0, flags);
+  0 is returned, and errno set to ERANGE when a part is too long for the
+    header, or to ENOMEM
+*/
+static size_t factory_b10_into (atom_t* const out, const size_t cap, const atom_t* const digits, const size_t len, const size_t int_len, const atom_t metadata, const atom_t flags) {
+
+  if ( meta_is_packed(metadata) ) {
+    return b10_to_pk_array_into(out, cap, digits, len, int_len, metadata, flags);
+
+  } else if ( meta_is_bcd(metadata) ) {
+    return b10_to_bcd_array_into(out, cap, digits, len, int_len, metadata, flags);
+  }
+
+  atom_t header[HEADER_OFFSET_HUGE];
+
+  if ( meta_is_base256(metadata) ) {
+    size_t b256_len = 0, b256_int_len = 0;
+    atom_t* const b256 = b10_to_b256_z(digits, len, int_len, &b256_len, &b256_int_len);
+    if (NULL == b256) { return 0; }
+
+    const size_t hdrlen = make_array_header_into(header, HEADER_OFFSET_HUGE, metadata, b256_int_len, b256_len - b256_int_len, flags),
+                 need   = 0 == hdrlen ? 0 : hdrlen + b256_len;
+
+    if (0 != need && NULL != out && cap >= need) {
+      memcpy(out, header, hdrlen);
+      memcpy(out + hdrlen, b256, b256_len);
+    }
+
+    bn_free(b256);
+    return need;
   }
 
-  return NULL;
+  const size_t hdrlen = make_array_header_into(header, HEADER_OFFSET_HUGE, metadata, int_len, len - int_len, flags);
+  if (0 == hdrlen) { return 0; }
+
+  const size_t need = hdrlen + len;
+  if (NULL == out || cap < need) { return need; }
+
+  memcpy(out, header, hdrlen);
+  if (len) { memcpy(out + hdrlen, digits, len); }
+  return need;
 }
 
-/* IMPLEMENTATIONS */
+/* to_digit_array_into, or dbl_to_digit_array_into with from_dbl */
+static size_t impl_to_digit_array_into (atom_t* const out, const size_t cap, const ldbl_t ldbl_in, const uint64_t u64, const atom_t value_flags, const atom_t metadata, const bool from_dbl) {
 
-/*
-  ldbl_t, atom_t, atom_t -> atom_t*
+  atom_t flags = ldbl_in < 0 ? value_flags | FL_SIGN : value_flags;
+  const ldbl_t ldbl = fabsl(ldbl_in);
 
-  represent a long double number as an array of digits
+  /* significant digits, which land at [lead, lead + nsig), surrounded by zeroes */
+  atom_t sig[MAX_PRIMITIVE_LDBL_DIGITS];
+  size_t nsig = 0, lead = 0, int_len = 0, frac_len = 0;
 
-  the values of metadata and flags are copied into the resulting array
+  if ( isnan(ldbl) ) {
+    flags |= FL_NAN;
 
-  the caller should have checked whether ldbl is within 1e-11 of 0, therefore,
-    this check is not done
-*/
-static atom_t* impl_to_digit_array_ldbl (const ldbl_t ldbl, const atom_t metadata, const atom_t flags) {
-
-  /* important metadata flags */
-  const bool is_base256 = meta_is_base256(metadata),
-                 is_big = meta_is_big(metadata);
-
-  /* length of the entire header section */
-  const atom_t hdrlen    = meta_header_offset(metadata);
-  /* upper bound on significant figures we can store in one array */
-  const uint32_t sigfigs = is_big ? MAX_EXPORT_SIGFIGS_BIG : MAX_EXPORT_SIGFIGS;
-
-  /* put the entire value into a string, which may have trailing zeroes */
-  char * const fullstr  = alloc(char, sigfigs + 3 /* separator + null */); // 1
-  snprintf(fullstr, sigfigs + 2 /* sep */, "%LG", ldbl);
-
-  const atom_t
-    // already in fullstr form but the question is, which has lower time complexity
-#ifdef PREFER_CHAR_CONV
-    // naive string ops
-    nint_digits  = (atom_t) strcspn(fullstr, DECIMAL_SEPARATOR_STR),
-#else /* ! PREFER_CHAR_CONV */
-    // O(1) maths
-    nint_digits  = count_digits_u64( (uint64_t) floorl(ldbl) ),
-#endif /* PREFER_CHAR_CONV */
-    nflot_digits = count_frac_digits(fullstr);
-
-  //printf("digits: %d %d\n", nint_digits, nflot_digits);
-  //printf("!!! DBGPRN %LG %s\n", ldbl, fullstr);
-
-  /* make space for the entire new data and store the metadata as a header */
-  atom_t *  bn_tlated = alloc(atom_t, nint_digits + nflot_digits + hdrlen),  // 2
-         * const init = make_array_header(metadata, nint_digits, nflot_digits, flags); // 3
-
-  /* put the new header in the initial section of new data */
-  memcpy(bn_tlated, init, sz(atom_t, hdrlen));
-  free(init); // ~3
-
-  if (is_base256) {
-    /* convert fullstr to array representation */
-    uint16_t len, int_len;
-    /* little endian*/
-    atom_t* as_digits = ldbl_digits_to_b256(fullstr, &len, &int_len, true);
-
-    free(fullstr);
-    /* just copy the data into the rest of the array */
-    memcpy(bn_tlated + hdrlen, as_digits, len);
-
-  } else /* base 10 */ {
-
-      /* going to do the integral component */
-#ifdef PREFER_CHAR_CONV
-    /* more naive simple string operations */
-    char* const integ_str = strndup_c(fullstr, nint_digits); // 4
-    for (atom_t i = 0; i < nint_digits; i++) {
-      bn_tlated[i + hdrlen] = (atom_t) ((unsigned) integ_str[i] - '0');
-    }
-    free(integ_str); // ~4
-#else /* ! PREFER_CHAR_CONV */
-    /* because it is integral we can do this part with integer math */
-    for (atom_t i = 0; i < nint_digits; i++) {
-      bn_tlated[i + hdrlen] = get_left_nth_digit( (uint64_t) floorl(ldbl), i);
-    }
-#endif /* PREFER_CHAR_CONV */
-
-    /*
-      going to do the fractional component
-      could be done by multiplying the fractional part into integrality
-      -- but that would not be worth the complexity, because it would require
-      you to know the answer (the number of significant digits) ahead of time
-    */
-    const char* const frac_str = fullstr + find_frac_beginning(fullstr);
-
-    for (size_t i = 0; i < nflot_digits; i++) {
-      bn_tlated[i + hdrlen + nint_digits] = (atom_t) ((unsigned) frac_str[i] - '0');
-    }
+  } else if ( isinf(ldbl) ) {
+    flags |= FL_INF;
+
+  } else if ( ldbl > 0 ) {
+    int32_t dec_exp = 0;
+    nsig = factory_shortest_digits(ldbl, from_dbl, sig, &dec_exp);
+
+    int_len  = (size_t) max(dec_exp, 0);
+    frac_len = (size_t) max((int32_t) nsig - dec_exp, 0);
+    lead     = (size_t) max(-dec_exp, 0);
+
+  } else if ( 0 != u64 ) {
+    nsig = int_len = u64_to_b10_into(sig, MAX_PRIMITIVE_LDBL_DIGITS, u64, false);
+  }
 
+  /* nothing to convert, only a header, which is made as a base 10 one would be */
+  if (0 == nsig && meta_is_base256(metadata) && ! meta_is_packed(metadata) && ! meta_is_bcd(metadata)) {
+    return make_array_header_into(out, cap, metadata, 0, 0, flags);
   }
-  free(fullstr); //  ~1
-  return bn_tlated; // 2
-} /* impl_to_digit_array_ldbl */
+
+  if ( meta_is_base256(metadata) || meta_is_packed(metadata) || meta_is_bcd(metadata) ) {
+    /* the digits are laid out in scratch space, then converted or packed from there */
+    const scratch_mark_t mark = scratch_mark();
+    atom_t* const digits = zsalloc(atom_t, int_len + frac_len + 1);
+    if (NULL == digits) { return 0; }
+
+    if (nsig) { memcpy(digits + lead, sig, nsig); }
+    const size_t need = factory_b10_into(out, cap, digits, int_len + frac_len, int_len, metadata, flags);
+
+    scratch_reset(mark);
+    return need;
+  }
+
+  atom_t header[HEADER_OFFSET_HUGE];
+  const size_t hdrlen = make_array_header_into(header, HEADER_OFFSET_HUGE, metadata, int_len, frac_len, flags);
+  if (0 == hdrlen) { return 0; }
+
+  const size_t need = hdrlen + int_len + frac_len;
+  if (NULL == out || cap < need) { return need; }
+
+  memcpy(out, header, hdrlen);
+  memset(out + hdrlen, 0, int_len + frac_len);
+  if (nsig) { memcpy(out + hdrlen + lead, sig, nsig); }
+
+  return need;
+}
 
 /*
-  uint64_t, atom_t, atom_t -> atom_t*
+  atom_t*, size_t, ldbl_t, uint64_t, atom_t, atom_t -> size_t
 
-  represent a uint64_t value as an array of digits
+  lay out the digit array to_digit_array would make in the caller's buffer
+    out, which has room for cap atoms, and give its length; nothing is
+    written when out is NULL or cap is too small, so the length can be asked
+    for first, but the digits are worked out each time
 
-  the values of metadata and flags are copied into the resulting array
+  base 10 arrays are made in out alone; base 256, packed and BCD ones are
+    laid out in base 10 in scratch space first, and a base 256 one is
+    converted in memory of its own
 
-  the caller should have checked whether ldbl is 0, therefore, this check is
-    not done
+  0 is returned, and errno set to ERANGE when a part is too long for the
+    header, or to ENOMEM
 */
-static atom_t* impl_to_digit_array_u64 (const uint64_t u64, const atom_t metadata, const atom_t flags) {
-
-  /*
-    TODO: add BIG support (?)
-  */
-  const bool using_base256 = meta_is_base256(metadata);
-                    //is_big = meta_is_big(metadata);
-
-  /* number of digits we'll need and the length of the header we'll need */
-  const atom_t ndigits = using_base256 ?
-                            count_b256_digits_u64(u64) :
-                            count_digits_u64(u64),
-                hdrlen = meta_header_offset(metadata);
-
-  /* now we can allocate the right size and make a header */
-  atom_t* bn_tlated = alloc(atom_t, ndigits + hdrlen), // 1
-       * const init = make_array_header(metadata, ndigits, 0, flags); // 2
-
-  /* put the new header in the initial section of new data */
-  memcpy(bn_tlated, init, sz(atom_t, hdrlen));
-  free(init); // ~2
-
-  /* going to use base 256 */
-  if (using_base256) {
-    /* convert to array representation */
-    uint16_t len = 0;
-    /* little endian*/
-    atom_t* as_digits = u64_to_b256(u64, &len, true);
-
-    /* just copy the data into the rest of the array */
-    memcpy(bn_tlated + hdrlen, as_digits, len);
-
-    free(as_digits);
-  } else {
+size_t to_digit_array_into (atom_t* const out, const size_t cap, const ldbl_t ldbl_in, const uint64_t u64, const atom_t value_flags, const atom_t metadata) {
+  return impl_to_digit_array_into(out, cap, ldbl_in, u64, value_flags, metadata, false);
+}
+
+/*
+  atom_t*, size_t, double, atom_t, atom_t -> size_t
+
+  to_digit_array_into for a double (see dbl_to_digit_array)
+*/
+size_t dbl_to_digit_array_into (atom_t* const out, const size_t cap, const double dbl, const atom_t value_flags, const atom_t metadata) {
+  return impl_to_digit_array_into(out, cap, dbl, 0, value_flags, metadata, true);
+}
+
+/*
+  numlit_t*, size_t, size_t*, size_t* -> atom_t*
+
+  the base 10 digits of a scanned literal in scratch space, laid out with its
+    exponent and without the integer part's leading zeroes, and their lengths
+
+  NULL is returned, and errno set to ERANGE, if either part has more than
+    max_part digits, or if it would be laid out to more than
+    NUMLIT_MAX_DIGITS digits
+*/
+static atom_t* factory_lit_digits (const numlit_t* const lit, const size_t max_part, size_t* const out_len, size_t* const out_int_len) {
+  size_t lead = 0, int_len = 0;
+  size_t len = numlit_layout(lit, &lead, NULL, &int_len);
+
+  /* the integer part's leading zeroes are counted before anything is made */
+  size_t zeroes = lead, i = 0, j = 0;
+  for (; i < lit->int_len && '0' == lit->int_digits[i]; i++) { zeroes++; }
+  if (i == lit->int_len) {
+    for (; j < lit->frac_len && '0' == lit->frac_digits[j]; j++) { zeroes++; }
+  }
 
-#ifdef PREFER_CHAR_CONV
+  /* an exponent can make any number of zeroes, so zero is not laid out */
+  const bool is_zero = i == lit->int_len && j == lit->frac_len;
+  zeroes = is_zero ? int_len : min(zeroes, int_len);
 
-    /* here begins the string implementation */
-    char* const str = alloc( char, ndigits + /* null term */ 2); // 4
-    snprintf(str, MAX_U64_DIGITS + 1, "%" PRIu64 "", u64);
+  /* and so is what would be made, zeroes from the exponent and all */
+  const size_t made = is_zero ? len - int_len : len;
+
+  if (int_len - zeroes > max_part || len - int_len > max_part || made > NUMLIT_MAX_DIGITS) {
+    errno = ERANGE;
+    return NULL;
+  }
 
-    for (atom_t i = 0; i < ndigits; i++) {
-      bn_tlated[i + hdrlen] = (atom_t) ((unsigned) str[i] - '0');
+  atom_t* digits = NULL;
+  if (is_zero) {
+    digits = zsalloc(atom_t, len - int_len + 1);
+  } else {
+    digits = salloc(atom_t, len + 1);
+    if (NULL != digits) {
+      numlit_to_b10(digits, lit, false);
+      memmove(digits, digits + zeroes, len - zeroes);
     }
-    free(str); // ~4
-    /* here ends the string implementation */
+  }
+  if (NULL == digits) { return NULL; }
+
+  set_out_param(out_len, len - zeroes);
+  set_out_param(out_int_len, int_len - zeroes);
+  return digits;
+}
+
+/* the longest part, in base 10 digits, a literal may have for metadata */
+static size_t factory_lit_max_part (const atom_t metadata) {
+  /* a base 256 part is checked once it is converted */
+  if ( meta_is_packed(metadata) ) { return meta_max_len(metadata) * PK_DIGITS; }
+  if ( meta_is_bcd(metadata) )    { return meta_max_len(metadata) * 2U; }
+  return meta_is_base256(metadata) ? SIZE_MAX : meta_max_len(metadata);
+}
 
-#else /* ! PREFER_CHAR_CONV (default) */
+/*
+  char*, size_t, atom_t -> atom_t*
 
-    for (atom_t i = 0; i < ndigits; i++) {
-      //printf("%d %" PRIu64 "\n", i + HEADER_OFFSET, u64);
-      bn_tlated[i + hdrlen] = get_left_nth_digit(u64, i);
+  make a new digit array with the given metadata from n characters of a
+    numeric literal (see scan_numlit), such as -123.45 or 1.5e-3; the
+    characters need not be terminated, and nothing past them is read
+
+  a minus sign sets FL_SIGN, and the digits are laid out as by to_digit_array:
+    base 10 integer parts have no leading zeroes
+
+  NULL is returned and errno is set to
+    EINVAL if the characters are not one literal
+    ERANGE if either part is too long for the array's header (255 digits,
+      65535 with TYP_BIG, or UINT32_MAX with TYP_HUGE; or as many words of 19
+      digits with TYP_PACK, or bytes of 2 digits with TYP_BCD), or if it
+      would be laid out to more than NUMLIT_MAX_DIGITS digits
+*/
+atom_t* str_to_digit_array (const char* const str, const size_t n, const atom_t metadata) {
+  numlit_t lit;
+  if (! scan_numlit(&lit, str, n)) { return NULL; }
+
+  if (meta_is_base256(metadata) && ! meta_is_packed(metadata) && ! meta_is_bcd(metadata)) {
+    size_t len = 0, int_len = 0;
+    atom_t* const digits = numlit_to_b256_z(&lit, &len, &int_len, false);
+    if (NULL == digits) { return NULL; }
+
+    atom_t* const header = make_array_header(metadata, int_len, len - int_len, lit.flags);
+    const atom_t  hdrlen = NULL == header ? 0 : bna_header_offset(header);
+    atom_t* const bna    = alloc(atom_t, hdrlen + len);
+
+    if (NULL == header || NULL == bna) {
+      bn_free(header), bn_free(bna), bn_free(digits);
+      return NULL;
     }
 
-#endif /* PREFER_CHAR_CONV */
+    memcpy(bna, header, sz(atom_t, hdrlen));
+    memcpy(bna + hdrlen, digits, sz(atom_t, len));
+    bn_free(header), bn_free(digits);
 
+    return bna;
   }
 
-  return bn_tlated; // 1
-} /* impl_to_digit_array_u64 */
+  /* base 10, packed and BCD arrays are measured before they are made */
+  const scratch_mark_t mark = scratch_mark();
+
+  size_t len = 0, int_len = 0;
+  const atom_t* const digits = factory_lit_digits(&lit, factory_lit_max_part(metadata), &len, &int_len);
+  const size_t need = NULL == digits ? 0 : factory_b10_into(NULL, 0, digits, len, int_len, metadata, lit.flags);
+
+  atom_t* bna = 0 == need ? NULL : alloc(atom_t, need);
+  if (NULL != bna) { factory_b10_into(bna, need, digits, len, int_len, metadata, lit.flags); }
+
+  scratch_reset(mark);
+  return bna;
+}
+
+/*
+  atom_t*, size_t, char*, size_t, atom_t -> size_t
+
+  lay out the digit array str_to_digit_array would make in the caller's
+    buffer out, which has room for cap atoms, and give its length; nothing
+    is written when out is NULL or cap is too small, so the length can be
+    asked for first, but the literal is read each time
+
+  the digits are laid out in scratch space, and a base 256 array is
+    converted in memory of its own
+
+  0 is returned, and errno set as by str_to_digit_array
+*/
+size_t str_to_digit_array_into (atom_t* const out, const size_t cap, const char* const str, const size_t n, const atom_t metadata) {
+  numlit_t lit;
+  if (! scan_numlit(&lit, str, n)) { return 0; }
+
+  const scratch_mark_t mark = scratch_mark();
+
+  size_t len = 0, int_len = 0;
+  const atom_t* const digits = factory_lit_digits(&lit, factory_lit_max_part(metadata), &len, &int_len);
+  const size_t need = NULL == digits ? 0 : factory_b10_into(out, cap, digits, len, int_len, metadata, lit.flags);
+
+  scratch_reset(mark);
+  return need;
+}
 
 #endif /* end of include guard: BNA_H */
 
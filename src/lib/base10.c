@@ -4,73 +4,100 @@
 #include "bn_common.h"
 
 /*
-  atom_t*, uint16_t, uint16_t -> char*
+  char*, size_t, atom_t*, size_t, size_t -> size_t
 
-  convert a base 10 array into a string base 10 floating point number
+  write a base 10 array as a string base 10 floating point number into the
+    caller's buffer out, which has room for cap chars
   very simple operation from { 1 2 3 4 5 } with int_len = 3 -> "123.45"
 
-  an empty string is returned when
+  the return value is the length of the string, not counting the terminator
+  like snprintf(3), nothing is written unless cap is greater than that length,
+    so calling with out = NULL and cap = 0 asks for the size to allocate
+
+  the string is empty (and 0 is returned) when
     len is 0
     int_len is greater than len
     digits is NULL
 */
-char* b10_to_ldbl_digits (const atom_t* const digits, const uint16_t len, const uint16_t int_len) {
-  if (NULL == digits || ! len || int_len > len) { return make_empty_string(); }
+size_t b10_to_ldbl_digits_into (char* const out, const size_t cap, const atom_t* const digits, const size_t len, const size_t int_len) {
+  const bool empty = NULL == digits || ! len || int_len > len,
+             dot   = ! empty && len != int_len;
 
-  char* const int_part = alloc(char, int_len + 1);
+  const size_t flot_len = empty ? 0 : len - int_len,
+               need     = empty ? 0 : int_len + dot + flot_len;
 
-  for (size_t i = 0; i < int_len; i++) {
-    int_part[i] = (char) (digits[i] + CHAR_DIGIT_DIFF);
+  if (NULL == out || cap <= need) { return need; }
+
+  if (! empty) {
+    digits_to_chars(out, digits, int_len, false);
+    if (dot) { out[int_len] = DECIMAL_SEPARATOR_STR[0]; }
+    digits_to_chars(out + int_len + dot, digits + int_len, flot_len, false);
   }
-  int_part[int_len] = '\0';
+  out[need] = '\0';
 
-  const size_t flot_len = (size_t) (len - int_len);
+  return need;
+}
 
-  char* const flot_part = alloc(char, flot_len + 1);
+/*
+  atom_t*, size_t, size_t -> char*
 
-  for (size_t i = 0; i < flot_len; i++) {
-    flot_part[i] = (char) ((char) digits[int_len + i] + CHAR_DIGIT_DIFF);
-  }
-  flot_part[flot_len] = '\0';
+  convert a base 10 array into a string base 10 floating point number
+  very simple operation from { 1 2 3 4 5 } with int_len = 3 -> "123.45"
 
-  const bool dot = len != int_len;
+  an empty string is returned when
+    len is 0
+    int_len is greater than len
+    digits is NULL
+*/
+char* b10_to_ldbl_digits (const atom_t* const digits, const size_t len, const size_t int_len) {
+  const size_t need = b10_to_ldbl_digits_into(NULL, 0, digits, len, int_len);
+
+  char* const str = alloc(char, need + 1);
+  b10_to_ldbl_digits_into(str, need + 1, digits, len, int_len);
+
+  return str;
+}
+
+/*
+  char*, size_t, atom_t*, size_t -> size_t
 
-  char* const final_concat = alloc(char, int_len + dot + flot_len);
+  write a base 10 array as a string base 10 number into the caller's buffer
+  the return value and cap behave as for b10_to_ldbl_digits_into
+*/
+size_t b10_to_u64_digits_into (char* const out, const size_t cap, const atom_t* const digits, const size_t len) {
+  const size_t need = NULL == digits ? 0 : len;
 
-  snprintf(final_concat, MAX_STR_LDBL_DIGITS, "%s%s%s", int_part, (dot ? DECIMAL_SEPARATOR_STR : ""), flot_part);
+  if (NULL == out || cap <= need) { return need; }
 
-  free(int_part), free(flot_part);
+  digits_to_chars(out, digits, need, false);
+  out[need] = '\0';
 
-  return final_concat;
+  return need;
 }
 
 /*
-  atom_t*, uint16_t -> char*
+  atom_t*, size_t -> char*
 
   base 10 array into a string base 10 number
-  very simple operation to subtract CHAR_DIGIT_DIFF
+  very simple operation to add CHAR_DIGIT_DIFF
 */
-char* b10_to_u64_digits (const atom_t* const digits, const uint16_t len) {
+char* b10_to_u64_digits (const atom_t* const digits, const size_t len) {
   char* const u64_str = alloc(char, len + 1);
-
-  for (uint16_t i = 0; i < len; i++) {
-    u64_str[i] = (char) (digits[i] + CHAR_DIGIT_DIFF);
-  }
-  u64_str[len] = '\0';
+  b10_to_u64_digits_into(u64_str, len + 1, digits, len);
   return u64_str;
 }
 
 /*
-  atom_t*, uint16_t -> uint64_t
+  atom_t*, size_t -> uint64_t
 
   like b10_to_u64_digits but the conversion is to a number value
   the conversion may overflow, to avoid this check errno
     and use b10_to_u64_digits
 */
-uint64_t b10_to_u64 (const atom_t* const digits, const uint16_t len) {
+uint64_t b10_to_u64 (const atom_t* const digits, const size_t len) {
   char* const u64_str = b10_to_u64_digits(digits, len);
   const uint64_t final = strtoull(u64_str, NULL, DEC_BASE);
-  free(u64_str);
+  bn_free(u64_str);
   return final;
 }
 
@@ -80,87 +107,199 @@ uint16_t b10_to_u16(const atom_t* const n, const uint16_t len) {
   return 0;
 }
 
-// string 123.45 to { 1 2 3 4 5 ... }
 /*
-  char*, bool -> atom_t*, uint16_t, uint16_t
+  char*, size_t, size_t, bool -> atom_t*, size_t, size_t
 
-  convert a string of base 10 long double (floating) digits to
+  the body of ldbl_digits_to_b10_z and ldbl_digits_to_b10_n (below), which
+    fails with ERANGE, before anything is made, when there would be more than
+    max_len digits
 */
-atom_t* ldbl_digits_to_b10 (const char* const ldbl_digits, uint16_t* const len, uint16_t* const int_len, const bool little_endian) {
+static atom_t* impl_ldbl_digits_to_b10 (const char* const ldbl_digits, const size_t n, const size_t max_len, size_t* const len, size_t* const int_len, const bool little_endian) {
 
-  if ( (0 == strnlen_c(ldbl_digits, MAX_U64_DIGITS + 2)) || NULL == ldbl_digits || NULL == len || NULL == int_len) {
+  if ( NULL == ldbl_digits || ! n || NULL == len || NULL == int_len) {
     set_out_param(len, 1);
     set_out_param(int_len, 1);
     return zalloc(atom_t, 1);
   }
 
-  /* length of integer part before the decimal point */
-  const uint16_t pre_dec = (uint16_t) strcspn(ldbl_digits, DECIMAL_SEPARATOR_STR),
-              digits_len = (uint16_t) strnlen_c(ldbl_digits, MAX_STR_LDBL_DIGITS);
+  *len = 0, *int_len = 0;
 
-  char *const int_part  = strndup_c(ldbl_digits, pre_dec), // 1
-       *const flot_part = strndup_c(ldbl_digits + pre_dec + 1, MAX_STR_LDBL_DIGITS);
+  /* one pass both validates and finds the parts, so the copy below can't fail */
+  numlit_t lit;
+  if (! scan_numlit(&lit, ldbl_digits, n)) { return NULL; }
 
-  uint16_t i = 0;
-  for (; int_part[i]; i++) {
-    int_part[i]  = (char) (int_part[i] - CHAR_DIGIT_DIFF);
+  if (lit.has_sign) {
+    errno = EINVAL;
+    return NULL;
   }
-  const uint16_t int_part_len = i;
 
-  for (i = 0; flot_part[i]; i++) {
-    flot_part[i]  = (char) (flot_part[i] - CHAR_DIGIT_DIFF);
+  size_t total_int_len = 0;
+  const size_t total = numlit_layout(&lit, NULL, NULL, &total_int_len);
+
+  if (total > max_len) {
+    errno = ERANGE;
+    return NULL;
   }
-  const uint16_t flot_part_len = i;
 
-  set_out_param(len, (uint16_t) (int_part_len + flot_part_len));
-  set_out_param(int_len, int_part_len);
+  /* never a zero-size allocation */
+  atom_t* const res = alloc(atom_t, total + 1);
+  if (NULL == res) { return NULL; }
 
-  atom_t* const res = alloc(atom_t, digits_len);
+  /* each half lands in its final place, already in the requested order */
+  numlit_to_b10(res, &lit, little_endian);
 
-  memcpy(res, int_part, int_part_len);
-  memcpy(res + int_part_len + 1, flot_part, flot_part_len);
+  *len     = total;
+  *int_len = total_int_len;
 
-  free(int_part), free(flot_part);
+  return res;
+}
 
-  if (little_endian) {
-    atom_t* const res_rev = array_reverse(res, (uint16_t) (int_part_len + flot_part_len));
-    free(res);
-    return res_rev;
-  }
+// string 123.45 to { 1 2 3 4 5 ... }
+/*
+  char*, size_t, bool -> atom_t*, size_t, size_t
+
+  convert n characters of base 10 long double (floating) digits to an array of
+    base 10 digits, integer part first; the characters need not be terminated,
+    and nothing past them is read
+
+  the value at len     is changed to the number of digits in the result
+  the value at int_len is changed to the number of digits before the separator
+
+  if little_endian is true, then the result is reversed, and the fractional
+    part occurs first; the digits are written in that order directly
+
+  a zero array of length 1 is returned when
+    n is 0 or ldbl_digits is NULL
+    len or int_len is NULL
+
+  an exponent (as in 1.5e3, see scan_numlit) moves the separator, and zeroes
+    are added where it is moved past the digits
 
+  NULL is returned and errno is set to
+    EINVAL if the characters are not digits with at most one separator and
+      an exponent
+    ERANGE if there would be more than NUMLIT_MAX_DIGITS digits
+*/
+atom_t* ldbl_digits_to_b10_z (const char* const ldbl_digits, const size_t n, size_t* const len, size_t* const int_len, const bool little_endian) {
+  return impl_ldbl_digits_to_b10(ldbl_digits, n, NUMLIT_MAX_DIGITS, len, int_len, little_endian);
+}
+
+/*
+  char*, size_t, bool -> atom_t*, uint16_t, uint16_t
+
+  ldbl_digits_to_b10_z for lengths that fit a big array's header (see
+    TYP_BIG), with NULL returned and errno set to ERANGE when there are more
+    than UINT16_MAX digits, counting the zeroes
+*/
+atom_t* ldbl_digits_to_b10_n (const char* const ldbl_digits, const size_t n, uint16_t* const len, uint16_t* const int_len, const bool little_endian) {
+  size_t total = 1, total_int = 1;
+  atom_t* const res = impl_ldbl_digits_to_b10(ldbl_digits, n, UINT16_MAX, NULL == len ? NULL : &total, NULL == int_len ? NULL : &total_int, little_endian);
+
+  set_out_param(len, (uint16_t) total);
+  set_out_param(int_len, (uint16_t) total_int);
   return res;
 }
 
+/*
+  char*, bool -> atom_t*, uint16_t, uint16_t
+
+  ldbl_digits_to_b10_n for a terminated string, of which at most
+    MAX_STR_LDBL_DIGITS characters are read
+*/
+atom_t* ldbl_digits_to_b10 (const char* const ldbl_digits, uint16_t* const len, uint16_t* const int_len, const bool little_endian) {
+  return ldbl_digits_to_b10_n(ldbl_digits, strnlen_c(ldbl_digits, MAX_STR_LDBL_DIGITS), len, int_len, little_endian);
+}
+
+/*
+  atom_t*, size_t, uint64_t, bool -> size_t
+
+  write the base 10 digits of value, most significant first unless
+    little_endian is true, into the caller's array out, which has room for cap
+    digits; 0 is one zero digit
+
+  the return value is the number of digits, and nothing is written unless cap
+    is at least that, so calling with out = NULL and cap = 0 asks for the size
+*/
+size_t u64_to_b10_into (atom_t* const out, const size_t cap, const uint64_t value, const bool little_endian) {
+  size_t ndigits = 1;
+  for (uint64_t rest = value / 10; rest; rest /= 10) { ndigits++; }
+
+  if (NULL == out || cap < ndigits) { return ndigits; }
+
+  uint64_t rest = value;
+  for (size_t i = 0; i < ndigits; i++, rest /= 10) {
+    out[little_endian ? i : ndigits - 1 - i] = (atom_t) (rest % 10);
+  }
+  return ndigits;
+}
+
 atom_t* u64_to_b10 (const uint64_t value, /* out */ uint16_t* const len, const bool little_endian) {
-  char* const str_digits = alloc(char, MAX_U64_DIGITS + 1);
-  snprintf(str_digits, MAX_U64_DIGITS, "%" PRIu64, value);
+  const size_t ndigits = u64_to_b10_into(NULL, 0, value, little_endian);
+
+  atom_t* const bytes = alloc(atom_t, ndigits);
+  if (NULL != bytes) { u64_to_b10_into(bytes, ndigits, value, little_endian); }
 
-  atom_t* const bytes = u64_digits_to_b10(str_digits, len, little_endian);
-  free(str_digits);
+  set_out_param(len, (uint16_t) ndigits);
   return bytes;
 }
 
 
 // string like 23948734 to atom_t array { 2 3 9 ... }
-atom_t* u64_digits_to_b10 (const char* const digits, /* out */ uint16_t* const len, const bool little_endian) {
-  const size_t digits_len = strnlen_c(digits, MAX_STR_LDBL_DIGITS);
-  if (NULL == digits || 0 == digits_len || NULL == len) {
+/*
+  char*, size_t, bool -> atom_t*, uint16_t
+
+  convert n characters of base 10 integer digits to an array of base 10
+    digits; the characters need not be terminated, and nothing past them is
+    read
+
+  if little_endian is true, then the result is reversed; the digits are written
+    in that order directly
+
+  NULL is returned when
+    n is 0 or digits is NULL
+    len is NULL
+    the characters are anything other than digits, in which case errno is set
+      to EINVAL
+    there are more than UINT16_MAX of them, in which case errno is set to
+      ERANGE
+    memory is exhausted, in which case errno is set to ENOMEM
+*/
+atom_t* u64_digits_to_b10_n (const char* const digits, const size_t n, /* out */ uint16_t* const len, const bool little_endian) {
+  if (NULL == digits || 0 == n || NULL == len) {
     return NULL;
   }
 
-  set_out_param(len, (uint16_t) digits_len);
-  atom_t* const as_b10 = alloc(atom_t, digits_len);
-  for (uint16_t i = 0; i < digits_len; i++) {
-    as_b10[i] = (atom_t) ((char) digits[i] - CHAR_DIGIT_DIFF);
+  if (n > UINT16_MAX) {
+    *len  = 0;
+    errno = ERANGE;
+    return NULL;
   }
 
-  if (little_endian) {
-    atom_t* const rev_digits = array_reverse(as_b10, (uint16_t) digits_len);
-    free(as_b10);
-    return rev_digits;
+  atom_t* const as_b10 = alloc(atom_t, n);
+  if (NULL == as_b10) {
+    *len = 0;
+    return NULL;
   }
 
+  if (! chars_to_digits(as_b10, digits, n, little_endian)) {
+    bn_free(as_b10);
+    *len  = 0;
+    errno = EINVAL;
+    return NULL;
+  }
+
+  *len = (uint16_t) n;
   return as_b10;
 }
 
+/*
+  char*, bool -> atom_t*, uint16_t
+
+  u64_digits_to_b10_n for a terminated string, of which at most
+    MAX_STR_LDBL_DIGITS characters are read
+*/
+atom_t* u64_digits_to_b10 (const char* const digits, /* out */ uint16_t* const len, const bool little_endian) {
+  return u64_digits_to_b10_n(digits, strnlen_c(digits, MAX_STR_LDBL_DIGITS), len, little_endian);
+}
+
 #endif
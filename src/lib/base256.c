@@ -4,9 +4,334 @@
 #include "bn_common.h"
 
 /*
-  char*, bool -> atom_t*, uint16_t*
+  limb_t*, atom_t*, size_t -> size_t
+
+  convert big endian base 10 digits to limbs (see limb_math.c), and return the
+    number of limbs; long numbers are split in halves (see radix_conv.c)
+    rather than taken nine digits at a time
+
+  out needs room for len / 9 + 1 limbs
+
+  (size_t) -1 is returned if memory is exhausted
+*/
+size_t b10_to_limbs (limb_t* const out, const atom_t* const digits, const size_t len) {
+  return radix_digits_to_limbs(out, digits, len, DEC_BASE);
+}
+
+/*
+  limb_t*, atom_t*, size_t -> size_t
+
+  convert big endian base 256 digits to limbs, four at a time, and return the
+    number of limbs; the inverse of limbs_to_b256
+
+  out needs room for len / 4 + 1 limbs
+*/
+size_t b256_to_limbs (limb_t* const out, const atom_t* const digits, const size_t len) {
+  const size_t n = len / sizeof (limb_t) + 1;
+  memset(out, 0, sz(limb_t, n));
+
+  for (size_t i = 0; i < len; i++) {
+    /* byte i, counting from the least significant */
+    out[i / sizeof (limb_t)] |= (limb_t) digits[len - 1 - i] << (CHAR_BIT * (i % sizeof (limb_t)));
+  }
+
+  return limb_normalize(out, n);
+}
+
+/*
+  atom_t*, limb_t*, size_t -> size_t
+
+  write a number in limbs as big endian base 256 digits, with no leading
+    zeroes, and return their count; 0 is written as no digits at all
+
+  out needs room for 4 * len digits
+*/
+size_t limbs_to_b256 (atom_t* const out, const limb_t* const a, const size_t len) {
+  const size_t n = limb_normalize(a, len);
+  if (! n) { return 0; }
+
+  /* the most significant limb may not need all of its bytes */
+  size_t top_bytes = 0;
+  for (limb_t top = a[n - 1]; top; top >>= CHAR_BIT) { top_bytes++; }
+
+  const size_t ndigits = (n - 1) * sizeof (limb_t) + top_bytes;
+  for (size_t i = 0; i < ndigits; i++) {
+    /* byte i, counting from the least significant */
+    out[ndigits - 1 - i] = (atom_t) (a[i / sizeof (limb_t)] >> (CHAR_BIT * (i % sizeof (limb_t))));
+  }
+
+  return ndigits;
+}
+
+/* base 256 digits for every base 10 digit, log(10) / log(256) = 0.41524101186..., rounded up */
+#define B256_PER_B10_DIGIT 0.4152410119
+
+/*
+  size_t -> size_t
+
+  the base 256 digits that can hold a value with len base 10 digits
+*/
+size_t count_b256_digits_for_b10 (const size_t len) {
+  return (size_t) ceil((double) len * B256_PER_B10_DIGIT);
+}
+
+/* fractions with fewer digits than this, or wanted to fewer, are converted a
+  digit at a time; longer ones all at once, with a division */
+#ifndef B256_FRAC_CUTOFF
+  #define B256_FRAC_CUTOFF 64
+#endif
+
+/*
+  atom_t*, size_t, limb_t*, size_t -> void
+
+  write a number in limbs as exactly out_len big endian base 256 digits, with
+    leading zeroes; the number must fit
+*/
+static void b256_put_limbs (atom_t* const out, const size_t out_len, const limb_t* const a, const size_t len) {
+  for (size_t i = 0; i < out_len; i++) {
+    /* byte i, counting from the least significant */
+    const size_t word = i / sizeof (limb_t);
+    out[out_len - 1 - i] = (atom_t) (word < len ? a[word] >> (CHAR_BIT * (i % sizeof (limb_t))) : 0);
+  }
+}
+
+/*
+  atom_t*, size_t, atom_t*, size_t -> void
+
+  b10_frac_to_b256 a digit at a time: each is the carry out of multiplying
+    the fraction by 256, which is kept in base 10^9 chunks
+*/
+static void b256_frac_basecase (atom_t* const out, const size_t out_len, const atom_t* const frac, const size_t frac_len, limb_t* const chunks) {
+  static const limb_t pow10[10] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+
+  /* most significant chunk first, with the last padded with zeroes on the right */
+  const size_t nchunks = (frac_len + 8) / 9;
+  memset(chunks, 0, sz(limb_t, nchunks));
+
+  for (size_t i = 0; i < frac_len; i++) {
+    chunks[i / 9] += (limb_t) frac[i] * pow10[8 - i % 9];
+  }
+
+  /* chunks that are already zero never become nonzero again */
+  size_t live = nchunks;
+  for (size_t o = 0; o < out_len; o++) {
+    while (live && 0 == chunks[live - 1]) { live--; }
+
+    dlimb_t carry = 0;
+    for (size_t i = live; i--; ) {
+      carry    += (dlimb_t) chunks[i] * ZENZ_BASE;
+      chunks[i] = (limb_t) (carry % pow10[9]);
+      carry    /= pow10[9];
+    }
+    out[o] = (atom_t) carry;
+  }
+}
+
+/*
+  atom_t*, size_t, atom_t*, size_t -> bool
+
+  write the first out_len base 256 digits of the fraction 0.frac[0] frac[1] ...
+    to out, truncating the rest; out_len is the precision, and with
+    count_b256_digits_for_b10(frac_len) digits, the base 256 fraction is
+    within one unit of its last digit
+
+  the digits are those of F 256^out_len / 10^frac_len, where F is the fraction
+    as an integer; as 10^k = 5^k 2^k, that is a shift and one division by a
+    power of 5, which is subquadratic for long fractions
+
+  false is returned, with out unchanged, when memory is exhausted
+*/
+bool b10_frac_to_b256 (atom_t* const out, const size_t out_len, const atom_t* const frac, const size_t frac_len) {
+  if (min(frac_len, out_len) <= B256_FRAC_CUTOFF) {
+    limb_t* const chunks = alloc(limb_t, (frac_len + 8) / 9 + 1);
+    if (NULL == chunks) { return false; }
+
+    b256_frac_basecase(out, out_len, frac, frac_len, chunks);
+    bn_free(chunks);
+    return true;
+  }
+
+  const size_t bits = CHAR_BIT * out_len;
+
+  /* F, shifted by 8 out_len - frac_len bits in whichever direction */
+  const size_t up = bits > frac_len ? bits - frac_len : 0;
+  const scratch_mark_t mark = scratch_mark();
+  limb_t* const f = salloc(limb_t, frac_len / 9 + 2 + up / LIMB_BITS);
+  limb_t* const p = salloc(limb_t, frac_len / 13 + 3);
+  limb_t* const q = salloc(limb_t, frac_len / 9 + 5 + up / LIMB_BITS + frac_len / 13);
+
+  bool ok = NULL != f && NULL != p && NULL != q;
 
-  transform a uint64_t (string) to its base 256 representation in bytes
+  if (ok) {
+    size_t f_len = b10_to_limbs(f, frac, frac_len);
+    ok = (size_t) -1 != f_len;
+    if (ok) { f_len = up ? limb_shl(f, f, f_len, up) : limb_shr(f, f, f_len, frac_len - bits); }
+
+    const size_t p_len = ok ? limb_pow5(p, frac_len) : 0,
+                 q_len = p_len ? limb_div(q, f, f_len, p, p_len) : (size_t) -1;
+
+    ok = (size_t) -1 != q_len;
+    if (ok) { b256_put_limbs(out, out_len, q, q_len); }
+  }
+
+  scratch_reset(mark);
+  return ok;
+}
+
+/*
+  atom_t*, size_t, atom_t*, size_t -> bool
+
+  write the first out_len base 10 digits of the base 256 fraction
+    0.frac[0] frac[1] ... to out, truncating the rest
+
+  every base 256 fraction has an exact base 10 one, as 256^-1 = 5^8 / 10^8, so
+    with 8 frac_len digits nothing is truncated
+
+  the digits are those of G 10^out_len / 256^frac_len, where G is the fraction
+    as an integer: one multiplication by a power of 5, and a shift
+
+  false is returned, with out unchanged, when memory is exhausted
+*/
+bool b256_frac_to_b10 (atom_t* const out, const size_t out_len, const atom_t* const frac, const size_t frac_len) {
+  if (min(frac_len, out_len) <= B256_FRAC_CUTOFF) {
+    const scratch_mark_t mark = scratch_mark();
+    atom_t* const rest = salloc(atom_t, frac_len + 1);
+    if (NULL == rest) { return false; }
+    memcpy(rest, frac, sz(atom_t, frac_len));
+
+    /* each digit is the carry out of multiplying the fraction by 10 */
+    size_t live = frac_len;
+    for (size_t o = 0; o < out_len; o++) {
+      while (live && 0 == rest[live - 1]) { live--; }
+
+      unsigned carry = 0;
+      for (size_t i = live; i--; ) {
+        carry  += (unsigned) rest[i] * DEC_BASE;
+        rest[i] = (atom_t) carry;
+        carry >>= CHAR_BIT;
+      }
+      out[o] = (atom_t) carry;
+    }
+
+    scratch_reset(mark);
+    return true;
+  }
+
+  const size_t bits = CHAR_BIT * frac_len;
+
+  /* G 5^out_len, then shifted by out_len - 8 frac_len bits */
+  const size_t g_room = frac_len / sizeof (limb_t) + 1,
+               p_room = out_len / 13 + 3,
+               up     = out_len > bits ? out_len - bits : 0;
+
+  const scratch_mark_t mark = scratch_mark();
+  limb_t* const g    = salloc(limb_t, g_room);
+  limb_t* const p    = salloc(limb_t, p_room);
+  limb_t* const prod = salloc(limb_t, g_room + p_room + 1 + up / LIMB_BITS);
+
+  bool ok = NULL != g && NULL != p && NULL != prod;
+  atom_t* values = NULL;
+
+  if (ok) {
+    const size_t g_len = b256_to_limbs(g, frac, frac_len),
+                 p_len = limb_pow5(p, out_len);
+
+    size_t n = p_len && g_len ? limb_mul(prod, g, g_len, p, p_len) : 0;
+    n = up ? limb_shl(prod, prod, n, up) : limb_shr(prod, prod, n, bits - out_len);
+
+    /* below 10^out_len, so it has at most out_len digits */
+    values = salloc(atom_t, limb_bit_length(prod, n) + 1);
+    ok = 0 != p_len && NULL != values;
+
+    const size_t ndigits = ok && n ? radix_limbs_to_digits(values, prod, n, DEC_BASE) : 0;
+    ok = ok && (ndigits || ! n);
+
+    if (ok) {
+      memset(out, 0, out_len - ndigits);
+      memcpy(out + out_len - ndigits, values, sz(atom_t, ndigits));
+    }
+  }
+
+  scratch_reset(mark);
+  return ok;
+}
+
+/*
+  atom_t*, size_t, size_t*, bool -> atom_t*
+
+  the base 256 digits of an integer given as big endian base 10 digits
+
+  the value at len is changed to the number of base 256 digits, which is at
+    least 1, and the result is reversed if little_endian is true
+
+  NULL is returned, and len set to 0, when memory is exhausted
+*/
+static atom_t* impl_b10_int_to_b256 (const atom_t* const digits, const size_t digits_len, size_t* const len, const bool little_endian) {
+  set_out_param(len, 0);
+
+  limb_t* const limbs = alloc(limb_t, digits_len / 9 + 2);
+  if (NULL == limbs) { return NULL; }
+  const size_t nlimbs = b10_to_limbs(limbs, digits, digits_len);
+
+  /* zero has no digits here, so it gets the one zeroed digit */
+  atom_t* const res = (size_t) -1 == nlimbs ? NULL : zalloc(atom_t, nlimbs * sizeof (limb_t) + 1);
+  if (NULL == res) {
+    bn_free(limbs);
+    return NULL;
+  }
+
+  size_t ndigits = limbs_to_b256(res, limbs, nlimbs);
+  if (! ndigits) { ndigits = 1; }
+  bn_free(limbs);
+
+  if (little_endian) { array_reverse_in_place(res, ndigits); }
+
+  set_out_param(len, ndigits);
+  return res;
+}
+
+/*
+  char*, size_t, uint16_t*, bool -> atom_t*
+
+  the same as u64_digits_to_b256_n (below), but NULL is returned for no
+    characters
+*/
+static atom_t* str_digits_to_b256 (const char* const digits, const size_t n, uint16_t* const len, const bool little_endian) {
+  /* never a zero-size allocation */
+  atom_t* const as_b10 = alloc(atom_t, n + 1);
+  if (NULL == as_b10) {
+    set_out_param(len, 0);
+    return NULL;
+  }
+
+  if (NULL == digits || ! n || ! chars_to_digits(as_b10, digits, n, false)) {
+    bn_free(as_b10);
+    set_out_param(len, 0);
+    if (n) { errno = EINVAL; }
+    return NULL;
+  }
+
+  size_t ndigits = 0;
+  atom_t* const res = impl_b10_int_to_b256(as_b10, n, &ndigits, little_endian);
+  bn_free(as_b10);
+
+  if (ndigits > UINT16_MAX) {
+    bn_free(res);
+    set_out_param(len, 0);
+    errno = ERANGE;
+    return NULL;
+  }
+
+  set_out_param(len, (uint16_t) ndigits);
+  return res;
+}
+
+/*
+  char*, size_t, bool -> atom_t*, uint16_t*
+
+  transform n characters of uint64_t digits to their base 256 representation
+    in bytes; the value may be larger than a uint64_t can hold, and the
+    characters need not be terminated (nothing past them is read)
 
   the value at len is changed to the new length of the representation
 
@@ -14,70 +339,154 @@
 
   a valid pointer to a zero array is returned if
     len is NULL
-    the input string is empty or NULL
+    n is 0 or u64_str is NULL
 
   in the last case, len is set to 1 (when a valid pointer)
+
+  NULL is returned and errno is set to
+    EINVAL when the characters are anything other than digits
+    ERANGE when the result has more than UINT16_MAX digits
+    ENOMEM when memory is exhausted
 */
-atom_t* u64_digits_to_b256 (const char* const u64_str, uint16_t* const len, const bool little_endian) {
+atom_t* u64_digits_to_b256_n (const char* const u64_str, const size_t n, uint16_t* const len, const bool little_endian) {
 
-  if (string_is_sempty(u64_str, MAX_STR_LDBL_DIGITS) || NULL == len) {
+  if (NULL == u64_str || ! n || NULL == len) {
     set_out_param(len, 1);
     return zalloc(atom_t, 1);
   }
 
-  atom_t* const result = zalloc(atom_t, count_b256_digits_b10_digits(u64_str));
+  return str_digits_to_b256(u64_str, n, len, little_endian);
+}
 
-  atom_t* const as_b10 = u64_digits_to_b10(u64_str, len, false);
-  (void) little_endian;
-  (void) as_b10;
-  puts("UNIMPLEMENTED");
+/*
+  char*, bool -> atom_t*, uint16_t*
 
-  /* big endian! */
-  /*
-    for (uint64_t tempr = value; tempr; i++) {
-      //result = realloc(result, i + 1);
+  u64_digits_to_b256_n for a terminated string, of which at most
+    MAX_STR_LDBL_DIGITS characters are read
+*/
+atom_t* u64_digits_to_b256 (const char* const u64_str, uint16_t* const len, const bool little_endian) {
+  return u64_digits_to_b256_n(u64_str, strnlen_c(u64_str, MAX_STR_LDBL_DIGITS), len, little_endian);
+}
 
-      result[i] = (atom_t)   (tempr % B256_HIGH);
-      tempr     = (uint64_t) floorl(tempr / B256_HIGH);
-      //printf("%d, %" PRIu64 "\n", result[i], tempr);
-      if (! tempr) { break; }
-    }
-  */
+/*
+  atom_t*, size_t, size_t -> atom_t*, size_t*, size_t*
 
-  return result;
+  the base 256 digits of len big endian base 10 digits, of which the first
+    int_len are the integer part; the integer part is first, and is never
+    empty, and the fractional part has count_b256_digits_for_b10 digits for
+    the base 10 ones, truncated there
+
+  the values at len and int_len are changed to the new lengths
+
+  NULL is returned when memory is exhausted
+*/
+atom_t* b10_to_b256_z (const atom_t* const digits, const size_t b10_len, const size_t b10_int_len, size_t* const len, size_t* const int_len) {
+  const size_t b10_flot_len = b10_len - b10_int_len;
+
+  set_out_param(len, 0);
+  set_out_param(int_len, 0);
+
+  /* the integer part, which is never empty */
+  size_t lhs_len = 0;
+  atom_t* const lhs_b256 = impl_b10_int_to_b256(digits, b10_int_len, &lhs_len, false);
+  if (NULL == lhs_b256) { return NULL; }
+
+  const size_t rhs_len = count_b256_digits_for_b10(b10_flot_len);
+
+  atom_t* const res = alloc(atom_t, lhs_len + rhs_len);
+  if (NULL == res || ! b10_frac_to_b256(res + lhs_len, rhs_len, digits + b10_int_len, b10_flot_len)) {
+    bn_free(lhs_b256), bn_free(res);
+    return NULL;
+  }
+
+  memcpy(res, lhs_b256, lhs_len);
+  bn_free(lhs_b256);
+
+  set_out_param(len, lhs_len + rhs_len);
+  set_out_param(int_len, lhs_len);
+  return res;
 }
 
 /*
-  char* -> atom_t*
+  numlit_t*, size_t*, size_t*, bool -> atom_t*
+
+  the base 256 digits of a scanned literal (see scan_numlit), as from
+    ldbl_digits_to_b256_z; the sign is not looked at
+
+  NULL is returned when memory is exhausted, or with errno set to ERANGE
+    when it would be laid out to more than NUMLIT_MAX_DIGITS base 10 digits
 */
-static atom_t* str_digits_to_b256 (const char* const digits, uint16_t* const len, const bool little_endian) {
-  puts("UNIMPLEMENTED");
-  (void) digits;
-  (void) len;
-  (void) little_endian;
-  return NULL;
+atom_t* numlit_to_b256_z (const numlit_t* const lit, size_t* const len, size_t* const int_len, const bool little_endian) {
+  size_t b10_int_len = 0, total = 0;
+  const size_t b10_len = numlit_layout(lit, NULL, NULL, &b10_int_len);
+
+  set_out_param(len, 0);
+  set_out_param(int_len, 0);
+
+  if (b10_len > NUMLIT_MAX_DIGITS) {
+    errno = ERANGE;
+    return NULL;
+  }
+
+  /* never a zero-size allocation */
+  atom_t* const as_b10 = alloc(atom_t, b10_len + 1);
+  if (NULL == as_b10) { return NULL; }
+  numlit_to_b10(as_b10, lit, false);
+
+  atom_t* const res = b10_to_b256_z(as_b10, b10_len, b10_int_len, &total, int_len);
+  bn_free(as_b10);
+
+  if (NULL == res) { return NULL; }
+  set_out_param(len, total);
+
+  /* the digits are turned around where they are, not copied */
+  if (little_endian) { array_reverse_in_place(res, total); }
+  return res;
 }
+
 /*
-{
-  const char* const rev_digits = str_reverse(digits);
+  numlit_t*, uint16_t*, uint16_t*, bool -> atom_t*
+
+  numlit_to_b256_z for lengths that fit a big array's header (see TYP_BIG)
+
+  NULL is returned and errno is set to ERANGE when the result is too long
+*/
+atom_t* numlit_to_b256 (const numlit_t* const lit, uint16_t* const len, uint16_t* const int_len, const bool little_endian) {
+  size_t b10_int_len = 0, total = 0, total_int = 0;
 
+  set_out_param(len, 0);
+  set_out_param(int_len, 0);
 
-  size_t b256_place = 1, b10_place = 1; // 1-index
+  /* every 3 base 10 digits are more than 1 base 256 digit, so this is too long
+    whatever they are; the exact check is below */
+  if (numlit_layout(lit, NULL, NULL, &b10_int_len) / 3 > UINT16_MAX) {
+    errno = ERANGE;
+    return NULL;
+  }
 
-  atom_t* const b256_digits = alloc(atom_t, 10);
+  atom_t* const res = numlit_to_b256_z(lit, &total, &total_int, little_endian);
 
-  for (size_t i = 0; rev_digits[i]; i++) {
+  if (NULL != res && total > UINT16_MAX) {
+    bn_free(res);
+    errno = ERANGE;
+    return NULL;
   }
 
-  return b256_digits;
+  set_out_param(len, (uint16_t) total);
+  set_out_param(int_len, (uint16_t) total_int);
+  return res;
 }
-*/
+
 /*
-  char*, uint16_t*, uint16_t* -> atom_t*
+  char*, size_t, size_t*, size_t*, bool -> atom_t*
 
-  transform a long double to its base 256 representation
+  transform n characters of long double digits to their base 256
+    representation; the characters need not be terminated, and nothing past
+    them is read
 
-  the integer part is first and the fractional second
+  the integer part is first and the fractional second; the fractional part
+    has count_b256_digits_for_b10 digits for its base 10 digits, and is
+    truncated there
 
   the value at len     is changed to the new entire length of the representation
   the value at int_len is changed to the new length of the integer part, from
@@ -86,49 +495,159 @@ static atom_t* str_digits_to_b256 (const char* const digits, uint16_t* const len
   if little_endian is true, then the result is reversed, and the fractional part
     occurs first
 
-  if value was 0 or len was NULL, then a valid pointer to an array of value 0
+  if n was 0 or len was NULL, then a valid pointer to an array of value 0
     is returned
 
   if len was NULL, it is not changed into a valid pointer
 
-  the return value is always a valid pointer
+  an exponent (as in 1.5e3, see scan_numlit) moves the separator first
+
+  NULL is returned and errno is set to
+    EINVAL if the characters are not digits with at most one separator and
+      an exponent
+    ERANGE if they would be laid out to more than NUMLIT_MAX_DIGITS base 10
+      digits
 */
-atom_t* ldbl_digits_to_b256 (const char* const ldbl_digits, uint16_t* const len, uint16_t* const int_len, const bool little_endian) {
+atom_t* ldbl_digits_to_b256_z (const char* const ldbl_digits, const size_t n, size_t* const len, size_t* const int_len, const bool little_endian) {
 
-  if ( string_is_sempty(ldbl_digits, MAX_STR_LDBL_DIGITS) || NULL == len || NULL == int_len) {
-    set_out_param(len, 1);
+  if ( NULL == ldbl_digits || ! n || NULL == len || NULL == int_len) {
     set_out_param(len, 1);
+    set_out_param(int_len, 1);
     return zalloc(atom_t, 1);
   }
 
-  /* length of integer part before the decimal point */
-  const uint16_t pre_dec = (uint16_t) strcspn(ldbl_digits, DECIMAL_SEPARATOR_STR);
+  *len = 0, *int_len = 0;
 
-  /* get the two parts of the number */
-  char* const int_part  = strndup_c(ldbl_digits, pre_dec), // 1
-      /* flip the significant digits */
-      * const flot_part = str_reverse(ldbl_digits + pre_dec + /* skip separator */ 1); // 2
+  numlit_t lit;
+  if (! scan_numlit(&lit, ldbl_digits, n)) { return NULL; }
 
-  uint16_t lhs_len = 0, rhs_len = 0;
-  atom_t* const lhs_b256 = str_digits_to_b256(int_part, &lhs_len, true),
-        /* note argument #3: flip the fractional digits again */
-        * const rhs_b256 = str_digits_to_b256(flot_part, &rhs_len, false);
+  if (lit.has_sign) {
+    errno = EINVAL;
+    return NULL;
+  }
 
-  set_out_param(len, (uint16_t) (lhs_len + rhs_len) );
-  set_out_param(int_len, lhs_len);
+  return numlit_to_b256_z(&lit, len, int_len, little_endian);
+}
 
-  atom_t* const final_concat = array_concat(lhs_b256, lhs_len, rhs_b256, rhs_len);
+/*
+  char*, size_t, uint16_t*, uint16_t*, bool -> atom_t*
+
+  ldbl_digits_to_b256_z for lengths that fit a big array's header (see
+    TYP_BIG), with NULL returned and errno set to ERANGE when the result is
+    too long
+*/
+atom_t* ldbl_digits_to_b256_n (const char* const ldbl_digits, const size_t n, uint16_t* const len, uint16_t* const int_len, const bool little_endian) {
+  size_t total = 1, total_int = 1;
+  atom_t* const res = ldbl_digits_to_b256_z(ldbl_digits, n, NULL == len ? NULL : &total, NULL == int_len ? NULL : &total_int, little_endian);
+
+  if (NULL != res && total > UINT16_MAX) {
+    bn_free(res);
+    set_out_param(len, 0);
+    set_out_param(int_len, 0);
+    errno = ERANGE;
+    return NULL;
+  }
+
+  set_out_param(len, (uint16_t) total);
+  set_out_param(int_len, (uint16_t) total_int);
+  return res;
+}
 
-  free(lhs_b256), free(rhs_b256);
+/*
+  char*, uint16_t*, uint16_t*, bool -> atom_t*
+
+  ldbl_digits_to_b256_n for a terminated string, of which at most
+    MAX_STR_LDBL_DIGITS characters are read
+*/
+atom_t* ldbl_digits_to_b256 (const char* const ldbl_digits, uint16_t* const len, uint16_t* const int_len, const bool little_endian) {
+  return ldbl_digits_to_b256_n(ldbl_digits, strnlen_c(ldbl_digits, MAX_STR_LDBL_DIGITS), len, int_len, little_endian);
+}
+
+/*
+  atom_t*, size_t, size_t -> char*
 
-  if (little_endian) {
-    atom_t* const reversed = array_reverse(final_concat, *len);
-    free(final_concat);
+  convert a base 256 representation of a long double, laid out as
+    ldbl_digits_to_b256 makes it (integer part first, both parts big endian),
+    to a base 10 string like "123.45"
 
-    return reversed;
-  } else {
-    return final_concat;
+  the fractional part is exact, as every base 256 fraction is a base 10 one
+    (see b256_frac_to_b10), with the trailing zeroes removed; an integer has
+    no separator, and a zero integer part is written as 0
+
+  an empty string is returned when
+    len is 0
+    int_len is greater than len
+    digits is NULL
+
+  NULL is returned when memory is exhausted
+*/
+char* b256_to_ldbl_digits (const atom_t* const digits, const size_t len, const size_t int_len) {
+  if (NULL == digits || ! len || int_len > len) {
+    return make_empty_string();
+  }
+
+  /* room for the most it can be, as finding the size is the whole work */
+  const size_t cap = 3 * int_len + 2 + 8 * (len - int_len) + 2;
+  char* const str = alloc(char, cap);
+  if (NULL == str) { return NULL; }
+
+  /* the size is only 0 when memory is exhausted */
+  const size_t n = b256_to_ldbl_digits_into(str, cap, digits, len, int_len);
+  if (! n) {
+    bn_free(str);
+    return NULL;
   }
+
+  char* const fit = (char*) bn_realloc(str, n + 1);
+  return NULL == fit ? str : fit;
+}
+
+/*
+  char*, size_t, atom_t*, size_t, size_t -> size_t
+
+  b256_to_ldbl_digits, into the caller's buffer out, which has room for cap
+    chars, using only scratch space (see scratch.c) on the way; the return
+    value and cap behave as for b10_to_ldbl_digits_into
+
+  the string is empty (and 0 is returned) in the same cases as an empty string
+    is returned by b256_to_ldbl_digits, and 0 is also returned when memory is
+    exhausted
+*/
+size_t b256_to_ldbl_digits_into (char* const out, const size_t cap, const atom_t* const digits, const size_t len, const size_t int_len) {
+  if (NULL == digits || ! len || int_len > len) {
+    if (NULL != out && cap) { out[0] = '\0'; }
+    return 0;
+  }
+
+  const size_t flot_len = len - int_len,
+               b10_len  = 8 * flot_len,
+               int_cap  = 3 * int_len + 2;   /* 256 < 10^3 */
+
+  const scratch_mark_t mark = scratch_mark();
+  char*   const int_str  = salloc(char, int_cap);
+  atom_t* const flot_b10 = salloc(atom_t, b10_len + 1);
+
+  if (NULL == int_str || NULL == flot_b10 || ! b256_frac_to_b10(flot_b10, b10_len, digits + int_len, flot_len)) {
+    scratch_reset(mark);
+    return 0;
+  }
+
+  const size_t int_used = b256_to_radix_into(int_str, int_cap, digits, int_len, DEC_BASE);
+
+  size_t flot_used = b10_len;
+  while (flot_used && 0 == flot_b10[flot_used - 1]) { flot_used--; }
+
+  const size_t need = int_used + (flot_used ? 1 + flot_used : 0);
+
+  if (int_used && NULL != out && cap > need) {
+    memcpy(out, int_str, int_used);
+    out[int_used] = DECIMAL_SEPARATOR_STR[0];
+    digits_to_chars(out + int_used + 1, flot_b10, flot_used, false);
+    out[need] = '\0';
+  }
+
+  scratch_reset(mark);
+  return int_used ? need : 0;
 }
 
 /*
@@ -177,83 +696,92 @@ uint64_t b256_to_u64 (const atom_t* const digits, const uint16_t len) {
     return 0;
 }
 
-char* b256_to_u64_digits (const atom_t* const digits, const uint16_t len) {
-  (void) digits;
-  (void) len;
-  return NULL;
-}
-
 /*
-  atom_t*, uint16_t, uint16_t, uint16_t* -> char*
+  atom_t*, size_t -> char*
 
-  convert base 256 representation of a long double to base 10 string
+  the base 10 digits of a little endian base 256 integer, of any length, as a
+    string; the counterpart of b256_to_u64 that cannot overflow
 
-  an empty string is returned when
-    len is 0
-    int_len is greater than len
-    out_int_len is not writable (i.e. NULL)
-    digits is NULL
+  an empty string is returned when digits is NULL or len is 0
 */
-char* b256_to_ldbl_digits (const atom_t* const digits, const uint16_t len, const uint16_t int_len) {
-
-  /* prologue: check arguments */
-
-  /* 0 is a valid int_len */
-  if (NULL == digits || ! len || int_len > len) {
+char* b256_to_u64_digits (const atom_t* const digits, const size_t len) {
+  if (NULL == digits || ! len) {
     return make_empty_string();
   }
 
-  /* step 1: base 256 -> base 10 parts */
+  const scratch_mark_t mark = scratch_mark();
+  atom_t* const big_endian = salloc(atom_t, len);
+  char* str = NULL;
 
-  /* copy value to a better name */
-  const uint16_t int_len_orig = int_len;
+  if (NULL != big_endian) {
+    for (size_t i = 0; i < len; i++) { big_endian[i] = digits[len - 1 - i]; }
+    str = b256_to_radix(big_endian, len, DEC_BASE);
+  }
 
-  /* the length of the fractional part is from subtraction */
-  const uint16_t flot_len_orig = (uint16_t) (len - int_len_orig);
+  scratch_reset(mark);
+  return str;
+}
 
-  /* copy the parts (in base 256) from the original (1 2) */
-  atom_t *const int_b256  = (atom_t*) memcpy( alloc(atom_t, int_len_orig), digits, sz(atom_t, int_len_orig)),
-  /* the flot part needs to be reversed so that it is little endian (descending places from left to right) */
-         *const flot_b256 = array_reverse(digits + int_len_orig, flot_len_orig); // big endian -> le
+/*
+  char*, size_t, atom_t*, size_t -> size_t
 
-  /* step 2: base 10 parts -> strings */
+  b256_to_u64_digits, into the caller's buffer out, which has room for cap
+    chars; the return value and cap behave as for b10_to_ldbl_digits_into
+*/
+size_t b256_to_u64_digits_into (char* const out, const size_t cap, const atom_t* const digits, const size_t len) {
+  if (NULL == digits || ! len) {
+    if (NULL != out && cap) { out[0] = '\0'; }
+    return 0;
+  }
 
-  /* convert / reverse the parts (3 4 5) */
-  char *const int_b10     = b256_to_u64_digits(int_b256, int_len_orig),
-  /* this conversion will be wrong if the flot part is left big endian */
-       *const flot_b10    = b256_to_u64_digits(flot_b256, flot_len_orig), // le -> le
-  /* re-reverse the flot part so that it is in the proper order */
-       *const flot_b10_be = str_reverse(flot_b10); // le -> be
+  const scratch_mark_t mark = scratch_mark();
+  atom_t* const big_endian = salloc(atom_t, len);
+  size_t n = 0;
 
-  /* don't need the base256 parts anymore (~1 ~2 ~4) */
-  free(int_b10), free(flot_b256), free(flot_b10);
+  if (NULL != big_endian) {
+    for (size_t i = 0; i < len; i++) { big_endian[i] = digits[len - 1 - i]; }
+    n = b256_to_radix_into(out, cap, big_endian, len, DEC_BASE);
+  }
 
-  /* step 3: strings -> string + sep + string */
+  scratch_reset(mark);
+  return n;
+}
 
-  const uint16_t int_len_b10 = (uint16_t) strnlen_c(int_b10, MAX_STR_LDBL_DIGITS),
-                flot_len_b10 = (uint16_t) strnlen_c(flot_b10_be, MAX_STR_LDBL_DIGITS);
+/*
+  atom_t*, size_t, uint64_t, bool -> size_t
 
-  // 6
-  char* const out_str = alloc(char, 2 + int_len_b10 + flot_len_b10);
+  write the base 256 digits of value, most significant first unless
+    little_endian is true, into the caller's array out, which has room for cap
+    digits; 0 is one zero digit
 
-  snprintf(out_str, 1U + int_len_b10 + flot_len_b10, "%s.%s", int_b10, flot_b10_be);
+  the return value and cap behave as for u64_to_b10_into
+*/
+size_t u64_to_b256_into (atom_t* const out, const size_t cap, const uint64_t value, const bool little_endian) {
+  const atom_t ndigits = count_b256_digits_u64(value);
+  if (NULL == out || cap < ndigits) { return ndigits; }
 
-  // ~3 ~5
-  free(int_b10), free(flot_b10_be);
+  uint64_t rest = value;
+  for (atom_t i = 0; i < ndigits; i++, rest >>= CHAR_BIT) {
+    out[little_endian ? i : ndigits - 1 - i] = (atom_t) rest;
+  }
+  return ndigits;
+}
 
-  /* epilogue: finish */
+/*
+  uint64_t, uint16_t*, bool -> atom_t*
 
-  // 6 leaves scope
-  return out_str;
-}
+  the base 256 digits of value, most significant first unless little_endian is
+    true; 0 is one zero digit
 
+  the value at len is changed to the number of digits
+*/
 atom_t* u64_to_b256 (const uint64_t value, uint16_t* const len, const bool little_endian) {
-  char* const val_str = alloc(char, count_digits_u64(value));
-  snprintf(val_str, MAX_U64_DIGITS, "%" PRIu64 "", value);
+  const size_t ndigits = u64_to_b256_into(NULL, 0, value, little_endian);
 
-  atom_t* const result = u64_digits_to_b256(val_str, len, little_endian);
-  free(val_str);
+  atom_t* const result = alloc(atom_t, ndigits);
+  if (NULL != result) { u64_to_b256_into(result, ndigits, value, little_endian); }
 
+  set_out_param(len, (uint16_t) ndigits);
   return result;
 }
 
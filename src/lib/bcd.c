@@ -0,0 +1,457 @@
+#ifndef BCD_H
+#define BCD_H
+
+#include "bn_common.h"
+
+/*
+  packed BCD (binary coded decimal): two base 10 digits to a byte (see TYP_BCD)
+
+  the more significant digit is in the high nibble, so the bytes of a number
+    compare in the same order as its digits; like the words of TYP_PACK, the
+    bytes of an integer part are grouped from the separator leftwards, and
+    those of a fractional part rightwards, so that 123.4 is 01 23 . 40
+
+  packing and unpacking need no change of radix, so they are a vector
+    register at a time; additions are 16 digits to a 64 bit word (see
+    bcd_add), and comparisons are a vector register at a time
+*/
+
+#define BCD_SIXES ((uint64_t) 0x6666666666666666U)
+#define BCD_ONES  ((uint64_t) 0x1111111111111110U)
+
+/*
+  size_t -> size_t
+
+  the bytes that hold len base 10 digits of one part of a number
+*/
+size_t count_bcd_bytes (const size_t len) {
+  return (len + 1) / 2;
+}
+
+/*
+  atom_t*, atom_t*, size_t -> void
+
+  pack 2 n base 10 digits into n bytes, two at a time
+*/
+static void bcd_pack_pairs (atom_t* const out, const atom_t* const digits, const size_t n) {
+  size_t i = 0;
+
+#ifdef BN_HAVE_SSE2
+  {
+    const __m128i high = _mm_set1_epi16(0x00F0);
+
+    for (; i + 8 <= n; i += 8) {
+      /* each 16 bit lane is a pair, with its first digit in the low byte */
+      const __m128i v = _mm_loadu_si128((const __m128i*) (digits + 2 * i));
+      const __m128i p = _mm_or_si128(_mm_and_si128(_mm_slli_epi16(v, 4), high), _mm_srli_epi16(v, 8));
+      _mm_storel_epi64((__m128i*) (out + i), _mm_packus_epi16(p, p));
+    }
+  }
+#endif /* BN_HAVE_SSE2 */
+
+  for (; i < n; i++) {
+    out[i] = (atom_t) (digits[2 * i] << 4 | digits[2 * i + 1]);
+  }
+}
+
+/*
+  atom_t*, atom_t*, size_t -> void
+
+  unpack n bytes into 2 n base 10 digits
+*/
+static void bcd_unpack_pairs (atom_t* const out, const atom_t* const bytes, const size_t n) {
+  size_t i = 0;
+
+#ifdef BN_HAVE_SSE2
+  {
+    const __m128i low = _mm_set1_epi8(0x0F);
+
+    for (; i + 8 <= n; i += 8) {
+      const __m128i v = _mm_loadl_epi64((const __m128i*) (bytes + i));
+      /* the high nibbles go first */
+      const __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), low),
+                    lo = _mm_and_si128(v, low);
+      _mm_storeu_si128((__m128i*) (out + 2 * i), _mm_unpacklo_epi8(hi, lo));
+    }
+  }
+#endif /* BN_HAVE_SSE2 */
+
+  for (; i < n; i++) {
+    out[2 * i]     = (atom_t) (bytes[i] >> 4);
+    out[2 * i + 1] = (atom_t) (bytes[i] & 0x0F);
+  }
+}
+
+/*
+  atom_t*, atom_t*, size_t, size_t, size_t* -> size_t
+
+  pack len base 10 digits, of which the first int_len are the integer part,
+    into bytes, and return how many there are; the value at out_int_len is
+    changed to how many of them are the integer part
+
+  out needs room for count_bcd_bytes(int_len) + count_bcd_bytes(len - int_len)
+*/
+size_t b10_to_bcd (atom_t* const out, const atom_t* const digits, const size_t len, const size_t int_len, size_t* const out_int_len) {
+  const size_t frac_len = len - int_len,
+               nint     = count_bcd_bytes(int_len),
+               nfrac    = count_bcd_bytes(frac_len);
+
+  /* an odd integer part starts with a lone digit, and an odd fractional part
+    ends with one */
+  const size_t odd_int = int_len % 2;
+  if (odd_int) { out[0] = digits[0]; }
+  bcd_pack_pairs(out + odd_int, digits + odd_int, int_len / 2);
+
+  bcd_pack_pairs(out + nint, digits + int_len, frac_len / 2);
+  if (frac_len % 2) { out[nint + nfrac - 1] = (atom_t) (digits[len - 1] << 4); }
+
+  set_out_param(out_int_len, nint);
+  return nint + nfrac;
+}
+
+/*
+  atom_t*, atom_t*, size_t, size_t, size_t* -> size_t
+
+  unpack len bytes, of which the first int_len are the integer part, into base
+    10 digits, and return how many there are; the inverse of b10_to_bcd
+
+  the integer part has no leading zeroes and the fractional part no trailing
+    ones, so either may be empty; the value at out_int_len is changed to the
+    number of integer digits
+
+  out needs room for 2 len digits
+*/
+size_t bcd_to_b10 (atom_t* const out, const atom_t* const bytes, const size_t len, const size_t int_len, size_t* const out_int_len) {
+  bcd_unpack_pairs(out, bytes, len);
+
+  size_t lead = 0, end = 2 * len;
+  const size_t sep = 2 * int_len;
+
+  while (lead < sep && 0 == out[lead]) { lead++; }
+  while (end > sep && 0 == out[end - 1]) { end--; }
+
+  memmove(out, out + lead, end - lead);
+
+  set_out_param(out_int_len, sep - lead);
+  return end - lead;
+}
+
+/*
+  atom_t* -> uint64_t
+
+  the 8 bytes at p as a word, the first of them most significant
+*/
+static uint64_t bcd_load (const atom_t* const p) {
+  uint64_t w = 0;
+  for (size_t i = 0; i < sizeof w; i++) {
+    w = (w << CHAR_BIT) | p[i];
+  }
+  return w;
+}
+
+/*
+  atom_t*, uint64_t -> void
+
+  store a word at p as bcd_load reads it
+*/
+static void bcd_store (atom_t* const p, const uint64_t w) {
+  for (size_t i = 0; i < sizeof w; i++) {
+    p[i] = (atom_t) (w >> (CHAR_BIT * (sizeof w - 1 - i)));
+  }
+}
+
+/*
+  uint64_t, uint64_t, unsigned* -> uint64_t
+
+  the sum of two words of 16 BCD digits and the carry at carry, which is
+    changed to the carry out
+
+  every digit of a is biased by 6, so that a digit sum of 10 or more carries
+    out of its nibble in the binary addition; the digits that did not carry
+    then have their 6 taken back
+*/
+static uint64_t bcd_add_word (const uint64_t a, const uint64_t b, unsigned* const carry) {
+  const uint64_t t1 = a + BCD_SIXES,
+                 s  = t1 + b,
+                 t2 = s + *carry;
+
+  /* whether each nibble got a carry from the one below it */
+  const uint64_t carried = (t1 ^ b ^ t2) & BCD_ONES;
+  const bool     out     = s < t1 || t2 < s;
+
+  /* 6 in each nibble that did not carry out, the top one included */
+  const uint64_t no_carry = (~carried & BCD_ONES) >> 4 | (out ? 0 : (uint64_t) 1 << 60),
+                 fix      = (no_carry << 2) | (no_carry << 1);
+
+  *carry = out;
+  return t2 - fix;
+}
+
+/*
+  atom_t*, atom_t*, atom_t*, size_t -> atom_t
+
+  r = a + b, for n bytes of packed BCD each, most significant first, and
+    return the carry out of the first byte (0 or 1); r may be a or b
+*/
+atom_t bcd_add (atom_t* const r, const atom_t* const a, const atom_t* const b, const size_t n) {
+  unsigned carry = 0;
+  size_t i = n;
+
+  for (; i >= sizeof (uint64_t); i -= sizeof (uint64_t)) {
+    const size_t at = i - sizeof (uint64_t);
+    bcd_store(r + at, bcd_add_word(bcd_load(a + at), bcd_load(b + at), &carry));
+  }
+
+  /* the bytes left at the front, two digits at a time */
+  while (i--) {
+    unsigned lo = (a[i] & 0x0FU) + (b[i] & 0x0FU) + carry,
+             hi = (unsigned) (a[i] >> 4) + (unsigned) (b[i] >> 4);
+
+    if (lo >= DEC_BASE) { lo -= DEC_BASE, hi++; }
+    carry = hi >= DEC_BASE;
+    if (carry) { hi -= DEC_BASE; }
+
+    r[i] = (atom_t) (hi << 4 | lo);
+  }
+
+  return (atom_t) carry;
+}
+
+/*
+  atom_t*, atom_t*, size_t -> int
+
+  compare n bytes of packed BCD each, most significant first; less than, equal
+    to, or greater than 0 as a is less than, equal to, or greater than b
+
+  the digits are in the order of the bytes, so this finds the first differing
+    byte a vector register at a time
+*/
+int bcd_cmp (const atom_t* const a, const atom_t* const b, const size_t n) {
+  size_t i = 0;
+
+#ifdef BN_HAVE_AVX2
+  for (; i + 32 <= n; i += 32) {
+    const __m256i eq = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*) (a + i)), _mm256_loadu_si256((const __m256i*) (b + i)));
+    if (-1 != _mm256_movemask_epi8(eq)) { break; }
+  }
+#endif /* BN_HAVE_AVX2 */
+
+#ifdef BN_HAVE_SSE2
+  for (; i + 16 <= n; i += 16) {
+    const __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) (a + i)), _mm_loadu_si128((const __m128i*) (b + i)));
+    if (0xFFFF != _mm_movemask_epi8(eq)) { break; }
+  }
+#endif /* BN_HAVE_SSE2 */
+
+  for (; i < n; i++) {
+    if (a[i] != b[i]) { return a[i] < b[i] ? -1 : 1; }
+  }
+
+  return 0;
+}
+
+/*
+  atom_t*, size_t, size_t, size_t, size_t -> void
+
+  copy the BCD number a into out, which has out_int integer bytes and out_len
+    bytes in all, lining up the separators and filling the rest with zeroes
+*/
+static void bcd_align (atom_t* const out, const size_t out_len, const size_t out_int, const atom_t* const a, const size_t a_len, const size_t a_int_len) {
+  const size_t shift = out_int - a_int_len;
+  memset(out, 0, out_len);
+  memcpy(out + shift, a, a_len);
+}
+
+/*
+  atom_t*, size_t, size_t, atom_t*, size_t, size_t, size_t*, size_t* -> atom_t*
+
+  a + b, for unsigned packed BCD numbers of len bytes, of which int_len are
+    the integer part; the result has no zero bytes at either end, and its
+    lengths are written to out_len and out_int_len
+
+  NULL is returned when memory is exhausted
+*/
+atom_t* add_bcd (const atom_t* const a, const size_t a_len, const size_t a_int_len, const atom_t* const b, const size_t b_len, const size_t b_int_len, size_t* const out_len, size_t* const out_int_len) {
+  /* one more integer byte for the carry */
+  const size_t r_int  = max(a_int_len, b_int_len) + 1,
+               r_frac = max(a_len - a_int_len, b_len - b_int_len),
+               r_len  = r_int + r_frac;
+
+  atom_t* const r     = alloc(atom_t, r_len);
+  atom_t* const other = alloc(atom_t, r_len);
+
+  if (NULL == r || NULL == other) {
+    bn_free(r), bn_free(other);
+    return NULL;
+  }
+
+  bcd_align(r, r_len, r_int, a, a_len, a_int_len);
+  bcd_align(other, r_len, r_int, b, b_len, b_int_len);
+  bcd_add(r, r, other, r_len);
+  bn_free(other);
+
+  size_t lead = 0, end = r_len;
+  while (lead < r_int && 0 == r[lead]) { lead++; }
+  while (end > r_int && 0 == r[end - 1]) { end--; }
+  memmove(r, r + lead, end - lead);
+
+  set_out_param(out_len, end - lead);
+  set_out_param(out_int_len, r_int - lead);
+  return r;
+}
+
+/*
+  atom_t*, size_t, size_t, atom_t*, size_t, size_t -> int
+
+  compare unsigned packed BCD numbers of len bytes, of which int_len are the
+    integer part, as bcd_cmp does
+
+  2 is returned when memory is exhausted
+*/
+int cmp_bcd (const atom_t* const a, const size_t a_len, const size_t a_int_len, const atom_t* const b, const size_t b_len, const size_t b_int_len) {
+  /* the same lengths compare in place */
+  if (a_len == b_len && a_int_len == b_int_len) {
+    return bcd_cmp(a, b, a_len);
+  }
+
+  const size_t r_int = max(a_int_len, b_int_len),
+               r_len = r_int + max(a_len - a_int_len, b_len - b_int_len);
+
+  atom_t* const x = alloc(atom_t, r_len + 1);
+  atom_t* const y = alloc(atom_t, r_len + 1);
+
+  int order = 2;
+  if (NULL != x && NULL != y) {
+    bcd_align(x, r_len, r_int, a, a_len, a_int_len);
+    bcd_align(y, r_len, r_int, b, b_len, b_int_len);
+    order = bcd_cmp(x, y, r_len);
+  }
+
+  bn_free(x), bn_free(y);
+  return order;
+}
+
+/*
+  atom_t*, size_t, atom_t*, size_t, size_t, atom_t, atom_t -> size_t
+
+  lay out the packed BCD array b10_to_bcd_array would make in the caller's
+    buffer out, which has room for cap atoms, and give its length; nothing is
+    written when out is NULL or cap is too small, so the length can be asked
+    for first
+
+  0 is returned, and errno set to ERANGE, as by b10_to_bcd_array
+*/
+size_t b10_to_bcd_array_into (atom_t* const out, const size_t cap, const atom_t* const digits, const size_t len, const size_t int_len, const atom_t metadata, const atom_t flags) {
+  const atom_t bcd_meta = (atom_t) ((metadata | TYP_BCD) & ~(TYP_ZENZ | TYP_PACK));
+  const size_t max_part = meta_max_len(bcd_meta),
+               nint     = count_bcd_bytes(int_len),
+               nfrac    = count_bcd_bytes(len - int_len);
+
+  if (nint > max_part || nfrac > max_part) {
+    errno = ERANGE;
+    return 0;
+  }
+
+  atom_t header[HEADER_OFFSET_HUGE];
+  const size_t hdrlen = make_array_header_into(header, HEADER_OFFSET_HUGE, bcd_meta, nint, nfrac, flags);
+  if (0 == hdrlen) { return 0; }
+
+  const size_t need = hdrlen + nint + nfrac;
+  if (NULL == out || cap < need) { return need; }
+
+  memcpy(out, header, sz(atom_t, hdrlen));
+  b10_to_bcd(out + hdrlen, digits, len, int_len, NULL);
+  return need;
+}
+
+/*
+  atom_t*, size_t, size_t, atom_t, atom_t -> atom_t*
+
+  a packed BCD array (see TYP_BCD) of len base 10 digits, of which the first
+    int_len are the integer part, with the given metadata and flags; TYP_BCD
+    is set, and TYP_ZENZ and TYP_PACK cleared, in its metadata
+
+  NULL is returned and errno is set to ERANGE if either part needs more bytes
+    than the header can describe (255, 65535 with TYP_BIG, or UINT32_MAX with
+    TYP_HUGE)
+*/
+atom_t* b10_to_bcd_array (const atom_t* const digits, const size_t len, const size_t int_len, const atom_t metadata, const atom_t flags) {
+  const size_t need = b10_to_bcd_array_into(NULL, 0, digits, len, int_len, metadata, flags);
+  if (0 == need) { return NULL; }
+
+  atom_t* const bcd = alloc(atom_t, need);
+  if (NULL == bcd) { return NULL; }
+
+  b10_to_bcd_array_into(bcd, need, digits, len, int_len, metadata, flags);
+  return bcd;
+}
+
+/*
+  atom_t*, atom_t -> atom_t*
+
+  a packed BCD array with the value of a base 10 array, and the other bits of
+    metadata, as from b10_to_bcd_array
+
+  NULL is returned and errno is set to
+    EINVAL if bna is not a base 10 array
+    ERANGE as from b10_to_bcd_array
+*/
+atom_t* b10_array_to_bcd_array (const atom_t* const bna, const atom_t metadata) {
+  if (NULL == bna || bna_is_base256(bna) || bna_is_packed(bna) || bna_is_bcd(bna)) {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  const bn_view_t v = bn_view(bna);
+  return b10_to_bcd_array(v.data, view_len(v), v.int_len, metadata, v.flags);
+}
+
+/*
+  atom_t* -> atom_t*
+
+  the base 10 array with the value of a packed BCD array, with TYP_BCD
+    cleared from its metadata; the integer part has no leading zeroes
+
+  NULL is returned and errno is set to
+    EINVAL if bcd is not packed BCD
+    ERANGE if either part has more digits than the header can describe
+*/
+atom_t* bcd_array_to_b10_array (const atom_t* const bcd) {
+  if (NULL == bcd || ! bna_is_bcd(bcd)) {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  const bn_view_t v = bn_view(bcd);
+  const size_t nint = v.int_len,
+               len  = view_len(v);
+
+  atom_t* const digits = alloc(atom_t, 2 * len + 1);
+  if (NULL == digits) { return NULL; }
+
+  size_t int_len = 0;
+  const size_t ndigits = bcd_to_b10(digits, v.data, len, nint, &int_len);
+
+  const atom_t metadata = (atom_t) (bcd[0] & ~TYP_BCD);
+  const size_t max_part = meta_max_len(metadata);
+
+  if (int_len > max_part || ndigits - int_len > max_part) {
+    bn_free(digits);
+    errno = ERANGE;
+    return NULL;
+  }
+
+  atom_t* const header = make_array_header(metadata, int_len, ndigits - int_len, v.flags);
+  const atom_t  hdrlen = NULL == header ? 0 : bna_header_offset(header);
+  atom_t* const bna    = alloc(atom_t, hdrlen + ndigits);
+
+  if (NULL != header && NULL != bna) {
+    memcpy(bna, header, sz(atom_t, hdrlen));
+    memcpy(bna + hdrlen, digits, sz(atom_t, ndigits));
+  }
+
+  bn_free(header), bn_free(digits);
+  return bna;
+}
+
+#endif /* end of include guard: BCD_H */
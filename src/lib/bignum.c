@@ -3,74 +3,252 @@
 
 #include "bn_common.h"
 
+/*
+  a bignum_t is laid out in one block with everything it has:
+
+    STRUCTURE, VALUE, IMGRY, FRACL, VEXTN, EXPT...
+
+  each at a multiple of BIGNUM_ALIGN from the start; a value kept inline (see
+    bignum_t) and parts which are not there take no room, and the exponent
+    is a bignum_t laid out the same way, in the rest of the block
+
+  so one allocation makes a bignum, one bn_free releases it, and a copy is
+    one memcpy, after which the parts' pointers are moved to the new block;
+    the parts of a bignum_t made here are not to be replaced by others
+*/
+
+/* n rounded up to a multiple of m */
+#define bignum_round(n, m) (((n) + (m) - 1) / (m) * (m))
+
+/* the atoms in the digit array bna, or 0 if there is none */
+static size_t bignum_array_len (const atom_t* const bna) {
+  return NULL == bna ? 0 : bna_size(bna);
+}
+
+/* whether the main value bna is kept in the structure */
+static bool bignum_fits_inline (const atom_t* const bna) {
+  return bna_is_compact(bna) && bignum_array_len(bna) <= BN_INLINE_LEN;
+}
+
+/*
+  atom_t*, atom_t*, atom_t*, atom_t*, bignum_t*, bool -> size_t
+
+  the atoms a bignum_t made of these parts takes (see bignum_lay_out)
+*/
+static size_t bignum_layout_len (
+  const atom_t* const value,
+  const atom_t* const imgry,
+  const atom_t* const fracl,
+  const atom_t* const vextn,
+  const bignum_t* const expt,
+  const bool bare_expt
+) {
+  size_t len = bignum_round(sizeof (bignum_t), BIGNUM_ALIGN);
+
+  if (! bignum_fits_inline(value)) { len += bignum_round(bignum_array_len(value), BIGNUM_ALIGN); }
+  len += bignum_round(bignum_array_len(imgry), BIGNUM_ALIGN)
+       + bignum_round(bignum_array_len(fracl), BIGNUM_ALIGN)
+       + bignum_round(bignum_array_len(vextn), BIGNUM_ALIGN);
+
+  if (NULL != expt) {
+    len += bare_expt
+      ? bignum_layout_len(bignum_value(expt), NULL, NULL, NULL, NULL, false)
+      : bignum_layout_len(bignum_value(expt), expt->imgry, expt->fracl, expt->vextn, expt->expt, false);
+  }
+  return len;
+}
+
+/* copy bna, if there is one, to *at, and move *at past it */
+static atom_t* bignum_place (atom_t** const at, const atom_t* const bna) {
+  if (NULL == bna) { return NULL; }
+
+  atom_t* const placed = *at;
+  const size_t len = bignum_array_len(bna);
+
+  memcpy(placed, bna, len);
+  *at += bignum_round(len, BIGNUM_ALIGN);
+  return placed;
+}
+
+/*
+  bignum_t*, atom_t*, atom_t*, atom_t*, atom_t*, bignum_t*, bool -> size_t
+
+  lay out a bignum_t of copies of the parts at to, which has room for
+    bignum_layout_len of the same parts, and give that length; the
+    exponent's own optional parts are left out when bare_expt is true
+*/
+static size_t bignum_lay_out (
+  bignum_t* const to,
+  const atom_t* const value,
+  const atom_t* const imgry,
+  const atom_t* const fracl,
+  const atom_t* const vextn,
+  const bignum_t* const expt,
+  const bool bare_expt
+) {
+  memset(to, 0, sizeof (bignum_t));
+  atom_t* at = (atom_t*) (void*) to + bignum_round(sizeof (bignum_t), BIGNUM_ALIGN);
+
+  if (bignum_fits_inline(value)) {
+    memcpy(to->inl, value, bignum_array_len(value));
+  } else {
+    to->value = bignum_place(&at, value);
+  }
+
+  to->imgry = bignum_place(&at, imgry);
+  to->fracl = bignum_place(&at, fracl);
+  to->vextn = bignum_place(&at, vextn);
+
+  if (NULL != expt) {
+    to->expt = (bignum_t*) (void*) at;
+    at += bare_expt
+      ? bignum_lay_out(to->expt, bignum_value(expt), NULL, NULL, NULL, NULL, false)
+      : bignum_lay_out(to->expt, bignum_value(expt), expt->imgry, expt->fracl, expt->vextn, expt->expt, false);
+  }
+
+  to->size = (size_t) (at - (atom_t*) (void*) to);
+  return to->size;
+}
+
+/* a new block holding a bignum_t made of the parts, or NULL when memory is exhausted */
+static bignum_t* bignum_build (
+  const atom_t* const value,
+  const atom_t* const imgry,
+  const atom_t* const fracl,
+  const atom_t* const vextn,
+  const bignum_t* const expt,
+  const bool bare_expt
+) {
+  const size_t len = bignum_layout_len(value, imgry, fracl, vextn, expt, bare_expt);
+
+  bignum_t* const bn = (bignum_t*) (void*) alloc(atom_t, len);
+  if (NULL == bn) { return NULL; }
+
+  bignum_lay_out(bn, value, imgry, fracl, vextn, expt, bare_expt);
+  return bn;
+}
+
+/* where p, which is in from's block, is in to's, which is a copy of it */
+static atom_t* bignum_moved (const bignum_t* const from, bignum_t* const to, const atom_t* const p) {
+  return NULL == p ? NULL : (atom_t*) (void*) to + (p - (const atom_t*) (const void*) from);
+}
+
+/* point the parts of to, a memcpy of from, into its own block */
+static void bignum_rebase (bignum_t* const to, const bignum_t* const from) {
+  to->value = bignum_moved(from, to, from->value);
+  to->imgry = bignum_moved(from, to, from->imgry);
+  to->fracl = bignum_moved(from, to, from->fracl);
+  to->vextn = bignum_moved(from, to, from->vextn);
+
+  if (NULL != from->expt) {
+    to->expt = (bignum_t*) (void*) bignum_moved(from, to, (const atom_t*) (const void*) from->expt);
+    bignum_rebase(to->expt, from->expt);
+  }
+}
+
 /*
   ldbl_t, uint64_t, atom_t, bignum_t** -> bignum_t*
 
   create a new bignum out of primitives and values or give zero
+
+  the main value is made as by to_digit_array, from the first nonzero of ldbl
+    and u64; one that fits a compact array (up to 15 integer and 15
+    fractional digits) is kept inside the structure, and a longer one is a
+    TYP_BIG array after it
+
+  opt_vals, if not NULL, holds the imaginary part, the fractional part and
+    the exponent, any of which may be NULL; their values are copied into the
+    new bignum's block, without the exponent's own optional parts. parts
+    which are not given are NULL, and take no room
+
+  the bignum is one allocation (see above), released with bignum_free
+
+  NULL is returned when memory is exhausted
+*/
+bignum_t* bignum_ctor (
+  const ldbl_t   ldbl,
+  const uint64_t u64,
+  const atom_t flags,
+  const bignum_t * const * const opt_vals
+) {
+
+  const bignum_t
+    * const imgry = NULL == opt_vals ? NULL : opt_vals[0],
+    * const fracl = NULL == opt_vals ? NULL : opt_vals[1],
+    * const expt  = NULL == opt_vals ? NULL : opt_vals[2];
+
+  const scratch_mark_t mark = scratch_mark();
+
+  atom_t inl[BN_INLINE_LEN];
+  const atom_t* value = inl;
+
+  if (0 == to_digit_array_into(inl, BN_INLINE_LEN, ldbl, u64, flags, TYP_COMPACT)) {
+    /* too long for a compact array */
+    const size_t need = to_digit_array_into(NULL, 0, ldbl, u64, flags, TYP_BIG);
+    atom_t* const big = 0 == need ? NULL : salloc(atom_t, need);
+    if (NULL == big) {
+      scratch_reset(mark);
+      return NULL;
+    }
+
+    to_digit_array_into(big, need, ldbl, u64, flags, TYP_BIG);
+    value = big;
+  }
+
+  bignum_t* const bn = bignum_build(
+    value,
+    NULL == imgry ? NULL : bignum_value(imgry),
+    NULL == fracl ? NULL : bignum_value(fracl),
+    NULL,
+    expt,
+    true
+  );
+
+  scratch_reset(mark);
+  return bn;
+}
+
+/*
+  bignum_t*, bool -> bignum_t*
+
+  deep copy a bignum_t's properties but not its identity; the optional parts
+    (imaginary, fractional, extension and exponent) are left out when
+    no_recurse_optionals is true
+
+  a bignum_t from bignum_ctor or bignum_copy is copied whole with one memcpy;
+    one put together elsewhere, such as a zeroed structure (which is zero,
+    its inline value being an all-zero header), is laid out part by part
+
+  NULL gives zero. NULL is returned when memory is exhausted
+*/
+bignum_t* bignum_copy (const bignum_t* const bn, const bool no_recurse_optionals) {
+
+  if (NULL == bn) { return bignum_ctor(0, 0, FL_NONE, NULL); }
+
+  if (no_recurse_optionals) {
+    return bignum_build(bignum_value(bn), NULL, NULL, NULL, NULL, false);
+  }
+
+  if (0 == bn->size) {
+    return bignum_build(bignum_value(bn), bn->imgry, bn->fracl, bn->vextn, bn->expt, false);
+  }
+
+  bignum_t* const copy = (bignum_t*) (void*) alloc(atom_t, bn->size);
+  if (NULL == copy) { return NULL; }
+
+  memcpy(copy, bn, bn->size);
+  bignum_rebase(copy, bn);
+  return copy;
+}
+
+/*
+  bignum_t* -> void
+
+  free a bignum_t from bignum_ctor or bignum_copy, with every part of it, which
+    are all in its block; NULL is ignored
 */
-//bignum_t* bignum_ctor (
-//  const ldbl_t   ldbl,
-//  const uint64_t u64,
-//  const atom_t flags,
-//  const bignum_t * const * const opt_vals
-//) {
-//
-//  bool cx, fr, ex;
-//
-//  if (NULL != opt_vals) {
-//    cx = NULL != opt_vals[0];
-//    fr = NULL != opt_vals[1];
-//    ex = NULL != opt_vals[2];
-//  } else {
-//    cx = fr = ex = 0;
-//  }
-//
-//  /* create a stack-allocated version of the structure */
-//  bignum_t st_bn = {
-//    /* real value */
-//    .value = to_digit_array(ldbl, u64, flags, 0),
-//    /* imaginary part is determined */
-//    .imgry = cx
-//      ? memcpy(
-//          alloc(atom_t, bna_real_len(opt_vals[0]->value)),
-//          opt_vals[0]->value,
-//          sz(atom_t, bna_real_len(opt_vals[0]->value))
-//        )
-//      : zalloc(atom_t, HEADER_OFFSET),
-//    /* fractional (numerator / denominator) */
-//    .fracl = fr
-//      ? memcpy(
-//        alloc(atom_t, bna_real_len(opt_vals[1]->value)),
-//        opt_vals[1]->value,
-//        sz(atom_t, bna_real_len(opt_vals[1]->value))
-//      )
-//      : zalloc(atom_t, HEADER_OFFSET),
-//    /* exponent */
-//    .expt = ex
-//      ? bignum_copy(opt_vals[2], true)
-//      : bignum_ctor(0, 0, 0, NULL)
-//  };
-//
-//  /* copy it to the heap */
-//  bignum_t* hp_bn = memcpy( alloc(bignum_t, 1), &st_bn, sizeof(bignum_t) );
-//
-//  return hp_bn;
-//}
-//
-///*
-//  bignum_t* -> bignum_t*
-//
-//  deep copy a bignum_t's properties but not its identity
-//*/
-//bignum_t* bignum_copy (const bignum_t* const bn, const bool no_recurse_optionals) {
-//
-//  if (NULL == bn) {
-//    return zalloc(bignum_t, 1);
-//  }
-//
-//  (void) no_recurse_optionals;
-//
-//  return NULL;
-//}
+void bignum_free (bignum_t* const bn) {
+  bn_free(bn);
+}
 
 #endif /* end of include guard: BIGNUM_H */
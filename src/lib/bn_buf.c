@@ -0,0 +1,360 @@
+#ifndef BN_BUF_H
+#define BN_BUF_H
+
+#include "bn_common.h"
+
+/*
+  a base 10 number that is changed in place, for running totals and counters
+
+  the digits sit inside a buffer with spare room at both ends: a carry out of
+    the top digit takes a place in front of them, and a longer fraction takes
+    places after them, so most changes neither allocate nor move the digits;
+    when one end runs out, the buffer at least doubles, and the spare room is
+    shared out between the ends again, so growing is amortised linear
+
+  the number is kept with no leading or trailing zeroes, so zero has no
+    digits at all
+*/
+
+/* the room a new buffer has, when none is asked for */
+#ifndef BN_BUF_MIN_CAP
+  #define BN_BUF_MIN_CAP 32
+#endif
+
+/* the digits of b */
+#define bb_digits(b) ((b)->data + (b)->off)
+
+/* drop leading and trailing zeroes */
+static void bb_trim (bn_buf_t* const b) {
+  while (b->int_len && 0 == b->data[b->off]) {
+    b->off++, b->len--, b->int_len--;
+  }
+  while (b->len > b->int_len && 0 == b->data[b->off + b->len - 1]) {
+    b->len--;
+  }
+}
+
+/*
+  bn_buf_t*, size_t, size_t -> bool
+
+  make room for front more digits before the first one, and back more after
+    the last one, moving the digits to a bigger buffer if need be
+
+  false is returned, and b is unchanged, when memory is exhausted
+*/
+static bool bb_room (bn_buf_t* const b, const size_t front, const size_t back) {
+  if (front <= b->off && back <= b->cap - b->off - b->len) { return true; }
+
+  if (front > SIZE_MAX / 4 || back > SIZE_MAX / 4 || b->len > SIZE_MAX / 4) { return false; }
+
+  const size_t need = b->len + front + back,
+               cap  = max(2 * b->cap, need + BN_BUF_MIN_CAP),
+               off  = front + (cap - need) / 2;
+
+  atom_t* const data = alloc(atom_t, cap);
+  if (NULL == data) { return false; }
+
+  if (b->len) { memcpy(data + off, bb_digits(b), b->len); }
+  bn_free(b->data);
+
+  b->data = data, b->cap = cap, b->off = off;
+  return true;
+}
+
+/*
+  bn_buf_t*, size_t, size_t -> bool
+
+  pad b with zeroes to at least int_len integer and frac_len fractional digits
+*/
+static bool bb_widen (bn_buf_t* const b, const size_t int_len, const size_t frac_len) {
+  const size_t front = int_len > b->int_len ? int_len - b->int_len : 0,
+               frac  = b->len - b->int_len,
+               back  = frac_len > frac ? frac_len - frac : 0;
+
+  if (! bb_room(b, front, back)) { return false; }
+
+  b->off -= front;
+  memset(bb_digits(b), 0, front);
+  memset(bb_digits(b) + front + b->len, 0, back);
+
+  b->len     += front + back;
+  b->int_len += front;
+  return true;
+}
+
+/*
+  size_t -> bn_buf_t*
+
+  a new buffer holding zero, with room for cap digits (or BN_BUF_MIN_CAP if
+    cap is 0) before it has to grow
+
+  NULL is returned when memory is exhausted
+*/
+bn_buf_t* bn_buf_new (const size_t cap) {
+  bn_buf_t* const b = zalloc(bn_buf_t, 1);
+  if (NULL == b) { return NULL; }
+
+  b->cap  = cap ? cap : BN_BUF_MIN_CAP;
+  b->off  = b->cap / 2;
+  b->data = alloc(atom_t, b->cap);
+
+  if (NULL == b->data) {
+    bn_free(b);
+    return NULL;
+  }
+  return b;
+}
+
+/*
+  bn_buf_t* -> void
+
+  free a buffer and its digits; NULL is ignored
+*/
+void bn_buf_free (bn_buf_t* const b) {
+  if (NULL == b) { return; }
+
+  bn_free(b->data);
+  bn_free(b);
+}
+
+/*
+  bn_buf_t*, size_t, size_t -> bool
+
+  make sure b can grow to int_len integer and frac_len fractional digits
+    without allocating
+
+  false is returned when memory is exhausted
+*/
+bool bn_buf_reserve (bn_buf_t* const b, const size_t int_len, const size_t frac_len) {
+  const size_t frac = b->len - b->int_len;
+  return bb_room(b, int_len > b->int_len ? int_len - b->int_len : 0, frac_len > frac ? frac_len - frac : 0);
+}
+
+/*
+  bn_buf_t*, atom_t*, size_t, size_t -> bool
+
+  replace the value of b with len base 10 digits, most significant first, of
+    which the first int_len are the integer part
+
+  false is returned when int_len is greater than len (errno is set to
+    EINVAL), or memory is exhausted, and b is unchanged
+*/
+bool bn_buf_set (bn_buf_t* const b, const atom_t* const digits, const size_t len, const size_t int_len) {
+  if (int_len > len || (len && NULL == digits)) {
+    errno = EINVAL;
+    return false;
+  }
+
+  if (len > b->cap) {
+    atom_t* const data = alloc(atom_t, len + BN_BUF_MIN_CAP);
+    if (NULL == data) { return false; }
+
+    bn_free(b->data);
+    b->data = data, b->cap = len + BN_BUF_MIN_CAP;
+  }
+
+  b->off     = (b->cap - len) / 2;
+  b->len     = len;
+  b->int_len = int_len;
+  if (len) { memcpy(bb_digits(b), digits, len); }
+
+  bb_trim(b);
+  return true;
+}
+
+/*
+  bn_buf_t*, atom_t*, size_t, size_t -> bool
+
+  add len base 10 digits, of which the first int_len are the integer part, to
+    b in place
+
+  false is returned when int_len is greater than len (errno is set to
+    EINVAL), or memory is exhausted, and b is unchanged
+*/
+bool bn_buf_add (bn_buf_t* const b, const atom_t* const digits, const size_t len, const size_t int_len) {
+  if (int_len > len || (len && NULL == digits)) {
+    errno = EINVAL;
+    return false;
+  }
+
+  /* one more in front for a carry out of the top */
+  if (! bn_buf_reserve(b, max(b->int_len, int_len) + 1, len - int_len)) { return false; }
+  bb_widen(b, int_len, len - int_len);
+
+  /* digit j of the addend lines up with this digit of b */
+  atom_t* const d = bb_digits(b) + (b->int_len - int_len);
+
+  atom_t carry = 0;
+  for (size_t j = len; j--; ) {
+    const atom_t sum = (atom_t) (d[j] + digits[j] + carry);
+    carry = sum >= DEC_BASE;
+    d[j]  = (atom_t) (carry ? sum - DEC_BASE : sum);
+  }
+
+  /* a carry runs up through nines, and onto a new digit if it leaves the top */
+  for (size_t i = b->int_len - int_len; carry && i--; ) {
+    carry = DEC_BASE - 1 == bb_digits(b)[i];
+    bb_digits(b)[i] = (atom_t) (carry ? 0 : bb_digits(b)[i] + 1);
+  }
+  if (carry) {
+    b->off--, b->len++, b->int_len++;
+    bb_digits(b)[0] = 1;
+  }
+
+  bb_trim(b);
+  return true;
+}
+
+/*
+  bn_buf_t*, atom_t*, size_t, size_t -> bool
+
+  take len base 10 digits, of which the first int_len are the integer part,
+    from b in place
+
+  false is returned, and b is unchanged, when int_len is greater than len
+    (errno is set to EINVAL), the difference would be negative (errno is set
+    to ERANGE), or memory is exhausted
+*/
+bool bn_buf_sub (bn_buf_t* const b, const atom_t* const digits, const size_t len, const size_t int_len) {
+  if (int_len > len || (len && NULL == digits)) {
+    errno = EINVAL;
+    return false;
+  }
+
+  if (cmp_view(bn_buf_view(b), bn_view_raw(digits, len, int_len, TYP_NONE)) < 0) {
+    errno = ERANGE;
+    return false;
+  }
+
+  if (! bb_widen(b, int_len, len - int_len)) { return false; }
+
+  atom_t* const d = bb_digits(b) + (b->int_len - int_len);
+
+  atom_t borrow = 0;
+  for (size_t j = len; j--; ) {
+    const atom_t take = (atom_t) (digits[j] + borrow);
+    borrow = d[j] < take;
+    d[j]   = (atom_t) (borrow ? d[j] + DEC_BASE - take : d[j] - take);
+  }
+
+  /* b is no smaller, so a borrow stops at a nonzero digit above */
+  for (size_t i = b->int_len - int_len; borrow && i--; ) {
+    borrow = 0 == bb_digits(b)[i];
+    bb_digits(b)[i] = (atom_t) (borrow ? DEC_BASE - 1 : bb_digits(b)[i] - 1);
+  }
+
+  bb_trim(b);
+  return true;
+}
+
+/*
+  bn_buf_t* -> bool
+
+  add 1 to b in place
+
+  false is returned, and b is unchanged, when memory is exhausted
+*/
+bool bn_buf_succ (bn_buf_t* const b) {
+  static const atom_t one[] = { 1 };
+  return bn_buf_add(b, one, 1, 1);
+}
+
+/*
+  bn_buf_t*, uint32_t -> bool
+
+  multiply b by m in place
+
+  false is returned, and b is unchanged, when memory is exhausted
+*/
+bool bn_buf_mul_small (bn_buf_t* const b, const uint32_t m) {
+  if (! m) {
+    b->len = b->int_len = 0;
+    return true;
+  }
+
+  /* m has at most 10 digits, which is all the product can gain */
+  if (! bn_buf_reserve(b, b->int_len + 10, 0)) { return false; }
+
+  atom_t* const d = bb_digits(b);
+  uint64_t carry = 0;
+  for (size_t j = b->len; j--; ) {
+    carry += (uint64_t) d[j] * m;
+    d[j]   = (atom_t) (carry % DEC_BASE);
+    carry /= DEC_BASE;
+  }
+
+  for (; carry; carry /= DEC_BASE) {
+    b->off--, b->len++, b->int_len++;
+    bb_digits(b)[0] = (atom_t) (carry % DEC_BASE);
+  }
+
+  bb_trim(b);
+  return true;
+}
+
+/*
+  bn_buf_t*, int64_t -> bool
+
+  multiply b by 10^places in place, by moving the separator: to the right
+    when places is positive, and to the left when it is negative; zeroes are
+    added where the separator passes the end of the digits
+
+  false is returned, and b is unchanged, when memory is exhausted
+*/
+bool bn_buf_shift (bn_buf_t* const b, const int64_t places) {
+  if (! b->len || ! places) { return true; }
+
+  const size_t frac = b->len - b->int_len;
+
+  if (places > 0) {
+    const size_t p = (size_t) places;
+    if (p > frac && ! bb_widen(b, 0, p)) { return false; }
+    b->int_len += p;
+  } else {
+    const size_t p = (size_t) -(places + 1) + 1;
+    if (p > b->int_len && ! bb_widen(b, p, 0)) { return false; }
+    b->int_len -= p;
+  }
+
+  bb_trim(b);
+  return true;
+}
+
+/*
+  bn_buf_t* -> bn_view_t
+
+  a base 10 view of b's digits (see bn_view.c), which is only good until b is
+    next changed
+*/
+bn_view_t bn_buf_view (const bn_buf_t* const b) {
+  return bn_view_raw(bb_digits(b), b->len, b->int_len, TYP_NONE);
+}
+
+/*
+  char*, size_t, bn_buf_t* -> size_t
+
+  write b's value as a base 10 string, like "123.45", into the caller's buffer
+    out, which has room for cap chars; a zero integer part is written as 0,
+    and there is no separator without a fractional part
+
+  the return value and cap behave as for b10_to_ldbl_digits_into
+*/
+size_t bn_buf_to_ldbl_digits_into (char* const out, const size_t cap, const bn_buf_t* const b) {
+  const size_t frac = b->len - b->int_len,
+               lead = b->int_len ? b->int_len : 1,
+               need = lead + (frac ? 1 + frac : 0);
+
+  if (NULL == out || cap <= need) { return need; }
+
+  out[0] = '0';
+  digits_to_chars(out + lead - b->int_len, bb_digits(b), b->int_len, false);
+  if (frac) {
+    out[lead] = DECIMAL_SEPARATOR_STR[0];
+    digits_to_chars(out + lead + 1, bb_digits(b) + b->int_len, frac, false);
+  }
+  out[need] = '\0';
+
+  return need;
+}
+
+#endif /* end of include guard: BN_BUF_H */
@@ -23,13 +23,17 @@
   b10 / b256: base 10, base 256
   zenz: base 256-related
   1b / 2b: one-byte and two-byte number interpretation
-  u16: a 16 bit integer type
+  u16 / u32: a 16 or 32 bit integer type
   u64: pertaining to a 64 bit integer type or non-float string representation
+  _z: a variant with size_t lengths, for arrays past 65535 digits (see TYP_HUGE)
   ldbl: long double; a real / floating representation
   frac / flot: decimal sub-1 part of a number (right of decimal separator)
   int: integral part of a number (left of decimal separator in ltr)
   samb: single address, multi byte (see addr_interp.c)
   digits: refers usually to a base 10 string or array represenation of a number value
+  pk: packed base 10, 19 digits to a 64 bit word (see TYP_PACK)
+  bcd: packed binary coded decimal, 2 digits to a byte (see TYP_BCD)
+  view: a digit array's header decoded once, with its data (see bn_view_t)
 */
 
 #ifndef BN_COMMON_H
@@ -39,6 +43,7 @@
 #include <string.h>
 #include <errno.h>
 #include <math.h>
+#include <float.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
@@ -48,9 +53,16 @@
 // size of the headers for each kind of array
 #define HEADER_OFFSET     ((atom_t) 4)
 #define HEADER_OFFSET_BIG ((atom_t) 6)
+#define HEADER_OFFSET_HUGE ((atom_t) 10)
+#define HEADER_OFFSET_COMPACT ((atom_t) 2)
+#define HEADER_OFFSET_SHORT   ((atom_t) 1)
 
 #define DEC_BASE    10
 #define ZENZ_BASE   256
+
+// base 10 digits in each word of a packed array, and the base of the words
+#define PK_DIGITS   19
+#define PK_BASE     ((uint64_t) 10000000000000000000U)
 #define COMPARE_EPS 1e-11 // (default) epsilon for fp comparisons
 #define CHAR_DIGIT_DIFF ((uint8_t) 48) // difference between character #0 and the character '0'
 
@@ -84,6 +96,12 @@
   #define MAX_STR_LDBL_DIGITS 10000
 #endif
 
+/* the most digits a numeric literal is laid out to, zeroes from its exponent and all, before
+  it is refused with ERANGE; "1e999999999" would otherwise be a gigabyte of zeroes */
+#ifndef NUMLIT_MAX_DIGITS
+  #define NUMLIT_MAX_DIGITS ((size_t) 1 << 24)
+#endif
+
 #ifndef DECIMAL_SEPARATOR_STR
   #define DECIMAL_SEPARATOR_STR "."
 #endif
@@ -96,17 +114,58 @@
   #pragma message("preferring slower O(n) char operations over O(1) floating point math")
 #endif
 
+/*
+  vector instruction sets available to the character <-> digit kernels (simd_conv.c)
+  define NO_SIMD to use only the portable SWAR kernels
+*/
+#ifndef NO_SIMD
+  #if defined(__AVX2__)
+    #define BN_HAVE_AVX2
+  #endif
+  #if defined(__SSSE3__)
+    #define BN_HAVE_SSSE3
+  #endif
+  #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define BN_HAVE_SSE2
+  #endif
+#endif /* NO_SIMD */
+
+/* read(2), for streaming from file descriptors */
+#if defined(__unix__) || defined(__APPLE__)
+  #include <unistd.h>
+  #define BN_HAVE_POSIX
+#endif
+
+#if defined(BN_HAVE_AVX2) || defined(BN_HAVE_SSSE3)
+  #include <immintrin.h>
+#elif defined(BN_HAVE_SSE2)
+  #include <emmintrin.h>
+#endif
+
 /* TYPEDEFS */
 
 typedef long double ldbl_t;
 typedef uint8_t     atom_t;
 
+/* words for exact binary arithmetic (limb_math.c), and their double width */
+typedef uint32_t limb_t;
+typedef uint64_t dlimb_t;
+#define LIMB_BITS 32
+
+/* room for the longest compact array (2 header bytes and 15 + 15 digits), which is the most a bignum_t keeps inside it */
+#define BN_INLINE_LEN 32
+/* where the parts of a bignum_t's block start, from the start of the block */
+#define BIGNUM_ALIGN 16
+
 typedef struct st_bignum_t {
 
   /*
 
   TYPE, INT LEN, FRAC LEN, FLAGS, DATA...
   TYPE, INT LEN 1, INT LEN 2, FRAC LEN 1, FRAC LEN 2, FLAGS, DATA... (big)
+  TYPE, INT LEN 1 ... INT LEN 4, FRAC LEN 1 ... FRAC LEN 4, FLAGS, DATA... (huge)
+  TYPE + FLAGS, INT LEN << 4 | FRAC LEN, DATA... (compact)
+  TYPE + INT LEN, DATA... (compact, short)
 
 
     array + 0 = the type of this array
@@ -116,12 +175,17 @@ typedef struct st_bignum_t {
         two-byte addressing scheme. in the following array:
         { TYP_BIG, 0, 2, 0, 1, FL_NONE, 1, 2, 1 }
         the BIG flag is set, and four total bytes (2 for the integral, 2 for the
-        fractional, in little endian order) are reserved for describing the length of
+        fractional, most significant byte first) are reserved for describing the length of
         the array. these value pairs can be interpreted by the functions
         u16_to_twoba (uint16_t to two byte address) and twoba_to_u16 (two byte
         address to uint16_t).
-        if the type byte does not share bits with TYP_BIG, then a standard
-        single-byte addressing mode is in use.
+        if the type byte does not share bits with TYP_BIG or TYP_HUGE, then a
+        standard single-byte addressing mode is in use.
+
+      if the type byte & TYP_HUGE is true, the array is huge, and each length
+        takes four bytes, most significant first, for up to UINT32_MAX digits in
+        either part (see samb_u32_to_fourba and samb_fourarray_to_u32). TYP_HUGE
+        takes precedence over TYP_BIG, so setting both makes a huge array.
         !! the type of the first array in a struct does not determine the type of
         the second extension array; each has its own metadata.
 
@@ -131,17 +195,73 @@ typedef struct st_bignum_t {
         using all 8 bits of each array element.
         it would take 3 full base 10 bytes (each only using the first two bits) to
         represent the value 255, but only one base 256 byte, using all 8 bits.
+
+      if the type byte & TYP_PACK is true, then the data elements are 64 bit
+        words in base 10^19, each holding 19 base 10 digits, and the lengths in
+        the header count words rather than bytes. each word is 8 bytes, most
+        significant first like the lengths; the words are most significant
+        first too, and grouped away from the separator, so 12.5 is the words
+        12 and 5 * 10^18.
+        TYP_PACK and TYP_ZENZ are not combined.
+
+      if the type byte & TYP_BCD is true, then each data element is a byte of
+        packed BCD, holding two base 10 digits (the first in the high nibble),
+        and the lengths in the header count bytes. the bytes are grouped away
+        from the separator as with TYP_PACK, so 123.4 is 0x01 0x23 0x40.
+        TYP_BCD is not combined with TYP_ZENZ or TYP_PACK.
+
+      if the type byte & TYP_COMPACT is true, the header is one or two bytes,
+        for the many numbers with only a few digits. TYP_BIG, TYP_OVERF,
+        TYP_EXTN and TYP_HUGE mean nothing to so small an array, so their bits
+        are reused, and TYP_ZENZ, TYP_PACK and TYP_BCD keep their meanings:
+        the bits 0x01, 0x04 and 0x08 hold a three bit value (see
+        meta_cmp_value), and 0x40 (CMP_SHORT) picks what it is.
+        without CMP_SHORT, the value is the flags, and the second byte holds
+        the integer length in its high nibble and the fractional length in
+        its low nibble, so 12.5 is { TYP_COMPACT, 0x21, 1, 2, 5 }.
+        with CMP_SHORT, the array is a non-negative integer, with no flags and
+        no fractional part, and the value is its length; there is no second
+        byte, so 12 is { TYP_COMPACT | CMP_SHORT | 0x04, 1, 2 }.
+        make_array_header picks the short form whenever it fits, so the
+        header's length is known from its first byte, but not from the
+        metadata that was asked for.
+        compact arrays are not chained (see TYP_OVERF).
+  */
+
+  /*
+    a main value which fits a compact array (see TYP_COMPACT) is kept in inl,
+      inside the structure, and value is NULL; only one which outgrows it is
+      a separate array, so read it with bignum_value rather than value.
+      the other parts are NULL when they are not there.
+
+    a bignum_t from bignum_ctor or bignum_copy is one block of size atoms:
+      the structure, then the parts it has, each at a multiple of
+      BIGNUM_ALIGN, with the exponent's block last; so it is freed all at
+      once, and copied with one memcpy (see bignum.c)
   */
 
   atom_t
-    * value, // the main value
+    * value, // the main value, or NULL when it is in inl
     * imgry, // imaginary part
     * fracl, // fractional part (numerator / denom)
     * vextn; // reference this if (...) the first is determined to possibly by filled up
   struct st_bignum_t* expt;
+  size_t size; // atoms used by the block this heads, parts included
+
+  atom_t inl[BN_INLINE_LEN];
 
 } bignum_t;
 
+/* a shared digit array (see bn_ref.c), followed by the array itself */
+typedef struct {
+  size_t refs; // how many hold it, changed atomically
+  size_t len;  // atoms in the array
+} bn_ref_t;
+
+/* the main value of a bignum_t, wherever it is kept */
+#define bignum_value(bn) (NULL == (bn)->value ? (bn)->inl : (bn)->value)
+#define bignum_is_inline(bn) (NULL == (bn)->value)
+
 // highest value for these bases. self-explanatory but erase magic numbers
 #define B256_HIGH 0x100
 #define B10_HIGH  0xA
@@ -153,6 +273,16 @@ typedef struct st_bignum_t {
 #define TYP_ZENZ  0x02 /* array uses base 256 rather than base 10 (from the word zenzizenzizenzic) */
 #define TYP_OVERF 0x04 /* this array's intended value would overflow this array; combine its data with another */
 #define TYP_EXTN  0x08 /* this array is the extension of another array whose value is overflowed (see TYP_OVERF) */
+#define TYP_PACK  0x10 /* array uses base 10^19 in 64 bit words (packed decimal, see pack10.c) */
+#define TYP_BCD   0x20 /* array uses two base 10 digits to a byte (packed BCD, see bcd.c) */
+#define TYP_HUGE  0x40 /* this array is huge (4 byte addressing mode) */
+#define TYP_COMPACT 0x80 /* this array's lengths and flags are packed into a 1 or 2 byte header */
+
+/* with TYP_COMPACT, the reused bit for a 1 byte header holding just the integer length */
+#define CMP_SHORT   0x40
+/* with TYP_COMPACT, the longest part the header can describe, and the longest short integer */
+#define CMP_MAX_LEN   15
+#define CMP_SHORT_LEN 7
 
 /*
   these apply to number values themselves, and can be composed, such that
@@ -173,30 +303,61 @@ typedef struct st_bignum_t {
 */
 // whether this metadata indicates base 256
 #define    meta_is_base256(metadata) (metadata & TYP_ZENZ)
+// whether this metadata indicates packed base 10^19 words
+#define     meta_is_packed(metadata) (metadata & TYP_PACK)
+// whether this metadata indicates packed BCD bytes
+#define        meta_is_bcd(metadata) (metadata & TYP_BCD)
+// whether this metadata indicates the compact, one or two byte header
+#define    meta_is_compact(metadata) ((metadata) & TYP_COMPACT)
+// whether this metadata indicates the short, one byte compact header
+#define      meta_is_short(metadata) (((metadata) & (TYP_COMPACT | CMP_SHORT)) == (TYP_COMPACT | CMP_SHORT))
 // whether this metadata indicates the big, two byte addressing mode for the array
-#define        meta_is_big(metadata) (metadata & TYP_BIG)
+#define        meta_is_big(metadata) (((metadata) & (TYP_BIG | TYP_COMPACT)) == TYP_BIG)
+// whether this metadata indicates the huge, four byte addressing mode
+#define       meta_is_huge(metadata) (((metadata) & (TYP_HUGE | TYP_COMPACT)) == TYP_HUGE)
 // the size of the header offset for the encompassing array
-#define meta_header_offset(metadata) (meta_is_big(metadata) ? HEADER_OFFSET_BIG : HEADER_OFFSET)
+#define meta_header_offset(metadata) (meta_is_compact(metadata) ? (meta_is_short(metadata) ? HEADER_OFFSET_SHORT : HEADER_OFFSET_COMPACT) \
+  : meta_is_huge(metadata) ? HEADER_OFFSET_HUGE : meta_is_big(metadata) ? HEADER_OFFSET_BIG : HEADER_OFFSET)
+// the longest integer or fractional part the header can describe
+#define       meta_max_len(metadata) ((size_t) (meta_is_compact(metadata) ? CMP_MAX_LEN \
+  : meta_is_huge(metadata) ? UINT32_MAX : meta_is_big(metadata) ? UINT16_MAX : UINT8_MAX))
+// the three bit value kept in the reused bits of a compact type byte, and the bits for one
+#define     meta_cmp_value(metadata) ((atom_t) (((metadata) & 0x01) | (((metadata) >> 1) & 0x06)))
+#define      cmp_value_bits(value)   ((atom_t) (((value) & 0x01) | (((value) & 0x06) << 1)))
 
 /*
   the following are about big num arrays themselves, not any particular byte
 */
 // whether this array is base 256
 #define    bna_is_base256(bna) (meta_is_base256(bna[0]))
+// whether it is packed
+#define     bna_is_packed(bna) (meta_is_packed(bna[0]))
+// whether it is packed BCD
+#define        bna_is_bcd(bna) (meta_is_bcd(bna[0]))
 // whether it is big
 #define        bna_is_big(bna) (meta_is_big(bna[0]))
+// whether it is huge
+#define       bna_is_huge(bna) (meta_is_huge(bna[0]))
+// whether it has a compact header
+#define    bna_is_compact(bna) (meta_is_compact(bna[0]))
 // the size of the header offset
 #define bna_header_offset(bna) (meta_header_offset(bna[0]))
 // the "real length" of the constituent parts of this array
 #define      bna_real_len(bna) (bna_int_len(bna) + bna_frac_len(bna) + bna_header_offset(bna))
+// the atoms the whole array takes, which bna_real_len does not give for a packed array
+#define          bna_size(bna) (bna_header_offset(bna) + (size_t) (bna_int_len(bna) + bna_frac_len(bna)) * (bna_is_packed(bna) ? sizeof (uint64_t) : 1U))
 // the flags set for this array
-#define         bna_flags(bna) ((bna)[bna_header_offset((bna)) - 1])
+#define         bna_flags(bna) ( (atom_t) (bna_is_compact(bna) ? (meta_is_short((bna)[0]) ? FL_NONE : meta_cmp_value((bna)[0])) \
+  : (bna)[bna_header_offset((bna)) - 1]) )
 uint16_t samb_twoarray_to_u16 (const atom_t arr[2]);
+uint32_t samb_fourarray_to_u32 (const atom_t* const arr);
 
 // the length of the integer part
-#define       bna_int_len(bna) ( bna_is_big(bna) ? samb_twoarray_to_u16((bna) + 1) : (bna)[1] )
+#define       bna_int_len(bna) ( bna_is_compact(bna) ? (meta_is_short((bna)[0]) ? meta_cmp_value((bna)[0]) : (atom_t) ((bna)[1] >> 4)) \
+  : bna_is_huge(bna) ? samb_fourarray_to_u32((bna) + 1) : bna_is_big(bna) ? samb_twoarray_to_u16((bna) + 1) : (bna)[1] )
 // the length of the fractional part
-#define      bna_frac_len(bna) ( bna_is_big(bna) ? samb_twoarray_to_u16((bna) + 3) : (bna)[2] )
+#define      bna_frac_len(bna) ( bna_is_compact(bna) ? (meta_is_short((bna)[0]) ? 0 : (atom_t) ((bna)[1] & 0x0F)) \
+  : bna_is_huge(bna) ? samb_fourarray_to_u32((bna) + 5) : bna_is_big(bna) ? samb_twoarray_to_u16((bna) + 3) : (bna)[2] )
 
 #define  bna_new_1b_10_u64(value, flags) to_digit_array(0, value, flags, TYP_NONE)
 #define bna_new_1b_256_u64(value, flags) to_digit_array(0, value, flags, TYP_ZENZ)
@@ -216,10 +377,23 @@ uint16_t samb_twoarray_to_u16 (const atom_t arr[2]);
 
 // multiplies a size by the size of the typename to get the size of a space
 #define        sz(type, n) ( ((size_t) n) * (sizeof (type)) )
-// allocates, but does not clean -- a shorthand for writing malloc(n * sizeof(type))
-#define  alloc(type, size) ((type*) malloc(( (size_t) size) * sizeof (type)))
-// same, but cleans (zeroes) the bytes with calloc
-#define zalloc(type, size) ((type*) calloc(( (size_t) size),  sizeof (type)))
+// allocates, but does not clean -- a shorthand for writing bn_malloc(n * sizeof(type)) (see bn_set_allocator)
+#define  alloc(type, size) ((type*) bn_malloc(( (size_t) size) * sizeof (type)))
+// same, but cleans (zeroes) the bytes, as bn_calloc
+#define zalloc(type, size) ((type*) bn_calloc(( (size_t) size),  sizeof (type)))
+// scratch space for temporaries, given back by scratch_reset rather than bn_free (see scratch.c)
+#define  salloc(type, size) ((type*) scratch_alloc(( (size_t) size) * sizeof (type)))
+// same, but zeroed
+#define zsalloc(type, size) ((type*) scratch_zalloc(( (size_t) size) * sizeof (type)))
+
+// storage for each thread, in C11 or C++
+#ifndef BN_THREAD_LOCAL
+  #ifdef __cplusplus
+    #define BN_THREAD_LOCAL thread_local
+  #else
+    #define BN_THREAD_LOCAL _Thread_local
+  #endif
+#endif
 #define     macrogetval(x) #x
 #define       stringify(x) macrogetval(x)
 
@@ -255,6 +429,23 @@ uint16_t samb_twoarray_to_u16 (const atom_t arr[2]);
   #define max(a, b) (a > b ? a : b)
 #endif
 
+/*
+  the functions the library allocates with (see allocator.c), each given ctx
+    as its last argument; the defaults are malloc, realloc and free
+*/
+typedef struct {
+  void* (*malloc_fn)  (const size_t size, void* const ctx);
+  void* (*realloc_fn) (void* const ptr, const size_t size, void* const ctx);
+  void  (*free_fn)    (void* const ptr, void* const ctx);
+  void*   ctx;
+} bn_allocator_t;
+
+/* how far into its scratch space a thread is (see scratch_mark) */
+typedef struct {
+  size_t block;
+  size_t used;
+} scratch_mark_t;
+
 /* individual values */
 typedef enum {
   BN_NONE = 0,
@@ -268,6 +459,116 @@ typedef enum {
 
 } bignum_flag_t;
 
+/*
+  an incremental parser for a number given in pieces (see digit_stream.c)
+
+  the digits are kept in base 10 as they arrive, and a base 256 array is
+    converted from them at the end, all at once
+*/
+typedef struct {
+  atom_t* digits;    /* base 10 digit values, most significant first */
+  size_t  len;       /* all the digits in digits */
+  size_t  int_len;   /* how many of them are before the separator */
+  size_t  cap;
+
+  atom_t  metadata;  /* of the array to make */
+  atom_t  flags;     /* FL_SIGN, from a leading '-' */
+  atom_t  state;     /* where in the number the next character is */
+  bool    any_digits;
+} digit_stream_t;
+
+/*
+  a base 10 number kept as a chain of fixed-size digit arrays (see
+    digit_chain.c), so that growing it never copies what is already there
+
+  every chunk holds DIGIT_CHAIN_DIGITS digits and is aligned to the
+    separator: chunk place p holds the digits for 10^(p * DIGIT_CHAIN_DIGITS)
+    up to 10^((p + 1) * DIGIT_CHAIN_DIGITS - 1), most significant first, and is
+    flagged TYP_OVERF when a less significant chunk follows it, and TYP_EXTN
+    when it follows a more significant one
+*/
+typedef struct {
+  atom_t** chunks;   /* least significant first */
+  size_t   nchunks;
+  size_t   cap;
+  int64_t  low;      /* the place of chunks[0] */
+} digit_chain_t;
+
+/*
+  a base 10 number that is changed in place (see bn_buf.c), with spare room
+    around its digits so that it can grow at either end without being copied
+*/
+typedef struct {
+  atom_t* data;
+  size_t  cap;
+  size_t  off;       /* where the first digit is in data */
+  size_t  len;       /* all the digits, most significant first */
+  size_t  int_len;   /* how many of them are before the separator */
+} bn_buf_t;
+
+/*
+  a scanned numeric literal (see scan_numlit): where its parts are in the
+    characters that were scanned, which it does not own
+*/
+typedef struct {
+  const char* int_digits;   /* the digits before the separator */
+  size_t      int_len;
+  const char* frac_digits;  /* and after it, or NULL */
+  size_t      frac_len;
+  int32_t     exp;          /* the power of 10 after an e or E, or 0 */
+  atom_t      flags;        /* FL_SIGN, from a leading '-' */
+  bool        has_sign;     /* whether there was a '-' or '+' */
+  bool        has_sep;      /* whether there was a separator */
+  bool        has_exp;      /* whether there was an exponent */
+} numlit_t;
+
+/*
+  a digit array's header decoded once, and the data after it (see bn_view.c);
+    the lengths count the elements of the base: digits, 64 bit words with
+    TYP_PACK, or bytes of two digits with TYP_BCD
+
+  a view does not own its data, and is passed by value
+*/
+typedef struct {
+  const atom_t* data;      /* the first element after the header */
+  size_t        int_len;   /* elements before the separator */
+  size_t        frac_len;  /* and after it */
+  atom_t        base;      /* TYP_NONE, TYP_ZENZ, TYP_PACK or TYP_BCD */
+  atom_t        flags;
+} bn_view_t;
+
+// the number of elements in a view
+#define       view_len(v) ((v).int_len + (v).frac_len)
+// the bytes in each of its elements
+#define view_elem_size(v) ((size_t) (TYP_PACK == (v).base ? sizeof (uint64_t) : 1U))
+
+/* allocator: where the library's memory comes from */
+bool           bn_set_allocator (const bn_allocator_t* const a);
+bn_allocator_t bn_get_allocator (void);
+void*                 bn_malloc (const size_t size);
+void*                 bn_calloc (const size_t n, const size_t size);
+void*                bn_realloc (void* const ptr, const size_t size);
+void                    bn_free (void* const ptr);
+
+/* bn_ref: shared, copy on write digit arrays */
+bn_ref_t*         bn_ref_new (const atom_t* const bna);
+bn_ref_t*       bn_ref_share (bn_ref_t* const ref);
+void          bn_ref_release (bn_ref_t* const ref);
+const atom_t*  bn_ref_digits (const bn_ref_t* const ref);
+size_t          bn_ref_count (const bn_ref_t* const ref);
+atom_t*           bn_ref_mut (bn_ref_t** const ref);
+
+/* pool: an allocator with per-thread lists of freed blocks */
+bn_allocator_t bn_pool_allocator (void);
+void              bn_pool_release (void);
+
+/* scratch: a per-thread stack for the temporaries of an operation */
+scratch_mark_t scratch_mark (void);
+void          scratch_reset (const scratch_mark_t mark);
+void*         scratch_alloc (const size_t bytes);
+void*        scratch_zalloc (const size_t bytes);
+void     bn_scratch_release (void);
+
 /* misc_util */
 float                log256f (const float x);
 bool             compare_eps (const ldbl_t a, const ldbl_t b, const ldbl_t eps);
@@ -278,7 +579,7 @@ uint16_t count_b256_digits_b10_digits (const char* const digits);
 atom_t    get_left_nth_digit (const uint64_t x, const atom_t n);
 atom_t     count_frac_digits (const char* const str);
 atom_t   find_frac_beginning (const char* const str);
-bool             raw_is_zero (const atom_t* const digits, const uint16_t len);
+bool             raw_is_zero (const atom_t* const digits, const size_t len);
 
 size_t        strnlen_c (const char* const s, const size_t maxsize);
 char*         strndup_c (const char* const s, size_t const n);
@@ -301,7 +602,8 @@ uint16_t array_span (const atom_t* arr, const uint16_t arr_len, const bool accep
 
 bool   array_contains (const atom_t* const arr, const uint16_t len, const atom_t value);
 atom_t*  array_concat (const atom_t* const a, const uint16_t a_len, const atom_t* const b, const uint16_t b_len);
-atom_t* array_reverse (const atom_t* const arr, const uint16_t len);
+atom_t* array_reverse (const atom_t* const arr, const size_t len);
+void    array_reverse_in_place (atom_t* const arr, const size_t len);
 atom_t*    array_copy (const atom_t* const a, const uint16_t len);
 
 atom_t*         array_trim_leading_zeroes (const atom_t* const bn);
@@ -310,38 +612,201 @@ atom_t* array_trim_trailing_zeroes_simple (const atom_t* const bn, const uint16_
 atom_t*  array_trim_leading_zeroes_simple (const atom_t* const bn, const uint16_t len, uint16_t* const out_len);
 
 
+/* simd_conv */
+bool chars_to_digits (atom_t* const dst, const char* const src, const size_t n, const bool reverse);
+void digits_to_chars (char* const dst, const atom_t* const src, const size_t n, const bool reverse);
+size_t    digit_span (const char* const src, const size_t n);
+
+/* numlit: one pass to validate a number's characters and find its parts */
+bool      scan_numlit (numlit_t* const lit, const char* const src, const size_t n);
+size_t  numlit_layout (const numlit_t* const lit, size_t* const lead, size_t* const trail, size_t* const int_len);
+size_t  numlit_to_b10 (atom_t* const out, const numlit_t* const lit, const bool reverse);
+
+/* limb_math: little endian base 2^32 integers, for exact conversions */
+size_t  limb_normalize (const limb_t* const a, const size_t len);
+int           limb_cmp (const limb_t* const a, const size_t a_len, const limb_t* const b, const size_t b_len);
+size_t        limb_add (limb_t* const r, const limb_t* const a, const size_t a_len, const limb_t* const b, const size_t b_len);
+size_t        limb_sub (limb_t* const r, const limb_t* const a, const size_t a_len, const limb_t* const b, const size_t b_len);
+size_t  limb_mul_small (limb_t* const a, const size_t len, const limb_t m, const limb_t add);
+limb_t limb_divmod_small (limb_t* const a, const size_t len, const limb_t d, size_t* const out_len);
+size_t  limb_mul_pow10 (limb_t* const a, const size_t len, const uint32_t exp);
+size_t   limb_mul_pow5 (limb_t* const a, const size_t len, const uint32_t exp);
+size_t        limb_shl (limb_t* const r, const limb_t* const a, const size_t len, const size_t bits);
+size_t        limb_shr (limb_t* const r, const limb_t* const a, const size_t len, const size_t bits);
+size_t limb_bit_length (const limb_t* const a, const size_t len);
+bool     limb_test_bit (const limb_t* const a, const size_t len, const size_t bit);
+size_t        limb_mul (limb_t* const r, const limb_t* const a, const size_t a_len, const limb_t* const b, const size_t b_len);
+size_t limb_reciprocal (limb_t* const v, const limb_t* const d, const size_t d_len);
+size_t limb_div_reciprocal (limb_t* const q, limb_t* const r, size_t* const r_len, const limb_t* const n, const size_t n_len, const limb_t* const d, const size_t d_len, const limb_t* const v, const size_t v_len);
+size_t        limb_div (limb_t* const q, const limb_t* const n, const size_t n_len, const limb_t* const d, const size_t d_len);
+size_t       limb_pow5 (limb_t* const r, const size_t exp);
+
+/* pack10: base 10 digits, 19 to a 64 bit word */
+uint64_t              pk_load (const atom_t* const p);
+void                 pk_store (atom_t* const p, const uint64_t w);
+size_t         count_pk_limbs (const size_t len);
+size_t              b10_to_pk (uint64_t* const out, const atom_t* const digits, const size_t len, const size_t int_len, size_t* const out_int_len);
+size_t              pk_to_b10 (atom_t* const out, const uint64_t* const limbs, const size_t len, const size_t int_len, size_t* const out_int_len);
+uint64_t*              add_pk (const uint64_t* const a, const size_t a_len, const size_t a_int_len, const uint64_t* const b, const size_t b_len, const size_t b_int_len, size_t* const out_len, size_t* const out_int_len);
+uint64_t*              sub_pk (const uint64_t* const a, const size_t a_len, const size_t a_int_len, const uint64_t* const b, const size_t b_len, const size_t b_int_len, size_t* const out_len, size_t* const out_int_len);
+uint64_t*              mul_pk (const uint64_t* const a, const size_t a_len, const size_t a_int_len, const uint64_t* const b, const size_t b_len, const size_t b_int_len, size_t* const out_len, size_t* const out_int_len);
+atom_t*       b10_to_pk_array (const atom_t* const digits, const size_t len, const size_t int_len, const atom_t metadata, const atom_t flags);
+size_t   b10_to_pk_array_into (atom_t* const out, const size_t cap, const atom_t* const digits, const size_t len, const size_t int_len, const atom_t metadata, const atom_t flags);
+atom_t* b10_array_to_pk_array (const atom_t* const bna, const atom_t metadata);
+atom_t* pk_array_to_b10_array (const atom_t* const pna);
+
+/* bcd: base 10 digits, 2 to a byte */
+size_t        count_bcd_bytes (const size_t len);
+size_t             b10_to_bcd (atom_t* const out, const atom_t* const digits, const size_t len, const size_t int_len, size_t* const out_int_len);
+size_t             bcd_to_b10 (atom_t* const out, const atom_t* const bytes, const size_t len, const size_t int_len, size_t* const out_int_len);
+atom_t                bcd_add (atom_t* const r, const atom_t* const a, const atom_t* const b, const size_t n);
+int                   bcd_cmp (const atom_t* const a, const atom_t* const b, const size_t n);
+atom_t*               add_bcd (const atom_t* const a, const size_t a_len, const size_t a_int_len, const atom_t* const b, const size_t b_len, const size_t b_int_len, size_t* const out_len, size_t* const out_int_len);
+int                   cmp_bcd (const atom_t* const a, const size_t a_len, const size_t a_int_len, const atom_t* const b, const size_t b_len, const size_t b_int_len);
+atom_t*      b10_to_bcd_array (const atom_t* const digits, const size_t len, const size_t int_len, const atom_t metadata, const atom_t flags);
+size_t  b10_to_bcd_array_into (atom_t* const out, const size_t cap, const atom_t* const digits, const size_t len, const size_t int_len, const atom_t metadata, const atom_t flags);
+atom_t* b10_array_to_bcd_array (const atom_t* const bna, const atom_t metadata);
+atom_t* bcd_array_to_b10_array (const atom_t* const bcd);
+
+/* bn_buf: base 10 numbers changed in place */
+bn_buf_t*              bn_buf_new (const size_t cap);
+void                  bn_buf_free (bn_buf_t* const b);
+bool               bn_buf_reserve (bn_buf_t* const b, const size_t int_len, const size_t frac_len);
+bool                   bn_buf_set (bn_buf_t* const b, const atom_t* const digits, const size_t len, const size_t int_len);
+bool                   bn_buf_add (bn_buf_t* const b, const atom_t* const digits, const size_t len, const size_t int_len);
+bool                   bn_buf_sub (bn_buf_t* const b, const atom_t* const digits, const size_t len, const size_t int_len);
+bool                  bn_buf_succ (bn_buf_t* const b);
+bool             bn_buf_mul_small (bn_buf_t* const b, const uint32_t m);
+bool                 bn_buf_shift (bn_buf_t* const b, const int64_t places);
+bn_view_t             bn_buf_view (const bn_buf_t* const b);
+size_t bn_buf_to_ldbl_digits_into (char* const out, const size_t cap, const bn_buf_t* const b);
+
+/* bn_view: headers decoded once, and math on what they describe */
+bn_view_t              bn_view (const atom_t* const bna);
+bn_view_t          bn_view_raw (const atom_t* const data, const size_t len, const size_t int_len, const atom_t metadata);
+bn_view_t        view_int_part (const bn_view_t v);
+bn_view_t       view_frac_part (const bn_view_t v);
+atom_t*            view_to_b10 (const bn_view_t v, size_t* const len, size_t* const int_len);
+char*      view_to_ldbl_digits (const bn_view_t v);
+uint64_t          view_elem_le (const bn_view_t v, const size_t i);
+int                   cmp_view (const bn_view_t a, const bn_view_t b);
+atom_t*               add_view (const bn_view_t a, const bn_view_t b, bn_view_t* const out);
+atom_t*               sub_view (const bn_view_t a, const bn_view_t b, bn_view_t* const out);
+atom_t*               mul_view (const bn_view_t a, const bn_view_t b, bn_view_t* const out);
+
+/* ldbl_conv: exact hardware float <-> digits */
+atom_t ldbl_to_shortest_digits (const ldbl_t ldbl, atom_t* const digits, int32_t* const dec_exp);
+atom_t  dbl_to_shortest_digits (const double dbl,  atom_t* const digits, int32_t* const dec_exp);
+ldbl_t             b10_to_ldbl (const atom_t* const digits, const size_t len, const size_t int_len);
+double              b10_to_dbl (const atom_t* const digits, const size_t len, const size_t int_len);
+ldbl_t            b256_to_ldbl (const atom_t* const digits, const size_t len, const size_t int_len);
+double             b256_to_dbl (const atom_t* const digits, const size_t len, const size_t int_len);
+ldbl_t     digit_array_to_ldbl (const atom_t* const bna);
+double      digit_array_to_dbl (const atom_t* const bna);
+ldbl_t            view_to_ldbl (const bn_view_t v);
+double             view_to_dbl (const bn_view_t v);
+
+/* digit_stream: parsing numbers from pieces, with no length limit */
+digit_stream_t* digit_stream_new (const atom_t metadata);
+void           digit_stream_free (digit_stream_t* const ds);
+bool           digit_stream_feed (digit_stream_t* const ds, const char* const chunk, const size_t n);
+bool      digit_stream_read_file (digit_stream_t* const ds, FILE* const file);
+#ifdef BN_HAVE_POSIX
+bool        digit_stream_read_fd (digit_stream_t* const ds, const int fd);
+#endif
+atom_t*         digit_stream_raw (digit_stream_t* const ds, size_t* const len, size_t* const int_len);
+atom_t*      digit_stream_finish (digit_stream_t* const ds);
+
+/* digit_chain: base 10 numbers in fixed-size chunks, which grow in place */
+digit_chain_t*    digit_chain_new (void);
+void             digit_chain_free (digit_chain_t* const dc);
+bool              digit_chain_add (digit_chain_t* const dc, const atom_t* const digits, const size_t len, const size_t int_len);
+atom_t*           digit_chain_raw (const digit_chain_t* const dc, size_t* const len, size_t* const int_len);
+size_t digit_chain_to_ldbl_digits_into (char* const out, const size_t cap, const digit_chain_t* const dc);
+atom_t*      digit_chain_to_array (const digit_chain_t* const dc, const atom_t metadata, const atom_t flags);
+
 /* bignum_t */
 bignum_t* bignum_ctor (const ldbl_t ldbl, const uint64_t u64, const atom_t flags, const bignum_t * const * const opt_vals);
 bignum_t* bignum_copy (const bignum_t* const bn, const bool no_recurse_optionals);
+void      bignum_free (bignum_t* const bn);
 
 /* array creation */
-atom_t* make_array_header (const atom_t metadata, const uint16_t int_digits, const uint16_t flot_digits, const atom_t flags);
+atom_t* make_array_header (const atom_t metadata, const size_t int_digits, const size_t flot_digits, const atom_t flags);
+size_t  make_array_header_into (atom_t* const out, const size_t cap, const atom_t metadata, const size_t int_digits, const size_t flot_digits, const atom_t flags);
 atom_t* to_digit_array (const ldbl_t ldbl_in, const uint64_t u64, const atom_t value_flags, const atom_t metadata);
+size_t  to_digit_array_into (atom_t* const out, const size_t cap, const ldbl_t ldbl_in, const uint64_t u64, const atom_t value_flags, const atom_t metadata);
+atom_t* dbl_to_digit_array (const double dbl, const atom_t value_flags, const atom_t metadata);
+size_t  dbl_to_digit_array_into (atom_t* const out, const size_t cap, const double dbl, const atom_t value_flags, const atom_t metadata);
+atom_t* str_to_digit_array (const char* const str, const size_t n, const atom_t metadata);
+size_t  str_to_digit_array_into (atom_t* const out, const size_t cap, const char* const str, const size_t n, const atom_t metadata);
 
-/* 2 byte addressing stuff */
+/* 2 and 4 byte addressing stuff */
 void        samb_u16_to_twoba (const uint16_t n, atom_t* const ah, atom_t* const al);
 uint16_t    samb_twoba_to_u16 (const atom_t ah, const atom_t al);
+void       samb_u32_to_fourba (const uint32_t n, atom_t* const arr);
 //uint16_t samb_twoarray_to_u16 (const atom_t arr[static 2]);
 
 /* these are raw atom_t arrays, not bignum structures */
 
 /* base 10 conversions */
-char*   b10_to_ldbl_digits (const atom_t* const digits, const uint16_t len, const uint16_t int_len);
-char*    b10_to_u64_digits (const atom_t* const digits, const uint16_t len);
-uint64_t        b10_to_u64 (const atom_t* const digits, const uint16_t len);
+char*   b10_to_ldbl_digits (const atom_t* const digits, const size_t len, const size_t int_len);
+char*    b10_to_u64_digits (const atom_t* const digits, const size_t len);
+size_t b10_to_ldbl_digits_into (char* const out, const size_t cap, const atom_t* const digits, const size_t len, const size_t int_len);
+size_t  b10_to_u64_digits_into (char* const out, const size_t cap, const atom_t* const digits, const size_t len);
+uint64_t        b10_to_u64 (const atom_t* const digits, const size_t len);
 atom_t* ldbl_digits_to_b10 (const char* const ldbl_digits, uint16_t* const len, uint16_t* const int_len, const bool little_endian);
+atom_t* ldbl_digits_to_b10_n (const char* const ldbl_digits, const size_t n, uint16_t* const len, uint16_t* const int_len, const bool little_endian);
+atom_t* ldbl_digits_to_b10_z (const char* const ldbl_digits, const size_t n, size_t* const len, size_t* const int_len, const bool little_endian);
 atom_t*         u64_to_b10 (const uint64_t value, uint16_t* const len, const bool little_endian);
+size_t     u64_to_b10_into (atom_t* const out, const size_t cap, const uint64_t value, const bool little_endian);
 atom_t*  u64_digits_to_b10 (const char* const digits, uint16_t* const len, const bool little_endian);
+atom_t* u64_digits_to_b10_n (const char* const digits, const size_t n, uint16_t* const len, const bool little_endian);
 
 uint16_t b10_to_u16 (const atom_t* const, const uint16_t len);
 
 /* base 256 conversions */
-char*     b256_to_ldbl_digits (const atom_t* const digits, const uint16_t len, const uint16_t int_len);
-char*     b256_to_u64_digits (const atom_t* const digits, const uint16_t len);
+char*     b256_to_ldbl_digits (const atom_t* const digits, const size_t len, const size_t int_len);
+char*     b256_to_u64_digits (const atom_t* const digits, const size_t len);
+size_t b256_to_ldbl_digits_into (char* const out, const size_t cap, const atom_t* const digits, const size_t len, const size_t int_len);
+size_t b256_to_u64_digits_into (char* const out, const size_t cap, const atom_t* const digits, const size_t len);
 uint64_t         b256_to_u64 (const atom_t* const digits, const uint16_t len);
 atom_t*  ldbl_digits_to_b256 (const char* const ldbl_digits, uint16_t* const len, uint16_t* const int_len, const bool little_endian);
+atom_t* ldbl_digits_to_b256_n (const char* const ldbl_digits, const size_t n, uint16_t* const len, uint16_t* const int_len, const bool little_endian);
+atom_t* ldbl_digits_to_b256_z (const char* const ldbl_digits, const size_t n, size_t* const len, size_t* const int_len, const bool little_endian);
 atom_t*          u64_to_b256 (const uint64_t value, uint16_t* const len, const bool little_endian);
+size_t      u64_to_b256_into (atom_t* const out, const size_t cap, const uint64_t value, const bool little_endian);
 atom_t*   u64_digits_to_b256 (const char* const digits, uint16_t* const len, const bool little_endian);
+atom_t* u64_digits_to_b256_n (const char* const digits, const size_t n, uint16_t* const len, const bool little_endian);
+size_t          b10_to_limbs (limb_t* const out, const atom_t* const digits, const size_t len);
+size_t         b256_to_limbs (limb_t* const out, const atom_t* const digits, const size_t len);
+size_t         limbs_to_b256 (atom_t* const out, const limb_t* const a, const size_t len);
+size_t count_b256_digits_for_b10 (const size_t len);
+atom_t*       numlit_to_b256 (const numlit_t* const lit, uint16_t* const len, uint16_t* const int_len, const bool little_endian);
+atom_t*     numlit_to_b256_z (const numlit_t* const lit, size_t* const len, size_t* const int_len, const bool little_endian);
+atom_t*        b10_to_b256_z (const atom_t* const digits, const size_t b10_len, const size_t b10_int_len, size_t* const len, size_t* const int_len);
+bool        b10_frac_to_b256 (atom_t* const out, const size_t out_len, const atom_t* const frac, const size_t frac_len);
+bool        b256_frac_to_b10 (atom_t* const out, const size_t out_len, const atom_t* const frac, const size_t frac_len);
+
+/* radix_conv: integers in any radix from 2 to 62, dividing and conquering */
+size_t radix_digits_to_limbs (limb_t* const out, const atom_t* const digits, const size_t len, const unsigned radix);
+size_t radix_limbs_to_digits (atom_t* const out, const limb_t* const a, const size_t len, const unsigned radix);
+size_t    b256_to_radix_into (char* const out, const size_t cap, const atom_t* const digits, const size_t len, const unsigned radix);
+char*          b256_to_radix (const atom_t* const digits, const size_t len, const unsigned radix);
+size_t     b10_to_radix_into (char* const out, const size_t cap, const atom_t* const digits, const size_t len, const unsigned radix);
+char*           b10_to_radix (const atom_t* const digits, const size_t len, const unsigned radix);
+atom_t*      radix_to_b256_n (const char* const str, const size_t n, const unsigned radix, size_t* const len);
+atom_t*       radix_to_b10_n (const char* const str, const size_t n, const unsigned radix, size_t* const len);
+
+/* radix_pow2: base 256 <-> hex, octal and base64, by repacking bits */
+size_t    b256_to_hex_into (char* const out, const size_t cap, const atom_t* const digits, const size_t len, const bool upper);
+char*          b256_to_hex (const atom_t* const digits, const size_t len, const bool upper);
+atom_t*      hex_to_b256_n (const char* const hex, const size_t n, size_t* const len);
+size_t    b256_to_oct_into (char* const out, const size_t cap, const atom_t* const digits, const size_t len);
+char*          b256_to_oct (const atom_t* const digits, const size_t len);
+atom_t*      oct_to_b256_n (const char* const oct, const size_t n, size_t* const len);
+size_t b256_to_base64_into (char* const out, const size_t cap, const atom_t* const digits, const size_t len);
+char*       b256_to_base64 (const atom_t* const digits, const size_t len);
+atom_t*   base64_to_b256_n (const char* const b64, const size_t n, size_t* const len);
 
 /*
   raw math primitives required to implement basic functionality
@@ -352,6 +817,8 @@ atom_t*   u64_digits_to_b256 (const char* const digits, uint16_t* const len, con
 */
 atom_t* succ_b10 (const atom_t* const n, const uint16_t len, const uint16_t int_len, const uint16_t precision, uint16_t* const out_len, uint16_t* const out_int_len);
 atom_t* pred_b10 (const atom_t* const n, const uint16_t len, const uint16_t int_len, const uint16_t precision, uint16_t* const out_len, uint16_t* const out_int_len);
+size_t succ_b10_into (atom_t* const out, const size_t cap, const atom_t* const n, const size_t len, const size_t int_len, const size_t precision, size_t* const out_int_len);
+size_t pred_b10_into (atom_t* const out, const size_t cap, const atom_t* const n, const size_t len, const size_t int_len, const size_t precision, size_t* const out_int_len);
 // natural log base e (2.718...)
 atom_t* impl_log_b10(const atom_t* const n, const uint16_t n_len, const uint16_t n_int_len, uint16_t* const out_len, uint16_t* const out_int_len, const uint16_t iterations);
 // log base n of x
@@ -367,6 +834,8 @@ atom_t* sq_b10 (const atom_t* const n, const uint16_t len, const uint16_t int_le
 atom_t* recip_b10 (const atom_t* const n, const uint16_t len, const uint16_t int_len, uint16_t* const out_len, uint16_t* const out_int_len);
 atom_t* floor_b10 (const atom_t* const n, const uint16_t len, const uint16_t int_len, uint16_t* const out_len, uint16_t* const out_int_len);
 atom_t* ceil_b10 (const atom_t* const n, const uint16_t len, const uint16_t int_len, uint16_t* const out_len, uint16_t* const out_int_len);
+size_t floor_b10_into (atom_t* const out, const size_t cap, const atom_t* const n, const size_t len, const size_t int_len, size_t* const out_int_len);
+size_t ceil_b10_into (atom_t* const out, const size_t cap, const atom_t* const n, const size_t len, const size_t int_len, size_t* const out_int_len);
 
 atom_t cmp_b10 (const atom_t* const a, const uint16_t a_len, const uint16_t a_int_len, const atom_t* const b, const uint16_t b_len, const uint16_t b_int_len);
 
@@ -0,0 +1,121 @@
+#ifndef BN_REF_H
+#define BN_REF_H
+
+#include "bn_common.h"
+
+/*
+  a digit array shared by everything that holds it, rather than copied for
+    each; the array is only read while it is shared, and changing it
+    (bn_ref_mut) first makes a copy unless there is just the one holder
+
+  the count of holders is changed atomically, so a handle may be shared
+    between threads, and each released by whichever thread is done with it;
+    the digits themselves are not locked, so a holder may only change them
+    through bn_ref_mut
+
+  the count and the array are one allocation, the array starting
+    BN_REF_HEADER atoms in
+*/
+
+// the count is changed with the GCC and Clang builtins, unless these are given
+#ifndef BN_REF_INC
+  #define BN_REF_INC(p)  __atomic_add_fetch((p), 1, __ATOMIC_RELAXED)
+  #define BN_REF_DEC(p)  __atomic_sub_fetch((p), 1, __ATOMIC_ACQ_REL)
+  #define BN_REF_LOAD(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#endif
+
+/* enough for the count and length, and keeps the array aligned for packed words */
+#define BN_REF_HEADER 16
+
+#define bn_ref_data(ref) ((atom_t*) (void*) (ref) + BN_REF_HEADER)
+
+/* a new handle, held once, to a copy of the len atoms at bna */
+static bn_ref_t* bn_ref_make (const atom_t* const bna, const size_t len) {
+  bn_ref_t* const ref = (bn_ref_t*) (void*) alloc(atom_t, BN_REF_HEADER + len);
+  if (NULL == ref) { return NULL; }
+
+  ref->refs = 1;
+  ref->len  = len;
+  memcpy(bn_ref_data(ref), bna, len);
+  return ref;
+}
+
+/*
+  atom_t* -> bn_ref_t*
+
+  a new handle, held once, to a copy of the digit array bna
+
+  NULL is returned when bna is NULL (errno is set to EINVAL), or memory is
+    exhausted
+*/
+bn_ref_t* bn_ref_new (const atom_t* const bna) {
+  if (NULL == bna) {
+    errno = EINVAL;
+    return NULL;
+  }
+  return bn_ref_make(bna, bna_size(bna));
+}
+
+/*
+  bn_ref_t* -> bn_ref_t*
+
+  hold ref once more, without copying it; the same handle is returned, and
+    each holder releases it once
+*/
+bn_ref_t* bn_ref_share (bn_ref_t* const ref) {
+  BN_REF_INC(&ref->refs);
+  return ref;
+}
+
+/*
+  bn_ref_t* -> void
+
+  let go of ref, which is freed when its last holder does; NULL is ignored
+*/
+void bn_ref_release (bn_ref_t* const ref) {
+  if (NULL != ref && 0 == BN_REF_DEC(&ref->refs)) { bn_free(ref); }
+}
+
+/*
+  bn_ref_t* -> atom_t*
+
+  the digit array ref holds, to be read but not changed
+*/
+const atom_t* bn_ref_digits (const bn_ref_t* const ref) {
+  return (const atom_t*) (const void*) ref + BN_REF_HEADER;
+}
+
+/*
+  bn_ref_t* -> size_t
+
+  how many hold ref, which may already have changed in another thread unless
+    the count is 1 and it is the caller's own
+*/
+size_t bn_ref_count (const bn_ref_t* const ref) {
+  return BN_REF_LOAD(&ref->refs);
+}
+
+/*
+  bn_ref_t** -> atom_t*
+
+  the digit array *ref holds, to be changed in place (but not lengthened); if
+    anything else holds it too, the caller's hold is moved to a copy first,
+    and *ref is replaced with the copy, so the others see no change
+
+  NULL is returned, and *ref is unchanged, when memory is exhausted
+*/
+atom_t* bn_ref_mut (bn_ref_t** const ref) {
+  bn_ref_t* const held = *ref;
+
+  /* no other holder can appear while this is the only one */
+  if (1 == BN_REF_LOAD(&held->refs)) { return bn_ref_data(held); }
+
+  bn_ref_t* const own = bn_ref_make(bn_ref_digits(held), held->len);
+  if (NULL == own) { return NULL; }
+
+  bn_ref_release(held);
+  *ref = own;
+  return bn_ref_data(own);
+}
+
+#endif /* end of include guard: BN_REF_H */
@@ -0,0 +1,438 @@
+#ifndef BN_VIEW_H
+#define BN_VIEW_H
+
+#include "bn_common.h"
+
+/*
+  views: a digit array's header decoded once (see bn_view_t), so that the
+    lengths and flags are plain fields rather than the bna_* macros, which
+    test the addressing mode and reassemble the lengths on every use
+
+  a view does not own its data, and slicing one never copies; the math here
+    takes and gives views, so lengths are not passed by hand, and like the raw
+    math it is unsigned: the flags are carried, but never looked at
+*/
+
+/* the one base that metadata indicates */
+static atom_t view_base (const atom_t metadata) {
+  return meta_is_packed(metadata) ? TYP_PACK : meta_is_bcd(metadata) ? TYP_BCD : meta_is_base256(metadata) ? TYP_ZENZ : TYP_NONE;
+}
+
+/*
+  atom_t* -> bn_view_t
+
+  decode the header of any digit array
+*/
+bn_view_t bn_view (const atom_t* const bna) {
+  const atom_t m = bna[0];
+  const bn_view_t v = {
+    bna + meta_header_offset(m),
+    bna_int_len(bna),
+    bna_frac_len(bna),
+    view_base(m),
+    bna_flags(bna)
+  };
+  return v;
+}
+
+/*
+  atom_t*, size_t, size_t, atom_t -> bn_view_t
+
+  a view of len raw elements, of which the first int_len are the integer
+    part, in the base of metadata (see bn_view_t), with no flags
+*/
+bn_view_t bn_view_raw (const atom_t* const data, const size_t len, const size_t int_len, const atom_t metadata) {
+  const bn_view_t v = {
+    data,
+    int_len,
+    len - int_len,
+    view_base(metadata),
+    FL_NONE
+  };
+  return v;
+}
+
+/*
+  bn_view_t -> bn_view_t
+
+  the integer part of a view, or its fractional part, sharing its data
+*/
+bn_view_t view_int_part (const bn_view_t v) {
+  bn_view_t part = v;
+  part.frac_len  = 0;
+  return part;
+}
+
+bn_view_t view_frac_part (const bn_view_t v) {
+  bn_view_t part = v;
+  part.data     += sz(atom_t, v.int_len * view_elem_size(v));
+  part.int_len   = 0;
+  return part;
+}
+
+/*
+  bn_view_t, size_t*, size_t* -> atom_t*
+
+  a new array of the base 10 digits of a view in any base, with the number of
+    them written to len and the integer digits among them to int_len
+
+  NULL is returned when memory is exhausted
+*/
+atom_t* view_to_b10 (const bn_view_t v, size_t* const len, size_t* const int_len) {
+  const size_t n = view_len(v);
+
+  if (TYP_ZENZ == v.base) {
+    char* const str = b256_to_ldbl_digits(v.data, n, v.int_len);
+    if (NULL == str) { return NULL; }
+    atom_t* const digits = ldbl_digits_to_b10_z(str, strlen(str), len, int_len, false);
+    bn_free(str);
+    return digits;
+  }
+
+  atom_t* const digits = alloc(atom_t, (TYP_PACK == v.base ? PK_DIGITS : TYP_BCD == v.base ? 2U : 1U) * n + 1);
+  if (NULL == digits) { return NULL; }
+
+  if (TYP_PACK == v.base) {
+    const scratch_mark_t mark = scratch_mark();
+    uint64_t* const limbs = salloc(uint64_t, n + 1);
+    if (NULL == limbs) {
+      bn_free(digits);
+      return NULL;
+    }
+    for (size_t i = 0; i < n; i++) {
+      limbs[i] = pk_load(v.data + sz(uint64_t, i));
+    }
+    set_out_param(len, pk_to_b10(digits, limbs, n, v.int_len, int_len));
+    scratch_reset(mark);
+
+  } else if (TYP_BCD == v.base) {
+    set_out_param(len, bcd_to_b10(digits, v.data, n, v.int_len, int_len));
+
+  } else {
+    memcpy(digits, v.data, n);
+    set_out_param(len, n);
+    set_out_param(int_len, v.int_len);
+  }
+
+  return digits;
+}
+
+/*
+  bn_view_t -> char*
+
+  the unsigned value of a view as a string of base 10 digits, as made by
+    b10_to_ldbl_digits
+
+  NULL is returned when memory is exhausted
+*/
+char* view_to_ldbl_digits (const bn_view_t v) {
+  if (TYP_ZENZ == v.base) {
+    return b256_to_ldbl_digits(v.data, view_len(v), v.int_len);
+  }
+  if (TYP_NONE == v.base) {
+    return b10_to_ldbl_digits(v.data, view_len(v), v.int_len);
+  }
+
+  size_t len = 0, int_len = 0;
+  atom_t* const digits = view_to_b10(v, &len, &int_len);
+  if (NULL == digits) { return NULL; }
+
+  char* const str = b10_to_ldbl_digits(digits, len, int_len);
+  bn_free(digits);
+  return str;
+}
+
+/*
+  bn_view_t, size_t, size_t -> uint64_t
+
+  element i of a view, counting in the places of a number with r_int integer
+    elements, where elements the view does not have are zero
+*/
+static uint64_t view_at (const bn_view_t v, const size_t r_int, const size_t i) {
+  const size_t shift = r_int - v.int_len;
+  if (i < shift || i - shift >= view_len(v)) { return 0; }
+
+  return TYP_PACK == v.base ? pk_load(v.data + sz(uint64_t, i - shift)) : v.data[i - shift];
+}
+
+/*
+  bn_view_t, size_t -> uint64_t
+
+  element i of a view, counting from its least significant (the last one), so
+    that it can be walked from the bottom, as carries and printing backwards
+    go, without a reversed copy of the data; i must be less than view_len(v)
+*/
+uint64_t view_elem_le (const bn_view_t v, const size_t i) {
+  const size_t at = view_len(v) - 1 - i;
+  return TYP_PACK == v.base ? pk_load(v.data + sz(uint64_t, at)) : v.data[at];
+}
+
+/*
+  bn_view_t, bn_view_t -> int
+
+  compare the unsigned values of two views in the same base: negative if
+    a < b, 0 if they are equal, positive if a > b; leading and trailing
+    zeroes do not matter
+
+  2 is returned, and errno set to EINVAL, if the views are in different bases
+*/
+int cmp_view (const bn_view_t a, const bn_view_t b) {
+  if (a.base != b.base) {
+    errno = EINVAL;
+    return 2;
+  }
+
+  /* each element is a digit in its base, so the first that differs decides */
+  const size_t r_int  = max(a.int_len, b.int_len),
+               r_frac = max(a.frac_len, b.frac_len);
+
+  for (size_t i = 0; i < r_int + r_frac; i++) {
+    const uint64_t x = view_at(a, r_int, i), y = view_at(b, r_int, i);
+    if (x != y) { return x < y ? -1 : 1; }
+  }
+  return 0;
+}
+
+/* a packed operation, like add_pk */
+typedef uint64_t* (*view_pk_op_t) (const uint64_t* const, const size_t, const size_t, const uint64_t* const, const size_t, const size_t, size_t* const, size_t* const);
+
+/*
+  bn_view_t, size_t*, size_t* -> uint64_t*
+
+  the words of a base 10, packed or BCD view, in scratch space (see
+    scratch.c), with the number of them written to len and the integer words
+    among them to int_len
+*/
+static uint64_t* view_to_pk (const bn_view_t v, size_t* const len, size_t* const int_len) {
+  const size_t n = view_len(v);
+
+  if (TYP_PACK == v.base) {
+    uint64_t* const limbs = salloc(uint64_t, n + 1);
+    if (NULL == limbs) { return NULL; }
+
+    for (size_t i = 0; i < n; i++) {
+      limbs[i] = pk_load(v.data + sz(uint64_t, i));
+    }
+    set_out_param(len, n);
+    set_out_param(int_len, v.int_len);
+    return limbs;
+  }
+
+  /* a BCD byte is two digits, which are unpacked above the words */
+  const size_t per = TYP_BCD == v.base ? 2 : 1;
+  uint64_t* const limbs = salloc(uint64_t, count_pk_limbs(per * v.int_len) + count_pk_limbs(per * v.frac_len) + 1);
+  if (NULL == limbs) { return NULL; }
+
+  const scratch_mark_t mark = scratch_mark();
+  bn_view_t d = v;
+
+  if (TYP_BCD == v.base) {
+    atom_t* const digits = salloc(atom_t, 2 * n + 1);
+    if (NULL == digits) { return NULL; }
+
+    size_t dint = 0;
+    const size_t dlen = bcd_to_b10(digits, v.data, n, v.int_len, &dint);
+    d = bn_view_raw(digits, dlen, dint, TYP_NONE);
+  }
+
+  set_out_param(len, b10_to_pk(limbs, d.data, view_len(d), d.int_len, int_len));
+  scratch_reset(mark);
+  return limbs;
+}
+
+/*
+  uint64_t*, size_t, size_t, atom_t, bn_view_t* -> atom_t*
+
+  write len words, of which int_len are the integer part, in the given base
+    (TYP_NONE, TYP_PACK or TYP_BCD) to a new array, and view it in out
+*/
+static atom_t* view_from_pk (const uint64_t* const limbs, const size_t len, const size_t int_len, const atom_t base, bn_view_t* const out) {
+  if (TYP_PACK == base) {
+    atom_t* const words = alloc(atom_t, sz(uint64_t, len) + 1);
+    if (NULL == words) { return NULL; }
+
+    for (size_t i = 0; i < len; i++) {
+      pk_store(words + sz(uint64_t, i), limbs[i]);
+    }
+    set_out_param(out, bn_view_raw(words, len, int_len, TYP_PACK));
+    return words;
+  }
+
+  /* the digits are only a step on the way to BCD */
+  atom_t* const digits = TYP_NONE == base ? alloc(atom_t, len * PK_DIGITS + 1) : salloc(atom_t, len * PK_DIGITS + 1);
+  if (NULL == digits) { return NULL; }
+
+  size_t dint = 0;
+  const size_t dlen = pk_to_b10(digits, limbs, len, int_len, &dint);
+
+  if (TYP_NONE == base) {
+    set_out_param(out, bn_view_raw(digits, dlen, dint, TYP_NONE));
+    return digits;
+  }
+
+  atom_t* const bytes = alloc(atom_t, count_bcd_bytes(dint) + count_bcd_bytes(dlen - dint) + 1);
+  if (NULL != bytes) {
+    size_t bint = 0;
+    const size_t blen = b10_to_bcd(bytes, digits, dlen, dint, &bint);
+    set_out_param(out, bn_view_raw(bytes, blen, bint, TYP_BCD));
+  }
+
+  return bytes;
+}
+
+/*
+  bn_view_t, bn_view_t, view_pk_op_t, bn_view_t* -> atom_t*
+
+  op on two base 10, packed or BCD views, worked in packed words
+*/
+static atom_t* view_pk_op (const bn_view_t a, const bn_view_t b, const view_pk_op_t op, bn_view_t* const out) {
+  size_t a_len = 0, a_int = 0, b_len = 0, b_int = 0, r_len = 0, r_int = 0;
+  const scratch_mark_t mark = scratch_mark();
+
+  uint64_t* const x = view_to_pk(a, &a_len, &a_int);
+  uint64_t* const y = view_to_pk(b, &b_len, &b_int);
+  uint64_t* const r = NULL == x || NULL == y ? NULL : op(x, a_len, a_int, y, b_len, b_int, &r_len, &r_int);
+
+  atom_t* const result = NULL == r ? NULL : view_from_pk(r, r_len, r_int, a.base, out);
+
+  bn_free(r);
+  scratch_reset(mark);
+  return result;
+}
+
+/*
+  bn_view_t, size_t, size_t* -> limb_t*
+
+  the limbs of a base 256 view as an integer, in scratch space, scaled so that
+    it has frac fractional digits, which must be no fewer than its own
+*/
+static limb_t* view_b256_limbs (const bn_view_t v, const size_t frac, size_t* const len) {
+  const size_t n = v.int_len + frac;
+
+  limb_t* const limbs = salloc(limb_t, n / 4 + 2);
+  const scratch_mark_t mark = scratch_mark();
+  atom_t* const bytes = zsalloc(atom_t, n + 1);
+
+  if (NULL == limbs || NULL == bytes) { return NULL; }
+
+  memcpy(bytes, v.data, view_len(v));
+  set_out_param(len, b256_to_limbs(limbs, bytes, n));
+  scratch_reset(mark);
+  return limbs;
+}
+
+/*
+  bn_view_t, bn_view_t, char, bn_view_t* -> atom_t*
+
+  a + b, a - b or a * b on two base 256 views, worked in limbs as integers
+    scaled by a power of 256
+
+  NULL is returned, and errno set to ERANGE, if a - b is negative
+*/
+static atom_t* view_b256_op (const bn_view_t a, const bn_view_t b, const char op, bn_view_t* const out) {
+  const size_t scale = '*' == op ? a.frac_len : max(a.frac_len, b.frac_len),
+               frac  = '*' == op ? a.frac_len + b.frac_len : scale;
+
+  size_t x_len = 0, y_len = 0;
+  const scratch_mark_t mark = scratch_mark();
+  limb_t* const x = view_b256_limbs(a, scale, &x_len);
+  limb_t* const y = view_b256_limbs(b, '*' == op ? b.frac_len : scale, &y_len);
+  limb_t* const r = NULL == x || NULL == y ? NULL : zsalloc(limb_t, x_len + y_len + 1);
+
+  if (NULL == r) {
+    scratch_reset(mark);
+    return NULL;
+  }
+
+  if ('-' == op && limb_cmp(x, x_len, y, y_len) < 0) {
+    scratch_reset(mark);
+    errno = ERANGE;
+    return NULL;
+  }
+
+  const size_t r_len = '+' == op ? limb_add(r, x, x_len, y, y_len)
+                     : '-' == op ? limb_normalize(r, limb_sub(r, x, x_len, y, y_len))
+                     : limb_mul(r, x, x_len, y, y_len);
+
+  /* the bytes have no leading zeroes, so a value below 1 is padded to frac */
+  atom_t* const bytes = zalloc(atom_t, 4 * r_len + frac + 1);
+  if (NULL == bytes) {
+    scratch_reset(mark);
+    return NULL;
+  }
+
+  const size_t n = limbs_to_b256(bytes, r, r_len),
+               pad = n < frac ? frac - n : 0;
+  scratch_reset(mark);
+
+  memmove(bytes + pad, bytes, n);
+  memset(bytes, 0, pad);
+
+  const size_t int_len = n + pad - frac;
+  size_t end = n + pad;
+  while (end > int_len && 0 == bytes[end - 1]) { end--; }
+
+  set_out_param(out, bn_view_raw(bytes, end, int_len, TYP_ZENZ));
+  return bytes;
+}
+
+/*
+  bn_view_t, bn_view_t, bn_view_t* -> atom_t*
+
+  a + b, for the unsigned values of two views in the same base; the result is
+    a new array in that base, with no zeroes at either end, which out is made
+    to view, and which the caller frees
+
+  NULL is returned, and errno set to EINVAL if the views are in different
+    bases, or when memory is exhausted
+*/
+atom_t* add_view (const bn_view_t a, const bn_view_t b, bn_view_t* const out) {
+  if (a.base != b.base) {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  if (TYP_ZENZ == a.base) { return view_b256_op(a, b, '+', out); }
+
+  /* BCD bytes add as they are, without unpacking */
+  if (TYP_BCD == a.base) {
+    size_t len = 0, int_len = 0;
+    atom_t* const r = add_bcd(a.data, view_len(a), a.int_len, b.data, view_len(b), b.int_len, &len, &int_len);
+    if (NULL != r) { set_out_param(out, bn_view_raw(r, len, int_len, TYP_BCD)); }
+    return r;
+  }
+
+  return view_pk_op(a, b, add_pk, out);
+}
+
+/*
+  bn_view_t, bn_view_t, bn_view_t* -> atom_t*
+
+  a - b, as add_view does a + b
+
+  NULL is returned, and errno set to ERANGE, if b is larger than a
+*/
+atom_t* sub_view (const bn_view_t a, const bn_view_t b, bn_view_t* const out) {
+  if (a.base != b.base) {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  return TYP_ZENZ == a.base ? view_b256_op(a, b, '-', out) : view_pk_op(a, b, sub_pk, out);
+}
+
+/*
+  bn_view_t, bn_view_t, bn_view_t* -> atom_t*
+
+  a * b, as add_view does a + b; nothing is rounded
+*/
+atom_t* mul_view (const bn_view_t a, const bn_view_t b, bn_view_t* const out) {
+  if (a.base != b.base) {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  return TYP_ZENZ == a.base ? view_b256_op(a, b, '*', out) : view_pk_op(a, b, mul_pk, out);
+}
+
+#endif /* end of include guard: BN_VIEW_H */
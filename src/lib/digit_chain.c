@@ -0,0 +1,379 @@
+#ifndef DIGIT_CHAIN_H
+#define DIGIT_CHAIN_H
+
+#include "bn_common.h"
+
+/*
+  a base 10 number split into fixed-size digit arrays, chained with the
+    TYP_OVERF and TYP_EXTN flags, for sums that keep growing
+
+  the chunks are aligned to the separator, so adding a value only touches the
+    chunks under its digits (and those a carry reaches), and growing the number
+    at either end makes new chunks instead of copying the old ones: adding to
+    a huge sum costs as much as the digits added, not the digits already there
+
+  each chunk is an ordinary big array (see TYP_BIG) of DIGIT_CHAIN_DIGITS
+    digits, all integer or all fractional depending on which side of the
+    separator it is
+*/
+
+/* the digits in each chunk, which a big array's header has to describe */
+#ifndef DIGIT_CHAIN_DIGITS
+  #define DIGIT_CHAIN_DIGITS 4096
+#endif
+
+#if DIGIT_CHAIN_DIGITS > UINT16_MAX || DIGIT_CHAIN_DIGITS < 1
+  #error "DIGIT_CHAIN_DIGITS must fit the header of a big array"
+#endif
+
+#define DC_HDR HEADER_OFFSET_BIG
+
+/* the place of the chunk holding the digit for 10^e, rounding down */
+static int64_t dc_place (const int64_t e) {
+  return e >= 0 ? e / DIGIT_CHAIN_DIGITS : -((-e - 1) / DIGIT_CHAIN_DIGITS) - 1;
+}
+
+/* the digits of the chunk at place p, which must exist */
+static atom_t* dc_data (const digit_chain_t* const dc, const int64_t p) {
+  return dc->chunks[p - dc->low] + DC_HDR;
+}
+
+/* flag the i'th chunk by which chunks are around it */
+static void dc_mark (digit_chain_t* const dc, const size_t i) {
+  dc->chunks[i][0] = (atom_t) (TYP_BIG
+    | (i > 0 ? TYP_OVERF : TYP_NONE)
+    | (i + 1 < dc->nchunks ? TYP_EXTN : TYP_NONE));
+}
+
+/* a new chunk of zeroes for place p */
+static atom_t* dc_chunk_new (const int64_t p) {
+  atom_t* const header = make_array_header(TYP_BIG, p >= 0 ? DIGIT_CHAIN_DIGITS : 0, p < 0 ? DIGIT_CHAIN_DIGITS : 0, FL_NONE);
+  atom_t* const chunk  = zalloc(atom_t, DC_HDR + DIGIT_CHAIN_DIGITS);
+
+  if (NULL == header || NULL == chunk) {
+    bn_free(header), bn_free(chunk);
+    return NULL;
+  }
+
+  memcpy(chunk, header, sz(atom_t, DC_HDR));
+  bn_free(header);
+  return chunk;
+}
+
+/* make room for extra more chunks, doubling to keep growing linear */
+static bool dc_reserve (digit_chain_t* const dc, const size_t extra) {
+  if (dc->nchunks + extra <= dc->cap) { return true; }
+
+  const size_t cap = max(dc->cap * 2, dc->nchunks + extra);
+  atom_t** const grown = (atom_t**) bn_realloc(dc->chunks, sizeof (atom_t*) * cap);
+  if (NULL == grown) { return false; }
+
+  dc->chunks = grown, dc->cap = cap;
+  return true;
+}
+
+/*
+  digit_chain_t*, int64_t, int64_t -> bool
+
+  make chunks for every place from lo to hi that the chain does not have yet;
+    only the pointers to the chunks are moved, never their digits
+
+  false is returned, and the chain is unchanged, when memory is exhausted
+*/
+static bool dc_cover (digit_chain_t* const dc, const int64_t lo, const int64_t hi) {
+  if (! dc->nchunks) { dc->low = lo; }
+
+  /* the chain stays in one piece, so a gap up to lo or down to hi is filled */
+  const int64_t top   = dc->low + (int64_t) dc->nchunks - 1;
+  const size_t  below = lo < dc->low ? (size_t) (dc->low - lo) : 0,
+                above = hi > top ? (size_t) (hi - top) : 0;
+
+  if (! below && ! above) { return true; }
+  if (! dc_reserve(dc, below + above)) { return false; }
+
+  /* all of the new chunks are made before any is put in place */
+  atom_t** const fresh = alloc(atom_t*, below + above);
+  size_t made = 0;
+  for (; NULL != fresh && made < below + above; made++) {
+    const int64_t p = made < below ? lo + (int64_t) made : top + 1 + (int64_t) (made - below);
+    if (NULL == (fresh[made] = dc_chunk_new(p))) { break; }
+  }
+
+  if (NULL == fresh || made < below + above) {
+    for (size_t i = 0; NULL != fresh && i < made; i++) { bn_free(fresh[i]); }
+    bn_free(fresh);
+    return false;
+  }
+
+  const size_t old = dc->nchunks;
+  memmove(dc->chunks + below, dc->chunks, sizeof (atom_t*) * old);
+  memcpy(dc->chunks, fresh, sizeof (atom_t*) * below);
+  memcpy(dc->chunks + below + old, fresh + below, sizeof (atom_t*) * above);
+  bn_free(fresh);
+
+  dc->nchunks += below + above;
+  dc->low     -= (int64_t) below;
+
+  /* only the new chunks and the old ends have different neighbours now */
+  for (size_t i = 0; i <= below && i < dc->nchunks; i++) { dc_mark(dc, i); }
+  for (size_t i = below + (old ? old - 1 : 0); i < dc->nchunks; i++) { dc_mark(dc, i); }
+
+  return true;
+}
+
+/* whether the i'th chunk is all zeroes */
+static bool dc_chunk_is_zero (const digit_chain_t* const dc, const size_t i) {
+  const atom_t* const data = dc->chunks[i] + DC_HDR;
+  for (size_t k = 0; k < DIGIT_CHAIN_DIGITS; k++) {
+    if (data[k]) { return false; }
+  }
+  return true;
+}
+
+/*
+  digit_chain_t*, int64_t*, int64_t* -> bool
+
+  the powers of 10 of the most and least significant nonzero digits, or false
+    if there are none
+*/
+static bool dc_bounds (const digit_chain_t* const dc, int64_t* const hi, int64_t* const lo) {
+  size_t top = dc->nchunks, bottom = 0, k = 0;
+
+  while (top && dc_chunk_is_zero(dc, top - 1)) { top--; }
+  if (! top) { return false; }
+
+  const atom_t* data = dc->chunks[top - 1] + DC_HDR;
+  while (! data[k]) { k++; }
+  *hi = (dc->low + (int64_t) top - 1) * DIGIT_CHAIN_DIGITS + DIGIT_CHAIN_DIGITS - 1 - (int64_t) k;
+
+  while (dc_chunk_is_zero(dc, bottom)) { bottom++; }
+
+  data = dc->chunks[bottom] + DC_HDR, k = DIGIT_CHAIN_DIGITS;
+  while (! data[k - 1]) { k--; }
+  *lo = (dc->low + (int64_t) bottom) * DIGIT_CHAIN_DIGITS + DIGIT_CHAIN_DIGITS - (int64_t) k;
+
+  return true;
+}
+
+/*
+  digit_chain_t*, void*, size_t, size_t, size_t, size_t, bool ->
+
+  copy the digits from 10^(int_len - 1) down to 10^-frac_len out of the chunks,
+    one run per chunk: the integer digits to out + int_at and the fractional
+    ones to out + frac_at, as characters if as_chars is true
+
+  places with no chunk are left as they are in out
+*/
+static void dc_write (const digit_chain_t* const dc, void* const out, const size_t int_at, const size_t int_len, const size_t frac_at, const size_t frac_len, const bool as_chars) {
+  for (size_t i = 0; i < dc->nchunks; i++) {
+    const int64_t base = (dc->low + (int64_t) i) * DIGIT_CHAIN_DIGITS,
+                  e0   = max(base, -(int64_t) frac_len),
+                  e1   = min(base + DIGIT_CHAIN_DIGITS - 1, (int64_t) int_len - 1);
+    if (e0 > e1) { continue; }
+
+    /* a chunk is never on both sides of the separator */
+    const size_t  pos   = base >= 0 ? int_at + int_len - 1 - (size_t) e1 : frac_at + (size_t) (-1 - e1),
+                  count = (size_t) (e1 - e0 + 1);
+    const atom_t* src   = dc->chunks[i] + DC_HDR + (DIGIT_CHAIN_DIGITS - 1 - (e1 - base));
+
+    if (as_chars) {
+      digits_to_chars((char*) out + pos, src, count, false);
+    } else {
+      memcpy((atom_t*) out + pos, src, count);
+    }
+  }
+}
+
+/*
+  void -> digit_chain_t*
+
+  a new chain, holding zero and no chunks
+
+  NULL is returned when memory is exhausted
+*/
+digit_chain_t* digit_chain_new (void) {
+  return zalloc(digit_chain_t, 1);
+}
+
+/*
+  digit_chain_t* -> void
+
+  free a chain and all of its chunks; NULL is ignored
+*/
+void digit_chain_free (digit_chain_t* const dc) {
+  if (NULL == dc) { return; }
+
+  for (size_t i = 0; i < dc->nchunks; i++) { bn_free(dc->chunks[i]); }
+  bn_free(dc->chunks);
+  bn_free(dc);
+}
+
+/*
+  digit_chain_t*, atom_t*, size_t, size_t -> bool
+
+  add len big endian base 10 digits, of which the first int_len are the
+    integer part, to the chain in place
+
+  only the chunks under the nonzero digits are visited, and more are made
+    where the sum grows past the chain at either end, so this takes time in
+    the length of the digits and of the carry, never of the whole sum
+
+  false is returned when int_len is greater than len (errno is set to
+    EINVAL), or memory is exhausted; if that happens after the digits were
+    added, the chain is missing the carry out of its top digit
+*/
+bool digit_chain_add (digit_chain_t* const dc, const atom_t* const digits, const size_t len, const size_t int_len) {
+  if (NULL == dc || int_len > len) {
+    errno = EINVAL;
+    return false;
+  }
+
+  size_t first = 0, last = len;
+  while (first < len && 0 == digits[first]) { first++; }
+  while (last > first && 0 == digits[last - 1]) { last--; }
+  if (first == last) { return true; }
+
+  /* the powers of 10 of the first and last nonzero digit */
+  const int64_t hi = (int64_t) int_len - 1 - (int64_t) first,
+                lo = (int64_t) int_len - (int64_t) last;
+
+  const int64_t p_lo = dc_place(lo), p_hi = dc_place(hi);
+  if (! dc_cover(dc, p_lo, p_hi)) { return false; }
+
+  atom_t carry = 0;
+  for (int64_t p = p_lo; p <= p_hi; p++) {
+    /* only the end chunks are not covered whole */
+    const int64_t base = p * DIGIT_CHAIN_DIGITS,
+                  e0   = p == p_lo ? lo : base,
+                  e1   = p == p_hi ? hi : base + DIGIT_CHAIN_DIGITS - 1;
+
+    /* both run most significant first, so walk them back together */
+    atom_t*       d = dc_data(dc, p) + (DIGIT_CHAIN_DIGITS - 1 - (e0 - base));
+    const atom_t* s = digits + ((int64_t) int_len - 1 - e0);
+
+    for (int64_t e = e0; e <= e1; e++, d--, s--) {
+      const atom_t sum = (atom_t) (*d + *s + carry);
+      carry = sum >= DEC_BASE;
+      *d    = (atom_t) (carry ? sum - DEC_BASE : sum);
+    }
+  }
+
+  /* a carry runs up through nines, onto a new chunk if it leaves the top */
+  for (int64_t e = hi + 1; carry; e++) {
+    const int64_t p = dc_place(e);
+    if (! dc_cover(dc, p, p)) { return false; }
+
+    atom_t* const d = dc_data(dc, p) + (DIGIT_CHAIN_DIGITS - 1 - (e - p * DIGIT_CHAIN_DIGITS));
+    carry = DEC_BASE - 1 == *d;
+    *d    = (atom_t) (carry ? 0 : *d + 1);
+  }
+
+  return true;
+}
+
+/*
+  digit_chain_t*, size_t*, size_t* -> atom_t*
+
+  the value of the chain as one run of base 10 digits, most significant first,
+    with no header and no limit on their length
+
+  the value at len     is changed to the number of digits
+  the value at int_len is changed to how many of them are before the separator
+
+  there are no leading or trailing zeroes, so zero has no digits at all
+
+  NULL is returned when memory is exhausted
+*/
+atom_t* digit_chain_raw (const digit_chain_t* const dc, size_t* const len, size_t* const int_len) {
+  int64_t hi = 0, lo = 0;
+  const bool nonzero = NULL != dc && dc_bounds(dc, &hi, &lo);
+
+  const size_t nint  = nonzero && hi >= 0 ? (size_t) hi + 1 : 0,
+               nfrac = nonzero && lo < 0 ? (size_t) -lo : 0;
+
+  set_out_param(len, 0);
+  set_out_param(int_len, 0);
+
+  /* never a zero-size allocation */
+  atom_t* const res = zalloc(atom_t, nint + nfrac + 1);
+  if (NULL == res) { return NULL; }
+
+  if (nonzero) { dc_write(dc, res, 0, nint, nint, nfrac, false); }
+
+  set_out_param(len, nint + nfrac);
+  set_out_param(int_len, nint);
+  return res;
+}
+
+/*
+  char*, size_t, digit_chain_t* -> size_t
+
+  write the chain's value as a base 10 string, like "123.45", into the
+    caller's buffer out, which has room for cap chars, straight from the
+    chunks; a zero integer part is written as 0, and there is no separator
+    without a fractional part
+
+  the return value and cap behave as for b10_to_ldbl_digits_into
+*/
+size_t digit_chain_to_ldbl_digits_into (char* const out, const size_t cap, const digit_chain_t* const dc) {
+  int64_t hi = 0, lo = 0;
+  const bool nonzero = NULL != dc && dc_bounds(dc, &hi, &lo);
+
+  const size_t nint  = nonzero && hi >= 0 ? (size_t) hi + 1 : 0,
+               nfrac = nonzero && lo < 0 ? (size_t) -lo : 0,
+               lead  = nint ? nint : 1,
+               need  = lead + (nfrac ? 1 + nfrac : 0);
+
+  if (NULL == out || cap <= need) { return need; }
+
+  memset(out, '0', need);
+  if (nfrac) { out[lead] = DECIMAL_SEPARATOR_STR[0]; }
+  if (nonzero) { dc_write(dc, out, 0, nint, lead + 1, nfrac, true); }
+  out[need] = '\0';
+
+  return need;
+}
+
+/*
+  digit_chain_t*, atom_t, atom_t -> atom_t*
+
+  a digit array (see to_digit_array) of the chain's value, with the given
+    metadata and flags; base 256, packed and BCD arrays are converted from the
+    base 10 digits
+
+  NULL is returned and errno is set to ERANGE if either part is too long for
+    the array's header (see meta_max_len), or when memory is exhausted
+*/
+atom_t* digit_chain_to_array (const digit_chain_t* const dc, const atom_t metadata, const atom_t flags) {
+  size_t len = 0, int_len = 0;
+  atom_t* raw = digit_chain_raw(dc, &len, &int_len);
+  if (NULL == raw) { return NULL; }
+
+  if (meta_is_packed(metadata) || meta_is_bcd(metadata)) {
+    atom_t* const pna = meta_is_packed(metadata) ? b10_to_pk_array(raw, len, int_len, metadata, flags)
+                                                 : b10_to_bcd_array(raw, len, int_len, metadata, flags);
+    bn_free(raw);
+    return pna;
+  }
+
+  if (meta_is_base256(metadata)) {
+    atom_t* const b256 = b10_to_b256_z(raw, len, int_len, &len, &int_len);
+    bn_free(raw);
+    if (NULL == b256) { return NULL; }
+    raw = b256;
+  }
+
+  atom_t* const header = make_array_header(metadata, int_len, len - int_len, flags);
+  const atom_t  hdrlen = NULL == header ? 0 : bna_header_offset(header);
+  atom_t* const bna    = NULL == header ? NULL : alloc(atom_t, hdrlen + len);
+
+  if (NULL != bna) {
+    memcpy(bna, header, sz(atom_t, hdrlen));
+    memcpy(bna + hdrlen, raw, sz(atom_t, len));
+  }
+
+  bn_free(header), bn_free(raw);
+  return bna;
+}
+
+#endif /* end of include guard: DIGIT_CHAIN_H */
@@ -0,0 +1,329 @@
+#ifndef DIGIT_STREAM_H
+#define DIGIT_STREAM_H
+
+#include "bn_common.h"
+
+/*
+  parsing a number that arrives in pieces: from memory, a FILE* or a file
+    descriptor, in chunks of any size, with no limit on its length and no
+    need for a terminator
+
+  the accepted form is what ldbl_digits_to_b10 takes, with an optional sign in
+    front and whitespace around it:
+
+    [space] [+ or -] [digits] [. digits] [space]
+
+  at least one digit is needed, and the value ends at the first space after it
+*/
+
+/* where in the number the next character is */
+#define DS_LEAD  0 /* before the number, where space and a sign may be */
+#define DS_INT   1 /* in the integer part */
+#define DS_FRAC  2 /* in the fractional part */
+#define DS_TRAIL 3 /* after the number, where only space may be */
+#define DS_ERROR 4 /* something else was found */
+
+/* the size of the reads done by digit_stream_read_file and _fd */
+#ifndef DIGIT_STREAM_CHUNK
+  #define DIGIT_STREAM_CHUNK 16384
+#endif
+
+static bool ds_is_space (const char c) {
+  return ' ' == c || '\t' == c || '\n' == c || '\r' == c || '\v' == c || '\f' == c;
+}
+
+/* make room for extra more digits, doubling to keep appending linear */
+static bool ds_reserve_digits (digit_stream_t* const ds, const size_t extra) {
+  if (ds->len + extra <= ds->cap) { return true; }
+
+  const size_t cap = max(ds->cap * 2, ds->len + extra);
+  atom_t* const grown = (atom_t*) bn_realloc(ds->digits, sz(atom_t, cap));
+  if (NULL == grown) { return false; }
+
+  ds->digits = grown, ds->cap = cap;
+  return true;
+}
+
+/*
+  digit_stream_t*, char*, size_t -> bool
+
+  append a run of n digit characters to the part being read
+*/
+static bool ds_append_run (digit_stream_t* const ds, const char* const run, const size_t n) {
+  size_t skip = 0;
+
+  /* leading zeroes of the integer part are not kept */
+  if (DS_INT == ds->state && ! ds->int_len) {
+    while (skip < n && '0' == run[skip]) { skip++; }
+  }
+
+  if (! ds_reserve_digits(ds, n - skip)) { return false; }
+
+  /* the run was already checked, so this is just the conversion */
+  chars_to_digits(ds->digits + ds->len, run + skip, n - skip, false);
+  ds->len += n - skip;
+  if (DS_INT == ds->state) { ds->int_len = ds->len; }
+
+  return true;
+}
+
+/*
+  atom_t -> digit_stream_t*
+
+  a new, empty stream, which will make an array with the given metadata (see
+    TYP_ZENZ and TYP_BIG)
+
+  NULL is returned when memory is exhausted
+*/
+digit_stream_t* digit_stream_new (const atom_t metadata) {
+  digit_stream_t* const ds = zalloc(digit_stream_t, 1);
+  if (NULL == ds) { return NULL; }
+
+  ds->metadata = metadata;
+  ds->state    = DS_LEAD;
+  return ds;
+}
+
+/*
+  digit_stream_t* -> void
+
+  free a stream and everything it holds; NULL is ignored
+*/
+void digit_stream_free (digit_stream_t* const ds) {
+  if (NULL == ds) { return; }
+
+  bn_free(ds->digits);
+  bn_free(ds);
+}
+
+/*
+  digit_stream_t*, char*, size_t -> bool
+
+  parse the next n characters of the number; chunk need not be terminated, and
+    a chunk may end anywhere, even inside a run of digits
+
+  false is returned when the characters are not part of a valid number (errno
+    is set to EINVAL), or memory is exhausted (ENOMEM); the stream then stays
+    invalid
+*/
+bool digit_stream_feed (digit_stream_t* const ds, const char* const chunk, const size_t n) {
+  if (NULL == ds || DS_ERROR == ds->state) {
+    return false;
+  }
+
+  size_t i = 0;
+  while (i < n) {
+    const char c = chunk[i];
+
+    switch (ds->state) {
+      case DS_LEAD:
+        if (ds_is_space(c)) {
+          i++;
+          continue;
+        }
+        ds->state = DS_INT;
+        if ('-' == c || '+' == c) {
+          ds->flags = '-' == c ? FL_SIGN : FL_NONE;
+          i++;
+        }
+        continue;
+
+      case DS_INT:
+      case DS_FRAC: {
+        const size_t run = digit_span(chunk + i, n - i);
+        if (run) {
+          if (! ds_append_run(ds, chunk + i, run)) {
+            /* errno is ENOMEM already */
+            ds->state = DS_ERROR;
+            return false;
+          }
+          ds->any_digits = true;
+          i += run;
+          continue;
+        }
+
+        if (DS_INT == ds->state && DECIMAL_SEPARATOR_STR[0] == c) {
+          ds->state = DS_FRAC;
+        } else if (ds->any_digits && ds_is_space(c)) {
+          ds->state = DS_TRAIL;
+        } else {
+          goto error;
+        }
+        i++;
+        continue;
+      }
+
+      case DS_TRAIL:
+        if (! ds_is_space(c)) { goto error; }
+        i++;
+        continue;
+
+      default:
+        goto error;
+    }
+  }
+
+  return true;
+
+  error:
+    ds->state = DS_ERROR;
+    errno = EINVAL;
+    return false;
+}
+
+/*
+  digit_stream_t*, FILE* -> bool
+
+  feed everything left in file to the stream, until end of file
+
+  false is returned when reading fails, or as from digit_stream_feed
+*/
+bool digit_stream_read_file (digit_stream_t* const ds, FILE* const file) {
+  char buf[DIGIT_STREAM_CHUNK];
+
+  while (true) {
+    const size_t got = fread(buf, 1, sizeof buf, file);
+    if (got && ! digit_stream_feed(ds, buf, got)) { return false; }
+    if (got < sizeof buf) { return ! ferror(file); }
+  }
+}
+
+#ifdef BN_HAVE_POSIX
+/*
+  digit_stream_t*, int -> bool
+
+  feed everything left in the file descriptor fd to the stream, with read(2),
+    until end of file; interrupted reads are retried
+
+  false is returned when reading fails (errno is from read), or as from
+    digit_stream_feed
+*/
+bool digit_stream_read_fd (digit_stream_t* const ds, const int fd) {
+  char buf[DIGIT_STREAM_CHUNK];
+
+  while (true) {
+    const ssize_t got = read(fd, buf, sizeof buf);
+    if (got < 0 && EINTR == errno) { continue; }
+    if (got <= 0) { return 0 == got; }
+    if (! digit_stream_feed(ds, buf, (size_t) got)) { return false; }
+  }
+}
+#endif /* BN_HAVE_POSIX */
+
+/*
+  digit_stream_t*, size_t*, size_t* -> atom_t*
+
+  the digits read so far, in the base of the stream's metadata (base 10 for
+    TYP_PACK and TYP_BCD, which are packed by digit_stream_finish), most
+    significant first, with no header and no limit on their length
+
+  the value at len     is changed to the number of digits
+  the value at int_len is changed to how many of them are before the separator
+
+  the integer part has no leading zeroes, so it is empty for a zero integer
+    part; a base 256 fractional part has count_b256_digits_for_b10 digits for
+    the base 10 digits read, and is truncated there
+
+  NULL is returned, with errno set to EINVAL, if the stream does not hold a
+    valid number, or to ENOMEM when memory is exhausted
+*/
+atom_t* digit_stream_raw (digit_stream_t* const ds, size_t* const len, size_t* const int_len) {
+  set_out_param(len, 0);
+  set_out_param(int_len, 0);
+
+  if (NULL == ds || DS_ERROR == ds->state || ! ds->any_digits) {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  const size_t frac_len = ds->len - ds->int_len;
+
+  if (! meta_is_base256(ds->metadata) || meta_is_packed(ds->metadata) || meta_is_bcd(ds->metadata)) {
+    /* never a zero-size allocation */
+    atom_t* const res = alloc(atom_t, ds->len + 1);
+    if (NULL == res) { return NULL; }
+
+    memcpy(res, ds->digits, sz(atom_t, ds->len));
+    set_out_param(len, ds->len);
+    set_out_param(int_len, ds->int_len);
+    return res;
+  }
+
+  /* the integer part is converted all at once, which is subquadratic */
+  limb_t* const limbs = alloc(limb_t, ds->int_len / 9 + 1);
+  if (NULL == limbs) { return NULL; }
+  const size_t nlimbs = b10_to_limbs(limbs, ds->digits, ds->int_len);
+  if ((size_t) -1 == nlimbs) {
+    bn_free(limbs);
+    return NULL;
+  }
+
+  const size_t b256_frac_len = count_b256_digits_for_b10(frac_len);
+  atom_t* const res = alloc(atom_t, nlimbs * sizeof (limb_t) + b256_frac_len + 1);
+  if (NULL == res) {
+    bn_free(limbs);
+    return NULL;
+  }
+
+  const size_t b256_int_len = limbs_to_b256(res, limbs, nlimbs);
+  bn_free(limbs);
+
+  if (! b10_frac_to_b256(res + b256_int_len, b256_frac_len, ds->digits + ds->int_len, frac_len)) {
+    bn_free(res);
+    return NULL;
+  }
+
+  set_out_param(len, b256_int_len + b256_frac_len);
+  set_out_param(int_len, b256_int_len);
+  return res;
+}
+
+/*
+  digit_stream_t* -> atom_t*
+
+  a digit array (see to_digit_array) of the number read so far, with the
+    stream's metadata and the sign that was read
+
+  NULL is returned and errno is set to
+    EINVAL if the stream does not hold a valid number
+    ERANGE if either part is too long for the array's header (255 digits,
+      65535 with TYP_BIG, or UINT32_MAX with TYP_HUGE; or as many words or
+      bytes with TYP_PACK or TYP_BCD, see b10_to_pk_array); digit_stream_raw
+      has no such limit
+*/
+atom_t* digit_stream_finish (digit_stream_t* const ds) {
+  size_t len = 0, int_len = 0;
+  atom_t* const raw = digit_stream_raw(ds, &len, &int_len);
+  if (NULL == raw) { return NULL; }
+
+  if (meta_is_packed(ds->metadata) || meta_is_bcd(ds->metadata)) {
+    atom_t* const pna = meta_is_packed(ds->metadata) ? b10_to_pk_array(raw, len, int_len, ds->metadata, ds->flags)
+                                                     : b10_to_bcd_array(raw, len, int_len, ds->metadata, ds->flags);
+    bn_free(raw);
+    return pna;
+  }
+
+  const size_t max_part = meta_max_len(ds->metadata);
+  if (int_len > max_part || len - int_len > max_part) {
+    bn_free(raw);
+    errno = ERANGE;
+    return NULL;
+  }
+
+  atom_t* const header = make_array_header(ds->metadata, int_len, len - int_len, ds->flags);
+  const atom_t  hdrlen = NULL == header ? 0 : bna_header_offset(header);
+  atom_t* const bna    = NULL == header ? NULL : alloc(atom_t, hdrlen + len);
+
+  if (NULL == bna) {
+    bn_free(header), bn_free(raw);
+    return NULL;
+  }
+
+  memcpy(bna, header, sz(atom_t, hdrlen));
+  memcpy(bna + hdrlen, raw, sz(atom_t, len));
+  bn_free(header), bn_free(raw);
+
+  return bna;
+}
+
+#endif /* end of include guard: DIGIT_STREAM_H */
@@ -0,0 +1,832 @@
+#ifndef LDBL_CONV_H
+#define LDBL_CONV_H
+
+#include "bn_common.h"
+
+/*
+  exact conversions between hardware floating point values and base 10 digits
+
+  rather than formatting with printf and scanning the string, the digits come
+    straight from the binary representation, using exact integer arithmetic on
+    limbs (see limb_math.c) so that no precision is lost in either direction
+*/
+
+/*
+  limbs needed by the largest intermediate value: about 2^-LDBL_MIN_EXP for
+    subnormal long doubles and 10^LDBL_MAX_10_EXP for the largest, with room
+    for the significand and the multiplications by 10 while generating digits
+*/
+#define LDBL_CONV_BITS  ( (LDBL_MAX_EXP > LDBL_MANT_DIG - LDBL_MIN_EXP ? LDBL_MAX_EXP : LDBL_MANT_DIG - LDBL_MIN_EXP) + LDBL_MANT_DIG + 256 )
+#define LDBL_CONV_LIMBS ((size_t) (LDBL_CONV_BITS / LIMB_BITS + 4))
+
+/* a fixed capacity integer for the conversions, on the stack */
+typedef struct {
+  limb_t limb[LDBL_CONV_LIMBS];
+  size_t len;
+} conv_big_t;
+
+static void conv_big_set_u32 (conv_big_t* const a, const limb_t value) {
+  a->limb[0] = value;
+  a->len     = limb_normalize(a->limb, 1);
+}
+
+/* copy only the limbs in use, not the whole capacity */
+static void conv_big_copy (conv_big_t* const dst, const conv_big_t* const src) {
+  memcpy(dst->limb, src->limb, sz(limb_t, src->len));
+  dst->len = src->len;
+}
+
+static void conv_big_mul_small (conv_big_t* const a, const limb_t m) {
+  a->len = limb_mul_small(a->limb, a->len, m, 0);
+}
+
+static void conv_big_shl (conv_big_t* const a, const size_t bits) {
+  a->len = limb_shl(a->limb, a->limb, a->len, bits);
+}
+
+/* whether a is a power of 2 */
+static bool conv_big_is_pow2 (const conv_big_t* const a) {
+  if (! a->len) { return false; }
+  const limb_t top = a->limb[a->len - 1];
+  return 0 == (top & (top - 1)) && 0 == limb_normalize(a->limb, a->len - 1);
+}
+
+/* compare a + b with c */
+static int conv_big_cmp_sum (const conv_big_t* const a, const conv_big_t* const b, const conv_big_t* const c) {
+  conv_big_t sum;
+  sum.len = limb_add(sum.limb, a->limb, a->len, b->limb, b->len);
+  return limb_cmp(sum.limb, sum.len, c->limb, c->len);
+}
+
+/*
+  limb_t*, ldbl_t -> size_t
+
+  store a nonnegative integral value, which must be exact, as limbs, and return
+    their count
+  every step is exact, because dividing by 2^32 only changes the exponent
+*/
+static size_t conv_limbs_from_ldbl (limb_t* const a, const ldbl_t integral) {
+  const ldbl_t limb_base = 4294967296.0L;
+  ldbl_t rest = integral;
+
+  size_t n = 0;
+  while (rest >= 1) {
+    const ldbl_t upper = floorl(rest / limb_base);
+    a[n++] = (limb_t) (rest - upper * limb_base);
+    rest   = upper;
+  }
+  return n;
+}
+
+static void conv_big_set_ldbl (conv_big_t* const a, const ldbl_t integral) {
+  a->len = conv_limbs_from_ldbl(a->limb, integral);
+}
+
+/*
+  the digit generation for impl_shortest_digits; r / s is the value, and m+ / s
+    and m- / s are the distances to the ends of the rounding interval, all
+    already scaled so that r / s is in [0.1, 1)
+
+  the digits are written to digits and their count is returned; the last one
+    may be 10, if rounding up a 9
+*/
+static atom_t impl_shortest_generate (conv_big_t* const r, const conv_big_t* const s, conv_big_t* const m_plus, conv_big_t* const m_minus, const bool even, atom_t* const digits) {
+  atom_t ndigits = 0;
+  while (true) {
+    conv_big_mul_small(r, DEC_BASE);
+    conv_big_mul_small(m_plus, DEC_BASE);
+    conv_big_mul_small(m_minus, DEC_BASE);
+
+    /* the next digit is r / s, which is below 10 */
+    atom_t d = 0;
+    while (limb_cmp(r->limb, r->len, s->limb, s->len) >= 0) {
+      r->len = limb_sub(r->limb, r->limb, r->len, s->limb, s->len);
+      d++;
+    }
+
+    const int low_cmp = limb_cmp(r->limb, r->len, m_minus->limb, m_minus->len);
+    const bool low  = even ? low_cmp <= 0 : low_cmp < 0,
+               high = conv_big_cmp_sum(r, m_plus, s) >= (even ? 0 : 1);
+
+    if (! low && ! high) {
+      digits[ndigits++] = d;
+      continue;
+    }
+
+    if (low && high) {
+      /* both neighbours are acceptable, so take the nearer one */
+      conv_big_t twice;
+      twice.len = limb_shl(twice.limb, r->limb, r->len, 1);
+      const int half_cmp = limb_cmp(twice.limb, twice.len, s->limb, s->len);
+      if (half_cmp > 0 || (0 == half_cmp && (d & 1))) { d++; }
+    } else if (high) {
+      d++;
+    }
+
+    digits[ndigits++] = d;
+    return ndigits;
+  }
+}
+
+/* bits of s below which impl_shortest_generate_native cannot overflow */
+#define CONV_NATIVE_BITS 59
+
+static uint64_t conv_big_to_u64 (const conv_big_t* const a) {
+  return (a->len > 1 ? (uint64_t) a->limb[1] << LIMB_BITS : 0) | (a->len ? a->limb[0] : 0);
+}
+
+/*
+  the same, when s < 2^59: r + m+ is below s, so 10 times that still fits in
+    64 bits, and no limbs are needed at all
+
+  this is the case for the typical double, with a magnitude between 1 and 2^53
+*/
+static atom_t impl_shortest_generate_native (const conv_big_t* const r_big, const conv_big_t* const s_big, const conv_big_t* const m_plus_big, const conv_big_t* const m_minus_big, const bool even, atom_t* const digits) {
+  const uint64_t s = conv_big_to_u64(s_big);
+  uint64_t r       = conv_big_to_u64(r_big),
+           m_plus  = conv_big_to_u64(m_plus_big),
+           m_minus = conv_big_to_u64(m_minus_big);
+
+  atom_t ndigits = 0;
+  while (true) {
+    r *= DEC_BASE, m_plus *= DEC_BASE, m_minus *= DEC_BASE;
+
+    atom_t d = (atom_t) (r / s);
+    r %= s;
+
+    const bool low  = even ? r <= m_minus : r < m_minus,
+               high = even ? r + m_plus >= s : r + m_plus > s;
+
+    if (! low && ! high) {
+      digits[ndigits++] = d;
+      continue;
+    }
+
+    if (low && high) {
+      if (2 * r > s || (2 * r == s && (d & 1))) { d++; }
+    } else if (high) {
+      d++;
+    }
+
+    digits[ndigits++] = d;
+    return ndigits;
+  }
+}
+
+/*
+  ldbl_t, int, int, atom_t*, int32_t* -> atom_t
+
+  the shortest string of base 10 digits that reads back as exactly ldbl in a
+    binary format with mant_dig bits of precision and a minimum (frexp style)
+    exponent of min_exp, when rounding to nearest, ties to even
+
+  this is the free-format algorithm of Steele & White and Burger & Dybvig: the
+    value and the halfway points to its neighbours are kept as exact integers
+    r / s, m+ / s and m- / s, and digits are generated until the remaining
+    value is inside the rounding interval
+
+  the digits (each 0-9, most significant first) are written to digits, and the
+    value is 0.d1 d2 d3 ... * 10^dec_exp
+
+  ldbl must be finite and positive
+*/
+static atom_t impl_shortest_digits (const ldbl_t ldbl, const int mant_dig, const int min_exp, atom_t* const digits, int32_t* const dec_exp) {
+
+  /* step 1: ldbl = f * 2^e, for integral f of at most mant_dig bits */
+
+  int frexp_exp = 0;
+  const ldbl_t frac = frexpl(ldbl, &frexp_exp);
+
+  /* subnormals all share the smallest exponent */
+  const int e = max(frexp_exp - mant_dig, min_exp - mant_dig);
+
+  conv_big_t r, s, m_plus, m_minus;
+  conv_big_set_ldbl(&r, ldexpl(frac, frexp_exp - e));
+
+  /* f is the smallest of its binade, so the gap below is half the gap above */
+  const bool unequal_gaps = e > min_exp - mant_dig && conv_big_is_pow2(&r);
+
+  /* halfway points are included when f is even, since ties round to even */
+  const bool even = 0 == (r.limb[0] & 1);
+
+  /* step 2: the scaled value and boundaries, as integers over s */
+
+  conv_big_set_u32(&s, 1);
+  conv_big_set_u32(&m_minus, 1);
+
+  if (e >= 0) {
+    conv_big_shl(&m_minus, (size_t) e);
+    conv_big_shl(&r, (size_t) e);
+  } else {
+    conv_big_shl(&s, (size_t) -e);
+  }
+
+  conv_big_copy(&m_plus, &m_minus);
+  if (unequal_gaps) {
+    conv_big_shl(&m_plus, 1);
+    conv_big_shl(&r, 2);
+    conv_big_shl(&s, 2);
+  } else {
+    conv_big_shl(&r, 1);
+    conv_big_shl(&s, 1);
+  }
+
+  /* step 3: estimate the decimal exponent, and scale by it */
+
+  /* ldbl is in [2^(frexp_exp - 1), 2^frexp_exp), so this is at most one too low */
+  int32_t k = (int32_t) ceil((frexp_exp - 1) * 0.30102999566398119521);
+
+  if (k >= 0) {
+    s.len = limb_mul_pow10(s.limb, s.len, (uint32_t) k);
+  } else {
+    r.len       = limb_mul_pow10(r.limb, r.len, (uint32_t) -k);
+    m_plus.len  = limb_mul_pow10(m_plus.limb, m_plus.len, (uint32_t) -k);
+    m_minus.len = limb_mul_pow10(m_minus.limb, m_minus.len, (uint32_t) -k);
+  }
+
+  /* the estimate may be one off in either direction */
+  while (conv_big_cmp_sum(&r, &m_plus, &s) >= (even ? 0 : 1)) {
+    conv_big_mul_small(&s, DEC_BASE);
+    k++;
+  }
+
+  while (true) {
+    conv_big_t high;
+    high.len = limb_add(high.limb, r.limb, r.len, m_plus.limb, m_plus.len);
+    conv_big_mul_small(&high, DEC_BASE);
+    if (limb_cmp(high.limb, high.len, s.limb, s.len) >= (even ? 0 : 1)) { break; }
+
+    conv_big_mul_small(&r, DEC_BASE);
+    conv_big_mul_small(&m_plus, DEC_BASE);
+    conv_big_mul_small(&m_minus, DEC_BASE);
+    k--;
+  }
+
+  /* step 4: generate digits until one of the boundaries is crossed */
+
+  atom_t ndigits = limb_bit_length(s.limb, s.len) <= CONV_NATIVE_BITS
+    ? impl_shortest_generate_native(&r, &s, &m_plus, &m_minus, even, digits)
+    : impl_shortest_generate(&r, &s, &m_plus, &m_minus, even, digits);
+
+  /* rounding up a 9 carries into the preceding digits */
+  while (ndigits > 1 && DEC_BASE == digits[ndigits - 1]) {
+    ndigits--;
+    digits[ndigits - 1]++;
+  }
+  if (DEC_BASE == digits[0]) {
+    digits[0] = 1;
+    ndigits   = 1;
+    k++;
+  }
+
+  /* trailing zeroes are not significant */
+  while (ndigits > 1 && 0 == digits[ndigits - 1]) { ndigits--; }
+
+  set_out_param(dec_exp, k);
+  return ndigits;
+}
+
+/*
+  ldbl_t, atom_t*, int32_t* -> atom_t
+
+  write the shortest base 10 digits that read back as exactly ldbl (as a long
+    double) to the caller's buffer digits, most significant first, and return
+    how many were written
+
+  the value at dec_exp is changed so that |ldbl| = 0.d1 d2 d3 ... * 10^dec_exp
+
+  digits needs room for MAX_PRIMITIVE_LDBL_DIGITS values
+
+  the sign is ignored, and 0 is returned for zero, infinities and NaN
+*/
+atom_t ldbl_to_shortest_digits (const ldbl_t ldbl, atom_t* const digits, int32_t* const dec_exp) {
+  set_out_param(dec_exp, 0);
+
+  const ldbl_t mag = fabsl(ldbl);
+  if (! isfinite(mag) || ! (mag > 0)) { return 0; }
+
+  return impl_shortest_digits(mag, LDBL_MANT_DIG, LDBL_MIN_EXP, digits, dec_exp);
+}
+
+/*
+  double, atom_t*, int32_t* -> atom_t
+
+  like ldbl_to_shortest_digits, but the digits read back as exactly dbl as a
+    double, so 0.1 gives { 1 } rather than the 17 or more digits needed to
+    tell its double value apart from its long double neighbours
+*/
+atom_t dbl_to_shortest_digits (const double dbl, atom_t* const digits, int32_t* const dec_exp) {
+  set_out_param(dec_exp, 0);
+
+  const double mag = fabs(dbl);
+  if (! isfinite(mag) || ! (mag > 0)) { return 0; }
+
+  return impl_shortest_digits((ldbl_t) mag, DBL_MANT_DIG, DBL_MIN_EXP, digits, dec_exp);
+}
+
+/* DIGITS TO FLOATING POINT */
+
+/* 10^27 = 2^27 * 5^27 is the largest power of 10 with a 64 bit significand */
+static const ldbl_t conv_exact_pow10[] = {
+  1e0L,  1e1L,  1e2L,  1e3L,  1e4L,  1e5L,  1e6L,  1e7L,  1e8L,  1e9L,
+  1e10L, 1e11L, 1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L,
+  1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L, 1e26L, 1e27L
+};
+
+/* the largest exact powers of 10 for each type */
+#define CONV_DBL_EXACT_POW10  22
+#define CONV_LDBL_EXACT_POW10 (LDBL_MANT_DIG >= 64 ? 27 : CONV_DBL_EXACT_POW10)
+
+/*
+  the most significant digits a halfway point between two long doubles can
+    have; digits beyond these can only break ties, so they are kept as a flag
+*/
+#define CONV_MAX_SIG_DIGITS ((size_t) (LDBL_MANT_DIG - LDBL_MIN_EXP + 2))
+
+/* the digits read by the fast paths, all of which fit in a uint64_t */
+#define CONV_FAST_DIGITS 19
+
+/* log10(2), for bounding decimal exponents */
+#define CONV_LOG10_2 0.30102999566398119521
+
+/* a base 10 value sig * 10^exp, plus something less than 10^exp if inexact */
+typedef struct {
+  const atom_t* sig; /* most significant first, with no leading or trailing zeroes */
+  size_t  nsig;
+  int32_t exp;
+  bool    inexact;
+} conv_dec_t;
+
+/*
+  conv_dec_t*, atom_t*, size_t, size_t -> bool
+
+  describe big endian base 10 digits with int_len integer digits, returning
+    false if their value is zero
+
+  the exponent of a huge array (see TYP_HUGE) can be past the range of an
+    int32_t; it is clamped well outside every float's range instead
+*/
+static bool conv_dec_from_b10 (conv_dec_t* const v, const atom_t* const digits, const size_t len, const size_t int_len) {
+  size_t first = 0, last = len;
+  while (first < len && 0 == digits[first]) { first++; }
+  while (last > first && 0 == digits[last - 1]) { last--; }
+
+  if (first == last) { return false; }
+
+  int64_t exp = (int64_t) int_len - (int64_t) last;
+
+  v->sig     = digits + first;
+  v->nsig    = last - first;
+  v->inexact = false;
+
+  if (v->nsig > CONV_MAX_SIG_DIGITS) {
+    exp       += (int64_t) (v->nsig - CONV_MAX_SIG_DIGITS);
+    v->nsig    = CONV_MAX_SIG_DIGITS;
+    /* trailing zeroes were removed, so what is dropped is not zero */
+    v->inexact = true;
+  }
+
+  v->exp = (int32_t) (exp > INT32_MAX / 2 ? INT32_MAX / 2 : exp < INT32_MIN / 2 ? INT32_MIN / 2 : exp);
+  return true;
+}
+
+/* the leading digits of v as an integer, with *exp changed to their scale */
+static uint64_t conv_dec_leading (const conv_dec_t* const v, int32_t* const exp) {
+  const size_t n = min(v->nsig, (size_t) CONV_FAST_DIGITS);
+
+  uint64_t w = 0;
+  for (size_t i = 0; i < n; i++) { w = w * DEC_BASE + v->sig[i]; }
+
+  *exp = v->exp + (int32_t) (v->nsig - n);
+  return w;
+}
+
+/* whether the leading digits are all of v */
+#define conv_dec_is_short(v) ( ! (v)->inexact && (v)->nsig <= CONV_FAST_DIGITS )
+
+/*
+  conv_dec_t* -> ldbl_t
+
+  an estimate of v, within a few units in the last place of a long double
+*/
+static ldbl_t conv_dec_approx (const conv_dec_t* const v) {
+  int32_t exp = 0;
+  const ldbl_t w = (ldbl_t) conv_dec_leading(v, &exp);
+
+  if (exp >= 0 && exp <= CONV_LDBL_EXACT_POW10) {
+    return w * conv_exact_pow10[exp];
+  } else if (exp < 0 && -exp <= CONV_LDBL_EXACT_POW10) {
+    return w / conv_exact_pow10[-exp];
+  } else if (exp > LDBL_MIN_10_EXP && exp < LDBL_MAX_10_EXP - CONV_FAST_DIGITS) {
+    return w * powl(DEC_BASE, exp);
+  }
+
+  /* near the ends of the range, 10^exp itself is out of it */
+  const int32_t half = exp / 2;
+  return w * powl(DEC_BASE, half) * powl(DEC_BASE, exp - half);
+}
+
+/*
+  conv_dec_t*, ldbl_t, int32_t, int, int* -> bool
+
+  exactly compare v with the midpoint (b * 2^-half_exp + delta) * 2^half_exp,
+    where delta is 1 or -1 and b is a multiple of 2^(half_exp + 1), writing
+    to out a negative number if v is less, 0 if equal, positive if greater
+
+  false is returned, and errno set to ENOMEM, when the numbers are too large
+    for the stack and memory is exhausted
+*/
+static bool conv_dec_cmp_mid (const conv_dec_t* const v, const ldbl_t b, const int32_t half_exp, const int delta, int* const out) {
+  const int32_t exp = v->exp;
+  const size_t shift = (size_t) labs((long) exp - half_exp),
+               pow5  = (size_t) labs((long) exp);
+
+  /* bits: about 3.33 per digit, 2.33 per power of 5, plus the shift */
+  const size_t cap = (v->nsig * 4 + pow5 * 3 + shift + LDBL_MANT_DIG + 2 * LIMB_BITS) / LIMB_BITS;
+
+  limb_t small[2][LDBL_CONV_LIMBS];
+  limb_t* const mem = cap > LDBL_CONV_LIMBS ? alloc(limb_t, 2 * cap) : NULL;
+
+  /* the stack is too small for them, so there is nowhere else to go */
+  if (cap > LDBL_CONV_LIMBS && NULL == mem) {
+    errno = ENOMEM;
+    return false;
+  }
+
+  limb_t* const l = mem ? mem : small[0];
+  limb_t* const r = mem ? mem + cap : small[1];
+
+  /* l = sig */
+  size_t l_len = 0;
+  for (size_t i = 0; i < v->nsig; ) {
+    limb_t chunk = 0, scale = 1;
+    for (size_t k = 0; k < 9 && i < v->nsig; k++, i++) {
+      chunk = chunk * DEC_BASE + v->sig[i];
+      scale *= DEC_BASE;
+    }
+    l_len = limb_mul_small(l, l_len, scale, chunk);
+  }
+
+  /* r = b * 2^-half_exp + delta */
+  size_t r_len = conv_limbs_from_ldbl(r, ldexpl(b, -half_exp));
+  const limb_t one = 1;
+  r_len = delta > 0 ? limb_add(r, r, r_len, &one, 1) : limb_sub(r, r, r_len, &one, 1);
+
+  /* l * 5^exp * 2^exp against r * 2^half_exp, with only integers */
+  if (exp >= 0) {
+    l_len = limb_mul_pow5(l, l_len, (uint32_t) exp);
+  } else {
+    r_len = limb_mul_pow5(r, r_len, (uint32_t) -exp);
+  }
+
+  if (exp > half_exp) {
+    l_len = limb_shl(l, l, l_len, shift);
+  } else {
+    r_len = limb_shl(r, r, r_len, shift);
+  }
+
+  int cmp = limb_cmp(l, l_len, r, r_len);
+  /* the dropped digits are only significant in a tie */
+  if (0 == cmp && v->inexact) { cmp = 1; }
+
+  bn_free(mem);
+  *out = cmp;
+  return true;
+}
+
+/* the exponent of the unit in the last place of b, in the target format */
+static int32_t conv_ulp_exp (const ldbl_t b, const int mant_dig, const int min_exp) {
+  int frexp_exp = min_exp;
+  if (b > 0) { frexpl(b, &frexp_exp); }
+  return max(frexp_exp, min_exp) - mant_dig;
+}
+
+/* the same, for the gap below b, which is smaller at the bottom of a binade */
+static int32_t conv_ulp_below_exp (const ldbl_t b, const int mant_dig, const int min_exp) {
+  int frexp_exp = 0;
+  const ldbl_t frac = frexpl(b, &frexp_exp);
+  const int32_t ulp_exp = conv_ulp_exp(b, mant_dig, min_exp);
+  return (! islessgreater(frac, 0.5L) && frexp_exp > min_exp) ? ulp_exp - 1 : ulp_exp;
+}
+
+/* whether b is an odd multiple of 2^ulp_exp, that is, has an odd significand */
+static bool conv_is_odd (const ldbl_t b, const int32_t ulp_exp) {
+  return fmodl(ldexpl(b, -ulp_exp), 2) > 0;
+}
+
+/*
+  conv_dec_t*, ldbl_t, int, int, int -> ldbl_t
+
+  correct a guess b, a nonnegative value of the target format, to v rounded to
+    nearest (ties to even) in the format with mant_dig bits of precision and
+    (frexp style) exponents from min_exp to max_exp
+
+  each step is one exact comparison with a halfway point, so a close guess is
+    corrected in one or two comparisons; overflow gives infinity
+
+  NaN is returned, and errno set to ENOMEM, when memory is exhausted
+*/
+static ldbl_t conv_dec_round (const conv_dec_t* const v, const ldbl_t guess, const int mant_dig, const int min_exp, const int max_exp) {
+  ldbl_t b = guess;
+  bool moved = false;
+
+  /* up, while v is above the halfway point to the next value */
+  while (isfinite(b) && ilogbl(b) < max_exp) {
+    const int32_t ulp_exp = conv_ulp_exp(b, mant_dig, min_exp);
+    int cmp = 0;
+    if (! conv_dec_cmp_mid(v, b, ulp_exp - 1, 1, &cmp)) { return NAN; }
+    if (cmp < 0 || (0 == cmp && ! conv_is_odd(b, ulp_exp))) { break; }
+
+    b += ldexpl(1, ulp_exp);
+    moved = true;
+  }
+
+  /* otherwise down, while v is below the halfway point to the previous value */
+  while (! moved && b > 0) {
+    const int32_t ulp_exp = conv_ulp_below_exp(b, mant_dig, min_exp);
+    int cmp = 0;
+    if (! conv_dec_cmp_mid(v, b, ulp_exp - 1, -1, &cmp)) { return NAN; }
+    if (cmp > 0 || (0 == cmp && ! conv_is_odd(b, conv_ulp_exp(b, mant_dig, min_exp)))) { break; }
+
+    b -= ldexpl(1, ulp_exp);
+  }
+
+  return b;
+}
+
+/*
+  conv_dec_t*, int, int, int, ldbl_t* -> bool
+
+  whether v is certainly out of the range of the target format; if so, the
+    result is written to out, and errno is set to ERANGE
+*/
+static bool conv_dec_out_of_range (const conv_dec_t* const v, const int mant_dig, const int min_exp, const int max_exp, ldbl_t* const out) {
+  /* v is in [10^(top - 1), 10^top) */
+  const int32_t top = v->exp + (int32_t) v->nsig;
+
+  if (top > max_exp * CONV_LOG10_2 + 2) {
+    *out = HUGE_VALL;
+  } else if (top < (min_exp - mant_dig) * CONV_LOG10_2 - 1) {
+    *out = 0;
+  } else {
+    return false;
+  }
+
+  errno = ERANGE;
+  return true;
+}
+
+/*
+  atom_t*, size_t, size_t -> ldbl_t
+
+  the value of big endian base 10 digits, with int_len of them before the
+    separator, correctly rounded to the nearest long double
+
+  when all significant digits fit in a uint64_t and the power of 10 is exact,
+    one hardware operation is correctly rounded; otherwise, an estimate is
+    corrected by exact comparisons with its halfway points
+
+  on overflow, HUGE_VALL is returned, and errno is set to ERANGE; if the value
+    is nonzero but rounds to zero, errno is also set to ERANGE
+
+  0 is returned when digits is NULL or len is 0, and NaN, with errno set to
+    ENOMEM, when the exact comparisons run out of memory
+*/
+ldbl_t b10_to_ldbl (const atom_t* const digits, const size_t len, const size_t int_len) {
+  conv_dec_t v;
+  if ( NULL == digits || ! conv_dec_from_b10(&v, digits, len, int_len) ) {
+    return 0;
+  }
+
+  if ( conv_dec_is_short(&v) && abs(v.exp) <= CONV_LDBL_EXACT_POW10
+    && (LDBL_MANT_DIG >= 64 || v.nsig <= DBL_DIG) ) {
+    int32_t exp = 0;
+    const ldbl_t w = (ldbl_t) conv_dec_leading(&v, &exp);
+    return exp >= 0 ? w * conv_exact_pow10[exp] : w / conv_exact_pow10[-exp];
+  }
+
+  ldbl_t out = 0;
+  if ( conv_dec_out_of_range(&v, LDBL_MANT_DIG, LDBL_MIN_EXP, LDBL_MAX_EXP, &out) ) {
+    return out;
+  }
+
+  const ldbl_t guess = conv_dec_approx(&v);
+  out = conv_dec_round(&v, isinf(guess) ? LDBL_MAX : guess, LDBL_MANT_DIG, LDBL_MIN_EXP, LDBL_MAX_EXP);
+  if ( isnan(out) ) { return out; }
+
+  if ( isinf(out) || ! (out > 0) ) { errno = ERANGE; }
+  return out;
+}
+
+/*
+  atom_t*, size_t, size_t -> double
+
+  like b10_to_ldbl, correctly rounded to the nearest double, with HUGE_VAL on
+    overflow, and NaN when memory is exhausted
+
+  rounding the long double estimate once more is usually safe, and then no
+    exact comparison is made at all: the estimate is good to about 2^-58, so
+    only values that close to a halfway point between doubles need one
+*/
+double b10_to_dbl (const atom_t* const digits, const size_t len, const size_t int_len) {
+  conv_dec_t v;
+  if ( NULL == digits || ! conv_dec_from_b10(&v, digits, len, int_len) ) {
+    return 0;
+  }
+
+  if ( conv_dec_is_short(&v) && abs(v.exp) <= CONV_DBL_EXACT_POW10 ) {
+    int32_t exp = 0;
+    const uint64_t w = conv_dec_leading(&v, &exp);
+    if ( w < ((uint64_t) 1 << DBL_MANT_DIG) ) {
+      const double p = (double) conv_exact_pow10[abs(exp)];
+      return exp >= 0 ? (double) w * p : (double) w / p;
+    }
+  }
+
+  ldbl_t out = 0;
+  if ( conv_dec_out_of_range(&v, DBL_MANT_DIG, DBL_MIN_EXP, DBL_MAX_EXP, &out) ) {
+    return (double) out;
+  }
+
+  const ldbl_t approx = conv_dec_approx(&v);
+  const double guess  = (double) approx;
+
+  if ( LDBL_MANT_DIG >= DBL_MANT_DIG + 8 && isfinite(guess) && guess > 0 ) {
+    /* the distance of the estimate from the nearest halfway point */
+    const ldbl_t off  = approx - guess;
+    const int32_t ulp_exp = off < 0
+      ? conv_ulp_below_exp(guess, DBL_MANT_DIG, DBL_MIN_EXP)
+      : conv_ulp_exp(guess, DBL_MANT_DIG, DBL_MIN_EXP);
+
+    if ( fabsl(fabsl(off) - ldexpl(1, ulp_exp - 1)) > ldexpl(approx, -58) ) {
+      return guess;
+    }
+  }
+
+  out = conv_dec_round(&v, isfinite(guess) ? guess : DBL_MAX, DBL_MANT_DIG, DBL_MIN_EXP, DBL_MAX_EXP);
+  if ( isnan(out) ) { return NAN; }
+
+  if ( out > DBL_MAX ) {
+    errno = ERANGE;
+    return HUGE_VAL;
+  }
+  if ( ! (out > 0) ) { errno = ERANGE; }
+  return (double) out;
+}
+
+/*
+  atom_t*, size_t, size_t, int, int, int -> ldbl_t
+
+  big endian base 256 digits, with int_len of them before the separator,
+    rounded to nearest (ties to even) in the target format
+
+  the value is already binary, so this only takes the leading bits, and a
+    rounding bit and a sticky bit for the rest
+*/
+static ldbl_t impl_b256_to_float (const atom_t* const digits, const size_t len, const size_t int_len, const int mant_dig, const int min_exp, const int max_exp) {
+  size_t first = 0;
+  while (first < len && 0 == digits[first]) { first++; }
+  if (first == len) { return 0; }
+
+  /* enough bytes for the significand and the rounding bit */
+  const size_t nbytes = min((size_t) (mant_dig + 2) / CHAR_BIT + 2, len - first);
+
+  limb_t m[LDBL_MANT_DIG / LIMB_BITS + 4];
+  size_t m_len = 0;
+  for (size_t i = 0; i < nbytes; i++) {
+    m_len = limb_mul_small(m, m_len, ZENZ_BASE, digits[first + i]);
+  }
+
+  bool sticky = false;
+  for (size_t i = first + nbytes; i < len && ! sticky; i++) { sticky = 0 != digits[i]; }
+
+  /* the value is m * 2^scale, and is in [2^(top - 1), 2^top); a huge array
+    (see TYP_HUGE) can put both past the range of an int32_t */
+  const int64_t bits  = (int64_t) limb_bit_length(m, m_len),
+                scale = CHAR_BIT * ((int64_t) int_len - (int64_t) (first + nbytes)),
+                top   = bits + scale;
+
+  if (top > max_exp) { errno = ERANGE; return HUGE_VALL; }
+
+  /* subnormals have fewer bits of precision */
+  const int64_t prec = mant_dig - max(min_exp - top, 0);
+  if (prec < 0) { errno = ERANGE; return 0; }
+
+  /* top is now in range, and so are the rest */
+  const int32_t drop = (int32_t) (bits - prec);
+  if (drop > 0) {
+    const bool round = limb_test_bit(m, m_len, (size_t) drop - 1);
+    for (int32_t i = 0; i + 1 < drop && ! sticky; i++) {
+      sticky = limb_test_bit(m, m_len, (size_t) i);
+    }
+
+    m_len = limb_shr(m, m, m_len, (size_t) drop);
+    if (round && (sticky || limb_test_bit(m, m_len, 0))) {
+      const limb_t one = 1;
+      m_len = limb_add(m, m, m_len, &one, 1);
+    }
+  }
+
+  /* at most mant_dig + 1 bits, so each step is exact */
+  ldbl_t out = 0;
+  for (size_t i = m_len; i--; ) { out = ldexpl(out, LIMB_BITS) + m[i]; }
+  out = ldexpl(out, (int) (scale + max(drop, 0)));
+
+  if (ilogbl(out) >= max_exp) { errno = ERANGE; return HUGE_VALL; }
+  if (! (out > 0)) { errno = ERANGE; }
+  return out;
+}
+
+/*
+  atom_t*, size_t, size_t -> ldbl_t
+
+  like b10_to_ldbl, for big endian base 256 digits
+*/
+ldbl_t b256_to_ldbl (const atom_t* const digits, const size_t len, const size_t int_len) {
+  if (NULL == digits) { return 0; }
+  return impl_b256_to_float(digits, len, int_len, LDBL_MANT_DIG, LDBL_MIN_EXP, LDBL_MAX_EXP);
+}
+
+/*
+  atom_t*, size_t, size_t -> double
+
+  like b10_to_dbl, for big endian base 256 digits
+*/
+double b256_to_dbl (const atom_t* const digits, const size_t len, const size_t int_len) {
+  if (NULL == digits) { return 0; }
+  const ldbl_t out = impl_b256_to_float(digits, len, int_len, DBL_MANT_DIG, DBL_MIN_EXP, DBL_MAX_EXP);
+  return isinf(out) ? HUGE_VAL : (double) out;
+}
+
+/*
+  bn_view_t -> ldbl_t
+
+  the value of a view as the nearest long double, honouring FL_SIGN, FL_NAN
+    and FL_INF; see b10_to_ldbl for overflow and underflow
+
+  a packed or BCD view is unpacked first, and NaN is returned if that fails
+*/
+ldbl_t view_to_ldbl (const bn_view_t v) {
+  ldbl_t out;
+  if (v.flags & FL_NAN) {
+    out = NAN;
+  } else if (v.flags & FL_INF) {
+    out = INFINITY;
+  } else if (TYP_ZENZ == v.base) {
+    out = b256_to_ldbl(v.data, view_len(v), v.int_len);
+  } else if (TYP_NONE == v.base) {
+    out = b10_to_ldbl(v.data, view_len(v), v.int_len);
+  } else {
+    size_t len = 0, int_len = 0;
+    atom_t* const digits = view_to_b10(v, &len, &int_len);
+    out = NULL == digits ? NAN : b10_to_ldbl(digits, len, int_len);
+    bn_free(digits);
+  }
+
+  return (v.flags & FL_SIGN) ? -out : out;
+}
+
+/*
+  bn_view_t -> double
+
+  like view_to_ldbl, rounded to the nearest double
+*/
+double view_to_dbl (const bn_view_t v) {
+  double out;
+  if (v.flags & FL_NAN) {
+    out = NAN;
+  } else if (v.flags & FL_INF) {
+    out = INFINITY;
+  } else if (TYP_ZENZ == v.base) {
+    out = b256_to_dbl(v.data, view_len(v), v.int_len);
+  } else if (TYP_NONE == v.base) {
+    out = b10_to_dbl(v.data, view_len(v), v.int_len);
+  } else {
+    size_t len = 0, int_len = 0;
+    atom_t* const digits = view_to_b10(v, &len, &int_len);
+    out = NULL == digits ? NAN : b10_to_dbl(digits, len, int_len);
+    bn_free(digits);
+  }
+
+  return (v.flags & FL_SIGN) ? -out : out;
+}
+
+/*
+  atom_t* -> ldbl_t
+
+  the value of a digit array as the nearest long double (see view_to_ldbl)
+*/
+ldbl_t digit_array_to_ldbl (const atom_t* const bna) {
+  return view_to_ldbl(bn_view(bna));
+}
+
+/*
+  atom_t* -> double
+
+  like digit_array_to_ldbl, rounded to the nearest double
+*/
+double digit_array_to_dbl (const atom_t* const bna) {
+  return view_to_dbl(bn_view(bna));
+}
+
+#endif /* end of include guard: LDBL_CONV_H */
@@ -0,0 +1,552 @@
+#ifndef LIMB_MATH_H
+#define LIMB_MATH_H
+
+#include "bn_common.h"
+
+/*
+  binary multi-word arithmetic on base 2^32 "limbs"
+
+  these are the exact integer kernels behind the radix and floating point
+    conversions; they are NOT digit arrays and have no header
+
+  limb arrays are little endian (limb 0 is least significant), lengths count
+    limbs, and every function returns the normalised length of its result
+    (no most significant zero limbs, so zero has length 0)
+
+  the caller always provides the storage, which must have room for the result
+*/
+
+/*
+  limb_t*, size_t -> size_t
+
+  the length of a without its most significant zero limbs
+*/
+size_t limb_normalize (const limb_t* const a, const size_t len) {
+  size_t n = len;
+  while (n && 0 == a[n - 1]) { n--; }
+  return n;
+}
+
+/*
+  limb_t*, size_t, limb_t*, size_t -> int
+
+  compare two normalised numbers: negative if a < b, 0 if equal, positive if a > b
+*/
+int limb_cmp (const limb_t* const a, const size_t a_len, const limb_t* const b, const size_t b_len) {
+  if (a_len != b_len) { return a_len > b_len ? 1 : -1; }
+
+  for (size_t i = a_len; i--; ) {
+    if (a[i] != b[i]) { return a[i] > b[i] ? 1 : -1; }
+  }
+  return 0;
+}
+
+/*
+  limb_t*, limb_t*, size_t, limb_t*, size_t -> size_t
+
+  r = a + b
+  r needs room for max(a_len, b_len) + 1 limbs, and may be a or b
+*/
+size_t limb_add (limb_t* const r, const limb_t* const a, const size_t a_len, const limb_t* const b, const size_t b_len) {
+  const limb_t* const lng = a_len >= b_len ? a : b;
+  const limb_t* const sht = a_len >= b_len ? b : a;
+  const size_t lng_len = max(a_len, b_len),
+               sht_len = min(a_len, b_len);
+
+  dlimb_t carry = 0;
+  size_t i = 0;
+  for (; i < sht_len; i++) {
+    carry += (dlimb_t) lng[i] + sht[i];
+    r[i]   = (limb_t) carry;
+    carry >>= LIMB_BITS;
+  }
+  for (; i < lng_len; i++) {
+    carry += lng[i];
+    r[i]   = (limb_t) carry;
+    carry >>= LIMB_BITS;
+  }
+
+  if (carry) { r[i++] = (limb_t) carry; }
+  return i;
+}
+
+/*
+  limb_t*, limb_t*, size_t, limb_t*, size_t -> size_t
+
+  r = a - b, where a must not be less than b
+  r needs room for a_len limbs, and may be a or b
+*/
+size_t limb_sub (limb_t* const r, const limb_t* const a, const size_t a_len, const limb_t* const b, const size_t b_len) {
+  limb_t borrow = 0;
+  for (size_t i = 0; i < a_len; i++) {
+    const dlimb_t sub = (dlimb_t) (i < b_len ? b[i] : 0) + borrow;
+    borrow = a[i] < sub;
+    r[i]   = (limb_t) (a[i] - sub);
+  }
+  return limb_normalize(r, a_len);
+}
+
+/*
+  limb_t*, size_t, limb_t, limb_t -> size_t
+
+  a = a * m + add, in place
+  a needs room for len + 1 limbs
+*/
+size_t limb_mul_small (limb_t* const a, const size_t len, const limb_t m, const limb_t add) {
+  dlimb_t carry = add;
+  for (size_t i = 0; i < len; i++) {
+    carry += (dlimb_t) a[i] * m;
+    a[i]   = (limb_t) carry;
+    carry >>= LIMB_BITS;
+  }
+
+  size_t n = len;
+  if (carry) { a[n++] = (limb_t) carry; }
+  return n;
+}
+
+/*
+  limb_t*, size_t, limb_t, size_t* -> limb_t
+
+  a = a / d, in place, returning a % d
+  the new length of a is written to out_len
+*/
+limb_t limb_divmod_small (limb_t* const a, const size_t len, const limb_t d, size_t* const out_len) {
+  dlimb_t rem = 0;
+  for (size_t i = len; i--; ) {
+    rem  = (rem << LIMB_BITS) | a[i];
+    a[i] = (limb_t) (rem / d);
+    rem %= d;
+  }
+  set_out_param(out_len, limb_normalize(a, len));
+  return (limb_t) rem;
+}
+
+/*
+  limb_t*, size_t, uint32_t -> size_t
+
+  a = a * 10^exp, in place
+  a needs room for len + 1 + (exp * log2(10)) / 32 limbs
+*/
+size_t limb_mul_pow10 (limb_t* const a, const size_t len, const uint32_t exp) {
+  size_t n = len;
+  uint32_t left = exp;
+
+  /* the largest power of 10 in a limb is 10^9 */
+  for (; left >= 9; left -= 9) {
+    n = limb_mul_small(a, n, 1000000000U, 0);
+  }
+
+  static const limb_t small_pow10[9] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+  if (left) { n = limb_mul_small(a, n, small_pow10[left], 0); }
+
+  return n;
+}
+
+/*
+  limb_t*, size_t, uint32_t -> size_t
+
+  a = a * 5^exp, in place; with a shift, this is the odd half of a power of 10
+  a needs room for len + 1 + (exp * log2(5)) / 32 limbs
+*/
+size_t limb_mul_pow5 (limb_t* const a, const size_t len, const uint32_t exp) {
+  size_t n = len;
+  uint32_t left = exp;
+
+  /* the largest power of 5 in a limb is 5^13 */
+  for (; left >= 13; left -= 13) {
+    n = limb_mul_small(a, n, 1220703125U, 0);
+  }
+
+  static const limb_t small_pow5[13] = { 1, 5, 25, 125, 625, 3125, 15625, 78125, 390625, 1953125, 9765625, 48828125, 244140625 };
+  if (left) { n = limb_mul_small(a, n, small_pow5[left], 0); }
+
+  return n;
+}
+
+/* below this many limbs, schoolbook multiplication is faster than Karatsuba */
+#ifndef LIMB_KARATSUBA_CUTOFF
+  #define LIMB_KARATSUBA_CUTOFF 32
+#endif
+
+/*
+  limb_t*, limb_t*, size_t, limb_t*, size_t -> void
+
+  r = a * b, all of its a_len + b_len limbs, normalised or not
+*/
+static void limb_mul_school (limb_t* const r, const limb_t* const a, const size_t a_len, const limb_t* const b, const size_t b_len) {
+  memset(r, 0, sz(limb_t, a_len + b_len));
+
+  for (size_t j = 0; j < b_len; j++) {
+    dlimb_t carry = 0;
+    for (size_t i = 0; i < a_len; i++) {
+      carry   += (dlimb_t) a[i] * b[j] + r[i + j];
+      r[i + j] = (limb_t) carry;
+      carry  >>= LIMB_BITS;
+    }
+    r[a_len + j] = (limb_t) carry;
+  }
+}
+
+/* the scratch limbs that limb_karatsuba needs for n limbs */
+static size_t limb_karatsuba_scratch (const size_t n) {
+  if (n < LIMB_KARATSUBA_CUTOFF) { return 0; }
+
+  const size_t hi = n - n / 2 + 1;
+  return 4 * hi + limb_karatsuba_scratch(hi);
+}
+
+/*
+  limb_t*, limb_t*, limb_t*, size_t, limb_t* -> void
+
+  r = a * b, all of its 2n limbs, for two n limb numbers, normalised or not,
+    in three half size products instead of four
+
+  scratch has room for limb_karatsuba_scratch(n) limbs
+*/
+static void limb_karatsuba (limb_t* const r, const limb_t* const a, const limb_t* const b, const size_t n, limb_t* const scratch) {
+  if (n < LIMB_KARATSUBA_CUTOFF) {
+    limb_mul_school(r, a, n, b, n);
+    return;
+  }
+
+  /* a = a1 * B^lo + a0, and the same for b */
+  const size_t lo = n / 2, hi = n - lo;
+
+  /* a0 * b0 and a1 * b1 go straight into their places */
+  limb_karatsuba(r, a, b, lo, scratch);
+  limb_karatsuba(r + 2 * lo, a + lo, b + lo, hi, scratch);
+
+  /* (a0 + a1) * (b0 + b1), each sum in hi + 1 limbs */
+  limb_t* const sa  = scratch,
+        * const sb  = sa + hi + 1,
+        * const mid = sb + hi + 1;
+
+  memset(sa, 0, sz(limb_t, 2 * (hi + 1)));
+  limb_add(sa, a + lo, hi, a, lo);
+  limb_add(sb, b + lo, hi, b, lo);
+  limb_karatsuba(mid, sa, sb, hi + 1, mid + 2 * (hi + 1));
+
+  /* less a0 * b0 and a1 * b1 is a0 * b1 + a1 * b0, which goes in the middle */
+  size_t mid_len = limb_normalize(mid, 2 * (hi + 1));
+  mid_len = limb_sub(mid, mid, mid_len, r, limb_normalize(r, 2 * lo));
+  mid_len = limb_sub(mid, mid, mid_len, r + 2 * lo, limb_normalize(r + 2 * lo, 2 * hi));
+
+  limb_add(r + lo, r + lo, 2 * n - lo, mid, mid_len);
+}
+
+/*
+  limb_t*, limb_t*, size_t, limb_t*, size_t -> size_t
+
+  r = a * b, with Karatsuba multiplication from LIMB_KARATSUBA_CUTOFF limbs
+  r needs room for a_len + b_len limbs, and may not be a or b
+
+  0 is also returned if memory for the products of large numbers is exhausted
+*/
+size_t limb_mul (limb_t* const r, const limb_t* const a, const size_t a_len, const limb_t* const b, const size_t b_len) {
+  /* the longer one is cut into pieces the size of the shorter one */
+  const limb_t* const lng = a_len >= b_len ? a : b;
+  const limb_t* const sht = a_len >= b_len ? b : a;
+  const size_t lng_len = max(a_len, b_len),
+               sht_len = min(a_len, b_len);
+
+  if (sht_len < LIMB_KARATSUBA_CUTOFF) {
+    limb_mul_school(r, lng, lng_len, sht, sht_len);
+    return limb_normalize(r, lng_len + sht_len);
+  }
+
+  const scratch_mark_t mark = scratch_mark();
+  limb_t* const piece = salloc(limb_t, 2 * sht_len + limb_karatsuba_scratch(sht_len));
+  if (NULL == piece) { return 0; }
+
+  memset(r, 0, sz(limb_t, lng_len + sht_len));
+  for (size_t at = 0; at < lng_len; at += sht_len) {
+    const size_t piece_len = min(sht_len, lng_len - at);
+
+    if (piece_len == sht_len) {
+      limb_karatsuba(piece, lng + at, sht, sht_len, piece + 2 * sht_len);
+    } else {
+      limb_mul(piece, sht, sht_len, lng + at, piece_len);
+    }
+    limb_add(r + at, r + at, lng_len + sht_len - at, piece, limb_normalize(piece, sht_len + piece_len));
+  }
+  scratch_reset(mark);
+
+  return limb_normalize(r, lng_len + sht_len);
+}
+
+/* above this many limbs, a reciprocal starts from that of its top half */
+#ifndef LIMB_RECIP_CUTOFF
+  #define LIMB_RECIP_CUTOFF 16
+#endif
+
+/*
+  limb_t*, limb_t*, size_t -> size_t
+
+  v = B^(2 d_len) / d, rounded down, for a normalised d of d_len limbs (where B
+    is 2^32), by Newton's iteration, so that division by d becomes
+    multiplication (see limb_div_reciprocal)
+
+  v needs room for d_len + 2 limbs
+  0 is returned if memory is exhausted
+*/
+size_t limb_reciprocal (limb_t* const v, const limb_t* const d, const size_t d_len) {
+  /* B^(2 d_len), and room for the products */
+  const size_t one_len = 2 * d_len + 1;
+  const scratch_mark_t mark = scratch_mark();
+  limb_t* const one  = zsalloc(limb_t, one_len);
+  limb_t* const prod = salloc(limb_t, 2 * one_len + 4);
+  limb_t* const err  = salloc(limb_t, one_len);
+
+  if (NULL == one || NULL == prod || NULL == err) {
+    scratch_reset(mark);
+    return 0;
+  }
+  one[2 * d_len] = 1;
+
+  /*
+    start from below: B^(d_len + h) / (top + 1) is at most the answer, where
+      top is the h most significant limbs of d; for long numbers its reciprocal
+      is found in the same way, and is right to almost 2 h limbs, so one or
+      two steps at full length are enough
+  */
+  const size_t h = d_len > LIMB_RECIP_CUTOFF ? d_len / 2 + 2 : 1;
+  memset(v, 0, sz(limb_t, d_len + 2));
+  size_t v_len = 0;
+
+  const limb_t unit = 1;
+  const scratch_mark_t top_mark = scratch_mark();
+  limb_t* const top = h > 1 ? salloc(limb_t, h + 1) : NULL;
+  limb_t* const vh  = h > 1 ? salloc(limb_t, h + 2) : NULL;
+
+  /* top + 1 must still have h limbs */
+  if (NULL != top && NULL != vh && limb_add(top, d + d_len - h, h, &unit, 1) == h) {
+    const size_t vh_len = limb_reciprocal(vh, top, h);
+
+    memcpy(v + d_len - h, vh, sz(limb_t, vh_len));
+    v_len = limb_normalize(v, d_len - h + vh_len);
+  }
+  scratch_reset(top_mark);
+
+  if (! v_len) {
+    /* with the top limb: v <= B^(d_len + 1) / (top + 1) */
+    const dlimb_t start = (dlimb_t) -1 / ((dlimb_t) d[d_len - 1] + 1);
+    v[d_len - 1] = (limb_t) start;
+    v[d_len]     = (limb_t) (start >> LIMB_BITS);
+    v_len = limb_normalize(v, d_len + 2);
+  }
+
+  /*
+    v += v * (B^(2 d_len) - d * v) / B^(2 d_len), which never passes the
+      answer, and doubles the correct bits each time
+  */
+  size_t err_len = 0;
+  while (true) {
+    /* neither d nor v is zero, so neither is their product */
+    const size_t dv_len = limb_mul(prod, d, d_len, v, v_len);
+    if (! dv_len) {
+      scratch_reset(mark);
+      return 0;
+    }
+    err_len = limb_sub(err, one, one_len, prod, dv_len);
+
+    if (limb_cmp(err, err_len, d, d_len) < 0) { break; }
+
+    const size_t ve_len = limb_mul(prod, v, v_len, err, err_len);
+    if (! ve_len) {
+      scratch_reset(mark);
+      return 0;
+    }
+
+    const size_t step_len = limb_shr(prod, prod, ve_len, 2 * d_len * LIMB_BITS);
+    if (! step_len) { break; }
+
+    v_len = limb_add(v, v, v_len, prod, step_len);
+  }
+
+  /* the last few steps round down, so finish one at a time */
+  while (limb_cmp(err, err_len, d, d_len) >= 0) {
+    v_len   = limb_add(v, v, v_len, &unit, 1);
+    err_len = limb_sub(err, err, err_len, d, d_len);
+  }
+
+  scratch_reset(mark);
+  return v_len;
+}
+
+/*
+  limb_t*, limb_t*, size_t*, limb_t*, size_t, limb_t*, size_t, limb_t*, size_t -> size_t
+
+  q = n / d and r = n % d, with v from limb_reciprocal(v, d, d_len), for an n
+    below B^(2 d_len); the length of q is returned, and that of r is written
+    to r_len
+
+  q needs room for d_len + 3 limbs, and r for n_len + 1
+
+  (size_t) -1 is returned if memory is exhausted
+*/
+size_t limb_div_reciprocal (limb_t* const q, limb_t* const r, size_t* const r_len, const limb_t* const n, const size_t n_len, const limb_t* const d, const size_t d_len, const limb_t* const v, const size_t v_len) {
+  const scratch_mark_t mark = scratch_mark();
+  limb_t* const prod = salloc(limb_t, n_len + v_len + 1);
+  if (NULL == prod) { return (size_t) -1; }
+
+  /* at most 2 less than the quotient, since v is at most 1 less than B^(2 d_len) / d */
+  size_t q_len = limb_shr(prod, prod, limb_mul(prod, n, n_len, v, v_len), 2 * d_len * LIMB_BITS);
+  memcpy(q, prod, sz(limb_t, q_len));
+
+  size_t rem_len = n_len;
+  memcpy(r, n, sz(limb_t, n_len));
+  rem_len = limb_sub(r, r, limb_normalize(r, rem_len), prod, limb_mul(prod, q, q_len, d, d_len));
+
+  while (limb_cmp(r, rem_len, d, d_len) >= 0) {
+    const limb_t unit = 1;
+    q_len   = limb_add(q, q, q_len, &unit, 1);
+    rem_len = limb_sub(r, r, rem_len, d, d_len);
+  }
+  scratch_reset(mark);
+
+  set_out_param(r_len, rem_len);
+  return q_len;
+}
+
+/*
+  limb_t*, limb_t*, size_t, limb_t*, size_t -> size_t
+
+  q = n / d, for numbers of any length, with the reciprocal of d; the length
+    of q is returned, and d must not be zero
+
+  q needs room for max(n_len, d_len) + 3 limbs
+
+  (size_t) -1 is returned if memory is exhausted
+*/
+size_t limb_div (limb_t* const q, const limb_t* const n, const size_t n_len, const limb_t* const d, const size_t d_len) {
+  const size_t nn = limb_normalize(n, n_len),
+               dn = limb_normalize(d, d_len);
+
+  if (limb_cmp(n, nn, d, dn) < 0) { return 0; }
+
+  /* limb_div_reciprocal needs n below B^(2 d_len), so both move up s limbs */
+  const size_t s = nn > 2 * dn ? nn - 2 * dn : 0;
+
+  const scratch_mark_t mark = scratch_mark();
+  limb_t* const ns = zsalloc(limb_t, nn + s),
+        * const ds = zsalloc(limb_t, dn + s),
+        * const v  = salloc(limb_t, dn + s + 2),
+        * const r  = salloc(limb_t, nn + s + 1);
+
+  size_t q_len = (size_t) -1;
+
+  if (NULL != ns && NULL != ds && NULL != v && NULL != r) {
+    memcpy(ns + s, n, sz(limb_t, nn));
+    memcpy(ds + s, d, sz(limb_t, dn));
+
+    const size_t v_len = limb_reciprocal(v, ds, dn + s);
+    if (v_len) {
+      q_len = limb_div_reciprocal(q, r, NULL, ns, nn + s, ds, dn + s, v, v_len);
+    }
+  }
+
+  scratch_reset(mark);
+  return q_len;
+}
+
+/* below this exponent, powers of 5 are built up a limb at a time */
+#ifndef LIMB_POW5_CUTOFF
+  #define LIMB_POW5_CUTOFF 512
+#endif
+
+/*
+  limb_t*, size_t -> size_t
+
+  r = 5^exp, by squaring, so that it takes a few multiplications of the size
+    of the result rather than exp / 13 small ones
+  r needs room for exp / 13 + 3 limbs
+
+  0 is returned if memory is exhausted
+*/
+size_t limb_pow5 (limb_t* const r, const size_t exp) {
+  if (exp <= LIMB_POW5_CUTOFF) {
+    r[0] = 1;
+    return limb_mul_pow5(r, 1, (uint32_t) exp);
+  }
+
+  const scratch_mark_t mark = scratch_mark();
+  limb_t* const half = salloc(limb_t, exp / 2 / 13 + 3);
+  if (NULL == half) { return 0; }
+
+  const size_t half_len = limb_pow5(half, exp / 2);
+  size_t n = half_len ? limb_mul(r, half, half_len, half, half_len) : 0;
+  scratch_reset(mark);
+
+  if (n && exp % 2) { n = limb_mul_small(r, n, 5, 0); }
+  return n;
+}
+
+/*
+  limb_t*, limb_t*, size_t, size_t -> size_t
+
+  r = a * 2^bits
+  r needs room for len + 1 + bits / 32 limbs, and may be a
+*/
+size_t limb_shl (limb_t* const r, const limb_t* const a, const size_t len, const size_t bits) {
+  if (! len) { return 0; }
+
+  const size_t   words = bits / LIMB_BITS;
+  const unsigned shift = (unsigned) (bits % LIMB_BITS);
+
+  /* high to low, so that r may alias a */
+  r[len + words] = shift ? (limb_t) (a[len - 1] >> (LIMB_BITS - shift)) : 0;
+  for (size_t i = len; i--; ) {
+    const limb_t lower = (shift && i) ? (limb_t) (a[i - 1] >> (LIMB_BITS - shift)) : 0;
+    r[i + words] = (limb_t) (a[i] << shift) | lower;
+  }
+  memset(r, 0, sz(limb_t, words));
+
+  return limb_normalize(r, len + words + 1);
+}
+
+/*
+  limb_t*, limb_t*, size_t, size_t -> size_t
+
+  r = a / 2^bits, discarding the bits shifted out
+  r needs room for len limbs, and may be a
+*/
+size_t limb_shr (limb_t* const r, const limb_t* const a, const size_t len, const size_t bits) {
+  const size_t   words = bits / LIMB_BITS;
+  const unsigned shift = (unsigned) (bits % LIMB_BITS);
+
+  if (words >= len) { return 0; }
+
+  const size_t n = len - words;
+  for (size_t i = 0; i < n; i++) {
+    const limb_t upper = (shift && i + 1 < n) ? (limb_t) (a[i + words + 1] << (LIMB_BITS - shift)) : 0;
+    r[i] = (limb_t) (a[i + words] >> shift) | upper;
+  }
+
+  return limb_normalize(r, n);
+}
+
+/*
+  limb_t*, size_t -> size_t
+
+  the number of significant bits in a normalised number, 0 for zero
+*/
+size_t limb_bit_length (const limb_t* const a, const size_t len) {
+  if (! len) { return 0; }
+
+  size_t bits = (len - 1) * LIMB_BITS;
+  for (limb_t top = a[len - 1]; top; top >>= 1) { bits++; }
+  return bits;
+}
+
+/*
+  limb_t*, size_t, size_t -> bool
+
+  whether bit number bit (0 is least significant) of a is set
+*/
+bool limb_test_bit (const limb_t* const a, const size_t len, const size_t bit) {
+  const size_t word = bit / LIMB_BITS;
+  return word < len && ((a[word] >> (bit % LIMB_BITS)) & 1);
+}
+
+#endif /* end of include guard: LIMB_MATH_H */
@@ -5,60 +5,83 @@
 /* simple unsigned real number math */
 
 
-static atom_t* impl_pred_b10_int (const atom_t* const n, const uint16_t len, uint16_t* const out_len) {
-  // last digit is not 0
-  if (0 != n[len - 1]) {
-    set_out_param(out_len, len);
-    // only the last digit changes, so copy all the preceding digits
-    atom_t* const result = (atom_t*) memcpy(alloc(atom_t, len), n, (uint16_t) (len - 1));
-    // then take 1
-    result[len - 1] = (atom_t) ((atom_t) n[len - 1] - 1);
-    return result;
-  } else {
-
-    atom_t* const z = zalloc(atom_t, 1);
-    const uint16_t count_leading_digits = array_span(n, len, false, z, 1);
-    free(z);
-
-    atom_t* const pred_leading_digits = (atom_t*) memcpy(alloc(atom_t, count_leading_digits), n, count_leading_digits);
-    pred_leading_digits[count_leading_digits - 1] = (atom_t) (pred_leading_digits[count_leading_digits - 1] - 1);
+/*
+  the _into functions write their result into the caller's array out, which
+    has room for cap digits, and never allocate; out may be the same array as
+    the input. their lengths are size_t, so they work on arrays of any size
+    (see TYP_HUGE), while the allocating ones keep the uint16_t of TYP_BIG
 
-    const uint16_t count_trailing_zeroes = (uint16_t) (len - count_leading_digits);
-    atom_t* const nines = (atom_t*) memset(alloc(atom_t, count_trailing_zeroes), 9, count_trailing_zeroes);
+  the return value is the number of digits in the result, and like
+    b10_to_ldbl_digits_into, nothing is written unless cap is at least that,
+    so calling with out = NULL and cap = 0 asks for the size to allocate
 
-    atom_t* const all_digits = array_concat(pred_leading_digits, count_leading_digits, nines, count_trailing_zeroes);
+  0 is returned for what is not implemented yet
+*/
 
-    free(nines), free(pred_leading_digits);
+static size_t impl_pred_b10_int_into (atom_t* const out, const size_t cap, const atom_t* const n, const size_t len) {
+  // take 1 from the last digit that is not 0, and the 0s after it become 9s
+  size_t last = len - 1U;
+  while (last && 0 == n[last]) { last--; }
+  const atom_t at_last = (atom_t) (n[last] - 1);
 
-    atom_t* const final = array_trim_leading_zeroes_simple(all_digits, len, out_len);
+  // taking 1 may leave leading zeroes, but keep at least one digit
+  size_t lead = 0;
+  while (lead < last && 0 == n[lead]) { lead++; }
+  if (lead == last && 0 == at_last && last + 1 < len) { lead++; }
 
-    free(all_digits);
+  const size_t need = len - lead;
+  if (NULL == out || cap < need) { return need; }
 
-    return final;
+  if (lead <= last) {
+    memmove(out, n + lead, last - lead);
+    out[last - lead] = at_last;
   }
+  memset(out + (last + 1 - lead), 9, len - 1 - last);
+  return need;
 }
 
-static atom_t* impl_pred_b10_flot (const atom_t* const n, const uint16_t len, const uint16_t int_len, const uint16_t precision, uint16_t* const out_len, uint16_t* const out_int_len) {
+static size_t impl_pred_b10_flot_into (atom_t* const out, const size_t cap, const atom_t* const n, const size_t len, const size_t int_len, const size_t precision) {
   // going to traverse one more than int_len
   // preicision may be 0 to subtract 1 from a real
-  const uint16_t focus_digit = (uint16_t) ((int_len + precision) - 1);
+  const size_t focus_digit = int_len + precision - 1;
   if ( 0 != n[focus_digit] ) {
     // simple case: digit of interest is not 0
     // length doesn't change
-    set_out_param(out_len, len);
-    set_out_param(out_int_len, int_len);
-    // copy the input entirely
-    atom_t* const result = (atom_t*) memcpy(alloc(atom_t, len), n, len);
-    // then take 1
-    result[focus_digit] = (atom_t) (n[focus_digit] - 1);
-    return result;
+    if (NULL == out || cap < len) { return len; }
+    // copy the input entirely, then take 1
+    const atom_t focus = (atom_t) (n[focus_digit] - 1);
+    memmove(out, n, len);
+    out[focus_digit] = focus;
+    return len;
   } else {
     // the digit in focus is 0
     // we need to figure out what other digits are 0
     // taking 1 from a digit only affects the digits more significant than it
     puts("UNIMPLEMENTED");
 
-    return NULL;
+    return 0;
+  }
+}
+
+/*
+  atom_t*, size_t, atom_t*, size_t, size_t, size_t -> size_t, size_t
+
+  pred_b10, into the caller's array (see above)
+*/
+size_t pred_b10_into (atom_t* const out, const size_t cap, const atom_t* const n, const size_t len, const size_t int_len, const size_t precision, size_t* const out_int_len) {
+  if ( len < int_len || raw_is_zero(n, len) ) {
+    set_out_param(out_int_len, 1);
+    if (NULL != out && cap) { out[0] = 0; }
+    return 1;
+  }
+
+  if (len == int_len && 0 == precision) {
+    const size_t need = impl_pred_b10_int_into(out, cap, n, len);
+    set_out_param(out_int_len, need);
+    return need;
+  } else {
+    set_out_param(out_int_len, int_len);
+    return impl_pred_b10_flot_into(out, cap, n, len, int_len, precision);
   }
 }
 
@@ -81,88 +104,75 @@ static atom_t* impl_pred_b10_flot (const atom_t* const n, const uint16_t len, co
     before 0.99 pr=2 is 0.98
 */
 atom_t* pred_b10 (const atom_t* const n, const uint16_t len, const uint16_t int_len, const uint16_t precision, uint16_t* const out_len, uint16_t* const out_int_len) {
-  if ( len < int_len || raw_is_zero(n, len) ) {
-    set_out_param(out_len, 0);
-    return zalloc(atom_t, 1);
-  }
+  size_t need_int = 0;
+  const size_t need = pred_b10_into(NULL, 0, n, len, int_len, precision, &need_int);
+  set_out_param(out_len, (uint16_t) need);
+  set_out_param(out_int_len, (uint16_t) need_int);
+  if (! need) { return NULL; }
+
+  atom_t* const result = alloc(atom_t, need);
+  if (NULL != result) { pred_b10_into(result, need, n, len, int_len, precision, NULL); }
+  return result;
+}
 
-  if (len == int_len && 0 == precision) {
-    return impl_pred_b10_int(n, len, out_len);
-  } else {
-    return impl_pred_b10_flot(n, len, int_len, precision, out_len, out_int_len);
+static size_t impl_succ_b10_int_into (atom_t* const out, const size_t cap, const atom_t* const n, const size_t len) {
+  // count trailing nines, which all become 0s
+  size_t nines = 0;
+  while (nines < len && 9 == n[len - 1 - nines]) { nines++; }
+
+  if (nines == len) {
+    // all nines, so one more digit: 1 then 0s
+    if (NULL == out || cap <= len) { return len + 1; }
+    out[0] = 1;
+    memset(out + 1, 0, len);
+    return len + 1;
   }
-}
 
-static atom_t* impl_succ_b10_int (const atom_t* const n, const uint16_t len, uint16_t* const out_len) {
-  if (9 != n[len - 1]) {
-    // just add 1 to last digit
-    set_out_param(out_len, len);
-    // copy the input entirely
-    atom_t* const result = (atom_t*) memcpy(alloc(atom_t, len), n, len);
-    // then add 1
-    result[len - 1] = (atom_t) (n[len - 1] + 1);
-    return result;
-  } else {
+  if (NULL == out || cap < len) { return len; }
 
-    atom_t* const reversed = array_reverse(n, len);
-    atom_t* const nine = memset(alloc(atom_t, 1), 9, 1);
-    // count trailing nines
-    const uint16_t count_nines = array_span(reversed, len, true, nine, 1);
-    free(nine), free(reversed);
-
-    const uint16_t other_digits_pre_len = (uint16_t) (len - count_nines);
-    const uint16_t other_digits_len = 0 == other_digits_pre_len ? 1 : other_digits_pre_len;
-
-    atom_t* const zeroes = zalloc(atom_t, count_nines);
-    atom_t* other_digits;
-
-    if (0 == other_digits_pre_len) {
-      // other_digits_len is 1 for a certain reason here
-      atom_t* const one_zero = zalloc(atom_t, 1);
-      other_digits = memcpy(alloc(atom_t, other_digits_len), one_zero, other_digits_len);
-      free(one_zero);
-      set_out_param(out_len, (uint16_t) (len + 1));
-    } else {
-      // other_digits_len might be 1 here
-      other_digits = memcpy(alloc(atom_t, other_digits_len), reversed, other_digits_len);
-      set_out_param(out_len, len);
-    }
+  // add 1 to the last digit that is not 9
+  const atom_t bumped = (atom_t) (n[len - 1 - nines] + 1);
+  memmove(out, n, len - 1 - nines);
+  out[len - 1 - nines] = bumped;
+  memset(out + len - nines, 0, nines);
+  return len;
+}
 
-    // add 1 to the last non-nine digit
-    other_digits[other_digits_len - 1] = (atom_t) (other_digits[other_digits_len - 1] + 1);
+/*
+  atom_t*, size_t, atom_t*, size_t, size_t, size_t -> size_t, size_t
 
-    atom_t* const result = array_concat(other_digits, other_digits_len, zeroes, count_nines);
-    free(zeroes), free(other_digits);
-    return result;
+  succ_b10, into the caller's array (see above)
+*/
+size_t succ_b10_into (atom_t* const out, const size_t cap, const atom_t* const n, const size_t len, const size_t int_len, const size_t precision, size_t* const out_int_len) {
+  if ( len < int_len || raw_is_zero(n, len) ) {
+    set_out_param(out_int_len, 1);
+    if (NULL != out && cap) { out[0] = 1; }
+    return 1;
   }
-}
 
-static atom_t* impl_succ_b10_flot (const atom_t* const n, const uint16_t len, const uint16_t int_len, const uint16_t precision, uint16_t* const out_len, uint16_t* const out_int_len) {
-  (void) n;
-  (void) len;
-  (void) precision;
-  (void) int_len;
-  (void) out_len;
-  (void) out_int_len;
-  return NULL;
+  if (len == int_len && 0 == precision) {
+    const size_t need = impl_succ_b10_int_into(out, cap, n, len);
+    set_out_param(out_int_len, need);
+    return need;
+  }
+
+  // the number after a real is not implemented yet
+  return 0;
 }
 
 /*
   atom_t*, uint16_t -> atom_t*, uint16_t
 */
 atom_t* succ_b10 (const atom_t* const n, const uint16_t len, const uint16_t int_len, const uint16_t precision, uint16_t* const out_len, uint16_t* const out_int_len) {
-  if ( len < int_len || raw_is_zero(n, len) ) {
-    set_out_param(out_len, 1);
-    atom_t* const res = alloc(atom_t, 1);
-    res[0] = 1;
-    return res;
-  }
-
-  if (len == int_len && 0 == precision) {
-    return impl_succ_b10_int(n, len, out_len);
-  } else {
-    return impl_succ_b10_flot(n, len, int_len, precision, out_len, out_int_len);
-  }
+  size_t need_int = 0;
+  const size_t need = succ_b10_into(NULL, 0, n, len, int_len, precision, &need_int);
+  set_out_param(out_len, (uint16_t) need);
+  set_out_param(out_int_len, (uint16_t) need_int);
+  if (! need) { return NULL; }
+
+  atom_t* const result = alloc(atom_t, need);
+  if (NULL != result) { succ_b10_into(result, need, n, len, int_len, precision, NULL); }
+  return result;
 }
 
 atom_t* add_b10 (const atom_t* const a, const uint16_t a_len, const uint16_t a_int_len, const atom_t* const b, const uint16_t b_len, const uint16_t b_int_len, uint16_t* const out_len, uint16_t* const out_int_len) {
@@ -289,7 +299,7 @@ static atom_t* impl_factorial_b10 (const atom_t* const n, const uint16_t len, ui
   while ( cmp_b10(i, i_len, i_len, zero, 1, 1) ) {
 
     atom_t* const temp_mul_holder = array_copy(mul_holder, mul_holder_len);
-    free(mul_holder);
+    bn_free(mul_holder);
     mul_holder = mul_b10(temp_mul_holder, mul_holder_len, mul_holder_len, i, i_len, i_len, &mul_holder_len, NULL);
 
     i = pred_b10(i, i_len, i_len, 0, &i_len, NULL);
@@ -311,34 +321,74 @@ atom_t* recip_b10 (const atom_t* const n, const uint16_t len, const uint16_t int
 
   atom_t* const recip = div_b10(one, 1, 1, n, len, int_len, out_len, out_int_len);
 
-  free(one);
+  bn_free(one);
 
   return recip;
 }
 
-atom_t* floor_b10 (const atom_t* const n, const uint16_t len, const uint16_t int_len, uint16_t* const out_len, uint16_t* const out_int_len) {
-  if (0 == (len + int_len) || len < int_len || NULL == n || raw_is_zero(n, len)) {
-    set_out_param(out_len, 1);
-    set_out_param(out_int_len, 1);
-    return zalloc(atom_t, 1);
+/*
+  atom_t*, size_t, atom_t*, size_t, size_t -> size_t, size_t
+
+  floor_b10, into the caller's array (see above)
+*/
+size_t floor_b10_into (atom_t* const out, const size_t cap, const atom_t* const n, const size_t len, const size_t int_len, size_t* const out_int_len) {
+  set_out_param(out_int_len, 1);
+  if (0 == int_len || len < int_len || NULL == n || raw_is_zero(n, int_len)) {
+    if (NULL != out && cap) { out[0] = 0; }
+    return 1;
   }
-  set_out_param(out_len, int_len);
+
   set_out_param(out_int_len, int_len);
+  if (NULL != out && cap >= int_len) { memmove(out, n, int_len); }
+  return int_len;
+}
+
+atom_t* floor_b10 (const atom_t* const n, const uint16_t len, const uint16_t int_len, uint16_t* const out_len, uint16_t* const out_int_len) {
+  size_t need_int = 0;
+  const size_t need = floor_b10_into(NULL, 0, n, len, int_len, &need_int);
+  set_out_param(out_len, (uint16_t) need);
+  set_out_param(out_int_len, (uint16_t) need_int);
 
-  return memcpy(alloc(atom_t, int_len), n, int_len);
+  atom_t* const result = alloc(atom_t, need);
+  if (NULL != result) { floor_b10_into(result, need, n, len, int_len, NULL); }
+  return result;
 }
 
-atom_t* ceil_b10 (const atom_t* const n, const uint16_t len, const uint16_t int_len, uint16_t* const out_len, uint16_t* const out_int_len) {
-  if (0 == (len + int_len) || len < int_len || NULL == n || raw_is_zero(n, len)) {
-    set_out_param(out_len, 1);
+/*
+  atom_t*, size_t, atom_t*, size_t, size_t -> size_t, size_t
+
+  ceil_b10, into the caller's array (see above)
+*/
+size_t ceil_b10_into (atom_t* const out, const size_t cap, const atom_t* const n, const size_t len, const size_t int_len, size_t* const out_int_len) {
+  if (0 == len || len < int_len || NULL == n || raw_is_zero(n, len)) {
     set_out_param(out_int_len, 1);
-    return zalloc(atom_t, 1);
+    if (NULL != out && cap) { out[0] = 0; }
+    return 1;
+  }
+
+  // an integer is its own ceiling
+  if (raw_is_zero(n + int_len, len - int_len)) {
+    return floor_b10_into(out, cap, n, len, int_len, out_int_len);
   }
 
   // next integer
-  return succ_b10(n, int_len, int_len, 0, out_len, out_len);
+  return succ_b10_into(out, cap, n, int_len, int_len, 0, out_int_len);
 }
 
+atom_t* ceil_b10 (const atom_t* const n, const uint16_t len, const uint16_t int_len, uint16_t* const out_len, uint16_t* const out_int_len) {
+  size_t need_int = 0;
+  const size_t need = ceil_b10_into(NULL, 0, n, len, int_len, &need_int);
+  set_out_param(out_len, (uint16_t) need);
+  set_out_param(out_int_len, (uint16_t) need_int);
+
+  atom_t* const result = alloc(atom_t, need);
+  if (NULL != result) { ceil_b10_into(result, need, n, len, int_len, NULL); }
+  return result;
+}
+
+// power counts up by 2 from 1, so a uint16_t of iterations keeps it under 7 digits
+#define LOG_B10_POWER_CAP 8
+
 // i would like 10 digits of precision. is that too much to ask?
 atom_t* impl_log_b10(const atom_t* const n, const uint16_t n_len, const uint16_t n_int_len, uint16_t* const out_len, uint16_t* const out_int_len, const uint16_t iterations) {
 
@@ -358,9 +408,11 @@ atom_t* impl_log_b10(const atom_t* const n, const uint16_t n_len, const uint16_t
     n_pred_len = 0, n_pred_int_len = 0,
     n_pred_sq_len = 0, n_pred_sq_int_len = 0,
     run_mul_len = 0, run_mul_int_len = 0,
-    power_len = 0, power_int_len = 0,
     y_len = 0, y_int_len = 0;
 
+  /* the power is stepped by the _into functions, whose lengths are size_t */
+  size_t power_len = 0, power_int_len = 0;
+
   /*
     number variable declarations
 
@@ -368,7 +420,7 @@ atom_t* impl_log_b10(const atom_t* const n, const uint16_t n_len, const uint16_t
   */
   atom_t* const zero = zalloc(atom_t, 1),
         * total = array_copy(zero, 1),
-        * power = succ_b10(zero, 1, 1, 0, &power_len, &power_int_len),
+        * const power = alloc(atom_t, LOG_B10_POWER_CAP),
         * y = array_copy(zero, 1),
 
         * const n_succ = succ_b10(n, n_len, n_int_len, 0, &n_succ_len, &n_succ_int_len),
@@ -378,53 +430,54 @@ atom_t* impl_log_b10(const atom_t* const n, const uint16_t n_len, const uint16_t
 
         * run_mul = div_b10(n_succ, n_succ_len, n_succ_int_len, n_pred, n_pred_len, n_pred_int_len, &run_mul_len, &run_mul_int_len);
 
+  // power is reused in place for every iteration
+  power_len = succ_b10_into(power, LOG_B10_POWER_CAP, zero, 1, 1, 0, &power_int_len);
+
   for (uint16_t i = 0; i < iterations; i++) {
-    free(y);
+    bn_free(y);
     /* STEP 1: z *= ((x - 1) * (x - 1)) / ((x + 1) * (x + 1)); */
 
     // going to do run_mul = run_mul * N
     const uint16_t temp_run_mul_len = run_mul_len, temp_run_mul_int_len = run_mul_int_len;
     atom_t* const temp_run_mul = array_copy(run_mul, run_mul_len);
-    free(run_mul); // going to re-fill this with the new value
+    bn_free(run_mul); // going to re-fill this with the new value
     // run_mul = run_mul * ((x - 1) * (x - 1)) / ((x + 1) * (x + 1));
     // AKA run_mul = run_mul * ((x - 1)^2) / ((x + 1)^2);
     uint16_t mul_step_len = 0, mul_step_int_len = 0;
     atom_t* const mul_step = div_b10(n_pred_sq, n_pred_sq_len, n_pred_sq_int_len, n_succ_sq, n_succ_sq_len, n_succ_sq_len, &mul_step_len, &mul_step_int_len);
     run_mul = mul_b10(temp_run_mul, temp_run_mul_len, temp_run_mul_int_len, mul_step, mul_step_len, mul_step_int_len, &run_mul_len, &run_mul_int_len);
-    free(mul_step);
-    free(temp_run_mul);
+    bn_free(mul_step);
+    bn_free(temp_run_mul);
 
     /* STEP 2: y = recip(power) * z */
 
     uint16_t recip_power_len = 0, recip_power_int_len = 0;
-    atom_t* const recip_power = recip_b10(power, power_len, power_int_len, &recip_power_len, &recip_power_int_len);
+    atom_t* const recip_power = recip_b10(power, (uint16_t) power_len, (uint16_t) power_int_len, &recip_power_len, &recip_power_int_len);
     y = mul_b10(recip_power, recip_power_len, recip_power_int_len, run_mul, run_mul_len, run_mul_int_len, &y_len, &y_int_len);
-    free(recip_power);
+    bn_free(recip_power);
 
     /* STEP 3: total += y */
     total = add_b10(total, total_len, total_int_len, y, y_len, y_int_len, &total_len, &total_int_len);
 
     /* STEP 4: power += 2 */
 
-    // abuse impl_succ_b10_int because we are always adding integer 2
-    power = impl_succ_b10_int(power, power_len, &power_len);
-    power_int_len = power_len;
-    power = impl_succ_b10_int(power, power_len, &power_len);
-    power_int_len = power_len;
+    // always adding integer 2
+    power_len = succ_b10_into(power, LOG_B10_POWER_CAP, power, power_len, power_len, 0, &power_int_len);
+    power_len = succ_b10_into(power, LOG_B10_POWER_CAP, power, power_len, power_len, 0, &power_int_len);
   }
 
-  free(zero);
-  free(total);
-  free(power);
-  free(y);
-  free(n_succ);
-  free(n_succ_sq);
-  free(n_pred);
-  free(n_pred_sq);
-  free(run_mul);
+  bn_free(zero);
+  bn_free(total);
+  bn_free(power);
+  bn_free(y);
+  bn_free(n_succ);
+  bn_free(n_succ_sq);
+  bn_free(n_pred);
+  bn_free(n_pred_sq);
+  bn_free(run_mul);
 
   atom_t* const final = times2_b10(total, total_len, total_int_len, out_len, out_int_len);
-  free(total);
+  bn_free(total);
   return final;
 }
 
@@ -436,8 +489,8 @@ atom_t* logn_b10 (const atom_t* const base, const uint16_t base_len, const uint1
   atom_t* const log_n = log_b10(n, n_len, n_int_len, &log_n_len, &log_n_int_len);
 
   atom_t* const result = div_b10(log_n, log_n_len, log_n_int_len, log_base, log_base_len, log_base_int_len, out_len, out_int_len);
-  free(log_base);
-  free(log_n);
+  bn_free(log_base);
+  bn_free(log_n);
   return result;
 }
 
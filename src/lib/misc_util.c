@@ -19,14 +19,15 @@ atom_t count_digits_u64 (const uint64_t x) {
 }
 
 /*
-  atom_t*, uint16_t -> bool
+  atom_t*, size_t -> bool
+
+  whether all len digits are zero
 */
-bool raw_is_zero (const atom_t* const digits, const uint16_t len) {
-  uint16_t sum = 0;
-  for (uint16_t i = 0; i < len; i++) {
-    sum = (uint16_t) ((uint16_t) digits[i] + sum);
+bool raw_is_zero (const atom_t* const digits, const size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    if (digits[i]) { return false; }
   }
-  return 0 == sum;
+  return true;
 }
 
 /*
@@ -93,12 +94,10 @@ atom_t indexable_digits_u64 (const uint64_t x) {
 atom_t get_left_nth_digit (const uint64_t x, const atom_t n) {
 #ifdef PREFER_CHAR_CONV
 
-  char* const str = alloc(char, MAX_U64_DIGITS + 2);
-  snprintf(str, MAX_U64_DIGITS + 1, "%" PRIu64 "", x);
+  char str[MAX_U64_DIGITS + 2];
+  snprintf(str, sizeof str, "%" PRIu64 "", x);
 
-  const char d = str[n];
-  free(str);
-  return (atom_t) ((unsigned) d - '0');
+  return (atom_t) ((unsigned) str[n] - '0');
 
 #else /* ! PREFER_CHAR_CONV */
 
@@ -159,49 +158,37 @@ float log256f (const float x) {
   count the number of digits needed in base 256 to represent x
 */
 atom_t count_b256_digits_u64 (const uint64_t x) {
-  return (atom_t) floorf( log256f( (float) x ) + 1.f);
+  atom_t n = 1;
+  for (uint64_t rest = x >> CHAR_BIT; rest; rest >>= CHAR_BIT) { n++; }
+  return n;
 }
 
 /*
   char* -> uint16_t
 
   count the number of digits needed in base 256 to represent the base 10 input
+
+  0 is returned if the input is not all digits, or needs more than UINT16_MAX
 */
 uint16_t count_b256_digits_b10_digits (const char* const digits) {
-  puts("UNIMPLEMENTED");
-  uint16_t len_initial = 0;
-  atom_t* const as_atoms = u64_digits_to_b10(digits, &len_initial, false);
-  static const atom_t b10_256[3] = { 2, 5, 6 };
-  // logn_b10(256, digits)
-  uint16_t log_len = 0, log_int_len = 0;
-  atom_t* const log256 = logn_b10 (b10_256, 3, 3, as_atoms, len_initial, len_initial, &log_len, &log_int_len);
-  free(as_atoms);
-  // add 1
-  uint16_t len_add1 = 0, int_len_add1 = 0;
-  atom_t* const add1 = succ_b10(log256, len_initial, len_initial, 0, &len_add1, &int_len_add1);
-  free(log256);
-  // floor
-  uint16_t floored_len = 0, floored_int_len = 0;
-  atom_t* const floored = floor_b10(add1, len_add1, int_len_add1, &floored_len, &floored_int_len);
-  free(add1);
-  // convert to hardware
-  const uint16_t final = b10_to_u16(floored, len_add1);
-  free(floored);
-  return final;
+  uint16_t len = 0;
+  atom_t* const as_b256 = u64_digits_to_b256(digits, &len, false);
+  bn_free(as_b256);
+  return NULL == as_b256 ? 0 : len;
 }
 
 /*
-  atom_t*, uint16_t -> atom_t*
+  atom_t*, size_t -> atom_t*
 
   copy and reverse an array
   the return value will always be a valid unique pointer
 */
-atom_t* array_reverse (const atom_t* const arr, const uint16_t len) {
+atom_t* array_reverse (const atom_t* const arr, const size_t len) {
 
   atom_t* result = alloc(atom_t, len);
 
   if (len) {
-    for (uint16_t i = 0; i < len; i++) {
+    for (size_t i = 0; i < len; i++) {
       result[i] = arr[ (len - 1) - i ];
     }
   }
@@ -209,6 +196,20 @@ atom_t* array_reverse (const atom_t* const arr, const uint16_t len) {
   return result;
 }
 
+/*
+  atom_t*, size_t -> void
+
+  reverse an array where it is, rather than copying it as array_reverse does,
+    so digits can be put in the other order without allocating
+*/
+void array_reverse_in_place (atom_t* const arr, const size_t len) {
+  for (size_t i = 0; i < len / 2; i++) {
+    const atom_t t = arr[i];
+    arr[i] = arr[len - 1 - i];
+    arr[len - 1 - i] = t;
+  }
+}
+
 /*
   atom_t*, atom_t*, uint16_t, uint16_t -> atom_t*
 
@@ -287,7 +288,7 @@ atom_t* array_trim_trailing_zeroes (const atom_t* const bn) {
   const atom_t hdrlen = bna_header_offset(bn);
   const bool   is_big = bna_is_big(bn);
 
-  const uint16_t
+  const size_t
     //len     = (uint16_t) bna_real_len(bn),
     int_len = bna_int_len(bn),
     frc_len = bna_frac_len(bn);
@@ -313,7 +314,7 @@ atom_t* array_trim_trailing_zeroes (const atom_t* const bn) {
 atom_t* array_trim_leading_zeroes_simple (const atom_t* const bn, const uint16_t len, uint16_t* const out_len) {
   atom_t* const z = zalloc(atom_t, 1);
   const uint16_t count_leading_zeroes = array_span(bn, len, true, z, 1);
-  free(z);
+  bn_free(z);
   const uint16_t nonzeroes = (uint16_t) (len - count_leading_zeroes);
   set_out_param(out_len, nonzeroes);
   return (atom_t*) memcpy(alloc(atom_t, nonzeroes), bn + count_leading_zeroes, nonzeroes);
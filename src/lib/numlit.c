@@ -0,0 +1,145 @@
+#ifndef NUMLIT_H
+#define NUMLIT_H
+
+#include "bn_common.h"
+
+/*
+  the numeric literal scanner: one pass over a number's characters that checks
+    them and finds its parts, so that the converters only copy digits
+
+    [+ or -] [digits] [. digits] [e or E [+ or -] digits]
+
+  with at least one digit before the exponent, and nothing else in the view
+*/
+
+/* larger exponents than this are out of the range of any array */
+#define NUMLIT_MAX_EXP 999999999
+
+/*
+  numlit_t*, char*, size_t -> bool
+
+  scan the n characters at src, which need not be terminated, and describe
+    them in lit
+
+  false is returned, with errno set, when
+    the characters are not exactly one literal (EINVAL)
+    the exponent is larger than NUMLIT_MAX_EXP (ERANGE)
+*/
+bool scan_numlit (numlit_t* const lit, const char* const src, const size_t n) {
+  memset(lit, 0, sizeof *lit);
+
+  if (NULL == src) {
+    errno = EINVAL;
+    return false;
+  }
+
+  size_t i = 0;
+
+  if (i < n && ('-' == src[i] || '+' == src[i])) {
+    lit->flags    = '-' == src[i] ? FL_SIGN : FL_NONE;
+    lit->has_sign = true;
+    i++;
+  }
+
+  lit->int_digits = src + i;
+  lit->int_len    = digit_span(src + i, n - i);
+  i += lit->int_len;
+
+  if (i < n && DECIMAL_SEPARATOR_STR[0] == src[i]) {
+    lit->has_sep     = true;
+    lit->frac_digits = src + ++i;
+    lit->frac_len    = digit_span(src + i, n - i);
+    i += lit->frac_len;
+  }
+
+  /* a sign or separator alone is not a number */
+  bool valid = lit->int_len || lit->frac_len;
+
+  if (valid && i < n && ('e' == src[i] || 'E' == src[i])) {
+    lit->has_exp = true;
+    i++;
+
+    bool negative = false;
+    if (i < n && ('-' == src[i] || '+' == src[i])) {
+      negative = '-' == src[i];
+      i++;
+    }
+
+    const size_t exp_len = digit_span(src + i, n - i);
+    valid = exp_len > 0;
+
+    uint64_t exp = 0;
+    for (const size_t end = i + exp_len; i < end; i++) {
+      exp = exp * DEC_BASE + (atom_t) (src[i] - CHAR_DIGIT_DIFF);
+      if (exp > NUMLIT_MAX_EXP) {
+        errno = ERANGE;
+        return false;
+      }
+    }
+    lit->exp = negative ? - (int32_t) exp : (int32_t) exp;
+  }
+
+  if (! valid || i != n) {
+    errno = EINVAL;
+    return false;
+  }
+
+  return true;
+}
+
+/*
+  numlit_t*, size_t*, size_t*, size_t* -> size_t
+
+  lay out the digits of lit with its exponent applied: lead zeroes, then the
+    integer and fractional digits, then trail zeroes, of which the first
+    int_len are the integer part; the total is returned
+
+  for example, 1.5e3 is 1500 (no lead, 2 trail, int_len 4), and 1.5e-3 is
+    .0015 (2 lead, no trail, int_len 0)
+*/
+size_t numlit_layout (const numlit_t* const lit, size_t* const lead, size_t* const trail, size_t* const int_len) {
+  const size_t ndigits = lit->int_len + lit->frac_len;
+
+  /* where the separator goes, counting from the first digit */
+  const int64_t point = (int64_t) lit->int_len + lit->exp;
+
+  const size_t before = point < 0 ? (size_t) -point : 0,
+               after  = point > (int64_t) ndigits ? (size_t) point - ndigits : 0;
+
+  set_out_param(lead, before);
+  set_out_param(trail, after);
+  set_out_param(int_len, point < 0 ? 0 : (size_t) point);
+
+  return before + ndigits + after;
+}
+
+/*
+  atom_t*, numlit_t*, bool -> size_t
+
+  write the digit values of lit, laid out by numlit_layout, to out, and return
+    how many there are; if reverse is true, then they are written least
+    significant first
+
+  out needs room for the total from numlit_layout
+*/
+size_t numlit_to_b10 (atom_t* const out, const numlit_t* const lit, const bool reverse) {
+  size_t lead = 0, trail = 0;
+  const size_t total = numlit_layout(lit, &lead, &trail, NULL);
+
+  /* the digits were checked by the scan, so this only converts */
+  if (reverse) {
+    memset(out, 0, trail);
+    chars_to_digits(out + trail, lit->frac_digits, lit->frac_len, true);
+    chars_to_digits(out + trail + lit->frac_len, lit->int_digits, lit->int_len, true);
+    memset(out + total - lead, 0, lead);
+  } else {
+    memset(out, 0, lead);
+    chars_to_digits(out + lead, lit->int_digits, lit->int_len, false);
+    chars_to_digits(out + lead + lit->int_len, lit->frac_digits, lit->frac_len, false);
+    memset(out + total - trail, 0, trail);
+  }
+
+  return total;
+}
+
+#endif /* end of include guard: NUMLIT_H */
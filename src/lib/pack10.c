@@ -0,0 +1,466 @@
+#ifndef PACK10_H
+#define PACK10_H
+
+#include "bn_common.h"
+
+/*
+  packed decimal: base 10^19 digits in 64 bit words (see TYP_PACK)
+
+  each word holds 19 base 10 digits, so arithmetic works on 19 digits per
+    machine operation, and the conversion to and from base 10 digits is exact
+    and linear, with no change of radix
+
+  the words of an integer part are grouped from the separator leftwards, and
+    those of a fractional part from the separator rightwards, so that 12.5 is
+    { 12 } { 5000000000000000000 }; both parts are most significant first
+*/
+
+/*
+  the double width products need 128 bit integers; __extension__ keeps
+    --pedantic quiet about them
+*/
+#if defined(__SIZEOF_INT128__) && ! defined(PK_NO_INT128)
+  #define PK_HAVE_INT128
+  __extension__ typedef unsigned __int128 pk_dlimb_t;
+#endif
+
+/*
+  uint64_t, uint64_t, uint64_t, uint64_t, uint64_t* -> uint64_t
+
+  a * b + add + carry, for words below 10^19, so that it is below 10^38; it is
+    split into the base 10^19 digit that is returned and the carry written to hi
+*/
+static uint64_t pk_mul_add (const uint64_t a, const uint64_t b, const uint64_t add, const uint64_t carry, uint64_t* const hi) {
+#ifdef PK_HAVE_INT128
+  const pk_dlimb_t t = (pk_dlimb_t) a * b + add + carry;
+  *hi = (uint64_t) (t / PK_BASE);
+  return (uint64_t) (t % PK_BASE);
+#else /* ! PK_HAVE_INT128 */
+  /* the product in 32 bit halves */
+  const uint64_t al = a & UINT32_MAX, ah = a >> 32,
+                 bl = b & UINT32_MAX, bh = b >> 32;
+
+  const uint64_t ll  = al * bl,
+                 mid = (ll >> 32) + (al * bh & UINT32_MAX) + (ah * bl & UINT32_MAX);
+
+  uint64_t lo = (mid << 32) | (ll & UINT32_MAX),
+           up = ah * bh + (al * bh >> 32) + (ah * bl >> 32) + (mid >> 32);
+
+  up += (lo + add) < lo;
+  lo += add;
+  up += (lo + carry) < lo;
+  lo += carry;
+
+  /* then divided a bit at a time; the quotient fits, as up < 10^19 */
+  uint64_t q = 0;
+  for (int i = 0; i < 64; i++) {
+    const bool over = up >> 63;
+    up = (up << 1) | (lo >> 63);
+    lo <<= 1;
+    q <<= 1;
+    if (over || up >= PK_BASE) {
+      up -= PK_BASE;
+      q  |= 1;
+    }
+  }
+
+  *hi = q;
+  return up;
+#endif /* PK_HAVE_INT128 */
+}
+
+/*
+  atom_t* -> uint64_t
+
+  the word stored at p, whose bytes are most significant first whatever the
+    host's byte order, like the lengths of TYP_BIG and TYP_HUGE (see
+    samb_u32_to_fourba); p need not be aligned
+*/
+uint64_t pk_load (const atom_t* const p) {
+  uint64_t w = 0;
+  for (size_t i = 0; i < sizeof w; i++) {
+    w = (w << CHAR_BIT) | p[i];
+  }
+  return w;
+}
+
+/*
+  atom_t*, uint64_t -> void
+
+  store a word at p as pk_load reads it
+*/
+void pk_store (atom_t* const p, const uint64_t w) {
+  for (size_t i = 0; i < sizeof w; i++) {
+    p[i] = (atom_t) (w >> (CHAR_BIT * (sizeof w - 1 - i)));
+  }
+}
+
+/*
+  size_t -> size_t
+
+  the words that hold len base 10 digits of one part of a number
+*/
+size_t count_pk_limbs (const size_t len) {
+  return (len + PK_DIGITS - 1) / PK_DIGITS;
+}
+
+/*
+  atom_t*, size_t -> uint64_t
+
+  the value of n (at most 19) base 10 digits, most significant first
+*/
+static uint64_t pk_from_digits (const atom_t* const digits, const size_t n) {
+  uint64_t w = 0;
+  for (size_t i = 0; i < n; i++) {
+    w = w * DEC_BASE + digits[i];
+  }
+  return w;
+}
+
+/*
+  atom_t*, uint64_t -> void
+
+  write the 19 base 10 digits of a word, most significant first
+*/
+static void pk_to_digits (atom_t* const out, const uint64_t w) {
+  uint64_t rest = w;
+  for (size_t i = PK_DIGITS; i--; rest /= DEC_BASE) {
+    out[i] = (atom_t) (rest % DEC_BASE);
+  }
+}
+
+/*
+  uint64_t*, atom_t*, size_t, size_t, size_t* -> size_t
+
+  pack len base 10 digits, of which the first int_len are the integer part,
+    into words, and return how many there are; the value at out_int_len is
+    changed to how many of them are the integer part
+
+  out needs room for count_pk_limbs(int_len) + count_pk_limbs(len - int_len)
+*/
+size_t b10_to_pk (uint64_t* const out, const atom_t* const digits, const size_t len, const size_t int_len, size_t* const out_int_len) {
+  const size_t frac_len = len - int_len,
+               nint     = count_pk_limbs(int_len),
+               nfrac    = count_pk_limbs(frac_len);
+
+  /* the first word of the integer part takes what is left over */
+  const size_t head = int_len - (nint ? (nint - 1) * PK_DIGITS : 0);
+  for (size_t i = 0; i < nint; i++) {
+    out[i] = i ? pk_from_digits(digits + head + (i - 1) * PK_DIGITS, PK_DIGITS) : pk_from_digits(digits, head);
+  }
+
+  /* and the last word of the fractional part is padded with zeroes */
+  static const uint64_t pow10[PK_DIGITS] = {
+    1U, 10U, 100U, 1000U, 10000U, 100000U, 1000000U, 10000000U, 100000000U, 1000000000U,
+    10000000000U, 100000000000U, 1000000000000U, 10000000000000U, 100000000000000U,
+    1000000000000000U, 10000000000000000U, 100000000000000000U, 1000000000000000000U
+  };
+
+  for (size_t i = 0; i < nfrac; i++) {
+    const size_t n = min(PK_DIGITS, frac_len - i * PK_DIGITS);
+    out[nint + i] = pk_from_digits(digits + int_len + i * PK_DIGITS, n) * pow10[PK_DIGITS - n];
+  }
+
+  set_out_param(out_int_len, nint);
+  return nint + nfrac;
+}
+
+/*
+  atom_t*, uint64_t*, size_t, size_t, size_t* -> size_t
+
+  unpack len words, of which the first int_len are the integer part, into base
+    10 digits, and return how many there are; the inverse of b10_to_pk
+
+  the integer part has no leading zeroes and the fractional part no trailing
+    ones, so either may be empty; the value at out_int_len is changed to the
+    number of integer digits
+
+  out needs room for 19 len digits
+*/
+size_t pk_to_b10 (atom_t* const out, const uint64_t* const limbs, const size_t len, const size_t int_len, size_t* const out_int_len) {
+  for (size_t i = 0; i < len; i++) {
+    pk_to_digits(out + i * PK_DIGITS, limbs[i]);
+  }
+
+  size_t lead = 0, end = len * PK_DIGITS;
+  const size_t sep = int_len * PK_DIGITS;
+
+  while (lead < sep && 0 == out[lead]) { lead++; }
+  while (end > sep && 0 == out[end - 1]) { end--; }
+
+  memmove(out, out + lead, end - lead);
+
+  set_out_param(out_int_len, sep - lead);
+  return end - lead;
+}
+
+/*
+  uint64_t*, size_t, size_t, size_t*, size_t* -> uint64_t*
+
+  drop the leading zero words of an integer part and the trailing zero words
+    of a fractional part, in place, and write the lengths that are left
+*/
+static uint64_t* pk_trim (uint64_t* const r, const size_t len, const size_t int_len, size_t* const out_len, size_t* const out_int_len) {
+  size_t lead = 0, end = len;
+  while (lead < int_len && 0 == r[lead]) { lead++; }
+  while (end > int_len && 0 == r[end - 1]) { end--; }
+
+  memmove(r, r + lead, sz(uint64_t, end - lead));
+
+  set_out_param(out_len, end - lead);
+  set_out_param(out_int_len, int_len - lead);
+  return r;
+}
+
+/*
+  uint64_t*, size_t, size_t, size_t, size_t -> uint64_t
+
+  word i of the number a, counting in the places of a number with r_int
+    integer words, where words that a does not have are zero
+*/
+static uint64_t pk_at (const uint64_t* const a, const size_t a_len, const size_t a_int_len, const size_t r_int_len, const size_t i) {
+  const size_t shift = r_int_len - a_int_len;
+  return i >= shift && i - shift < a_len ? a[i - shift] : 0;
+}
+
+/*
+  uint64_t*, size_t, size_t, uint64_t*, size_t, size_t, size_t*, size_t* -> uint64_t*
+
+  a + b, for unsigned packed numbers of len words, of which int_len are the
+    integer part; the result has no zero words at either end, and its lengths
+    are written to out_len and out_int_len
+
+  NULL is returned when memory is exhausted
+*/
+uint64_t* add_pk (const uint64_t* const a, const size_t a_len, const size_t a_int_len, const uint64_t* const b, const size_t b_len, const size_t b_int_len, size_t* const out_len, size_t* const out_int_len) {
+  /* one more integer word for the carry */
+  const size_t r_int  = max(a_int_len, b_int_len) + 1,
+               r_frac = max(a_len - a_int_len, b_len - b_int_len),
+               r_len  = r_int + r_frac;
+
+  uint64_t* const r = alloc(uint64_t, r_len);
+  if (NULL == r) { return NULL; }
+
+  uint64_t carry = 0;
+  for (size_t i = r_len; i--; ) {
+    /* the sum of two words may not fit in 64 bits, so it is not made */
+    const uint64_t x = pk_at(a, a_len, a_int_len, r_int, i),
+                   y = pk_at(b, b_len, b_int_len, r_int, i) + carry;
+    carry = x >= PK_BASE - y;
+    r[i]  = carry ? x - (PK_BASE - y) : x + y;
+  }
+
+  return pk_trim(r, r_len, r_int, out_len, out_int_len);
+}
+
+/*
+  uint64_t*, size_t, size_t, uint64_t*, size_t, size_t, size_t*, size_t* -> uint64_t*
+
+  a - b, as add_pk does a + b
+
+  NULL is returned, and errno set to ERANGE, if b is larger than a, or when
+    memory is exhausted
+*/
+uint64_t* sub_pk (const uint64_t* const a, const size_t a_len, const size_t a_int_len, const uint64_t* const b, const size_t b_len, const size_t b_int_len, size_t* const out_len, size_t* const out_int_len) {
+  const size_t r_int  = max(a_int_len, b_int_len),
+               r_frac = max(a_len - a_int_len, b_len - b_int_len),
+               r_len  = r_int + r_frac;
+
+  uint64_t* const r = alloc(uint64_t, r_len + 1);
+  if (NULL == r) { return NULL; }
+
+  uint64_t borrow = 0;
+  for (size_t i = r_len; i--; ) {
+    const uint64_t x = pk_at(a, a_len, a_int_len, r_int, i),
+                   y = pk_at(b, b_len, b_int_len, r_int, i) + borrow;
+    borrow = x < y;
+    r[i]   = borrow ? x + (PK_BASE - y) : x - y;
+  }
+
+  if (borrow) {
+    bn_free(r);
+    errno = ERANGE;
+    return NULL;
+  }
+
+  return pk_trim(r, r_len, r_int, out_len, out_int_len);
+}
+
+/*
+  uint64_t*, size_t, size_t, uint64_t*, size_t, size_t, size_t*, size_t* -> uint64_t*
+
+  a * b, as add_pk does a + b; the fractional part of the result has as many
+    words as those of a and b together, so nothing is rounded
+
+  NULL is returned when memory is exhausted
+*/
+uint64_t* mul_pk (const uint64_t* const a, const size_t a_len, const size_t a_int_len, const uint64_t* const b, const size_t b_len, const size_t b_int_len, size_t* const out_len, size_t* const out_int_len) {
+  const size_t r_len = a_len + b_len,
+               r_int = a_int_len + b_int_len;
+
+  /* never a zero-size allocation */
+  uint64_t* const r = zalloc(uint64_t, r_len + 1);
+  if (NULL == r) { return NULL; }
+
+  /* schoolbook, least significant first; r[i + j + 1] gets a[i] b[j] */
+  for (size_t i = a_len; i--; ) {
+    if (! a[i]) { continue; }
+
+    uint64_t carry = 0;
+    for (size_t j = b_len; j--; ) {
+      r[i + j + 1] = pk_mul_add(a[i], b[j], r[i + j + 1], carry, &carry);
+    }
+    r[i] = carry;
+  }
+
+  return pk_trim(r, r_len, r_int, out_len, out_int_len);
+}
+
+/*
+  atom_t*, size_t, atom_t*, size_t, size_t, atom_t, atom_t -> size_t
+
+  lay out the packed array b10_to_pk_array would make in the caller's buffer
+    out, which has room for cap atoms, and give its length; nothing is
+    written when out is NULL or cap is too small, so the length can be asked
+    for first. the words are packed in scratch space on the way
+
+  0 is returned, and errno set to ERANGE as by b10_to_pk_array, or to ENOMEM
+    when the words do not fit in memory
+*/
+size_t b10_to_pk_array_into (atom_t* const out, const size_t cap, const atom_t* const digits, const size_t len, const size_t int_len, const atom_t metadata, const atom_t flags) {
+  const atom_t pk_meta  = (atom_t) ((metadata | TYP_PACK) & ~(TYP_ZENZ | TYP_BCD));
+  const size_t max_part = meta_max_len(pk_meta),
+               nint     = count_pk_limbs(int_len),
+               nfrac    = count_pk_limbs(len - int_len);
+
+  if (nint > max_part || nfrac > max_part) {
+    errno = ERANGE;
+    return 0;
+  }
+
+  atom_t header[HEADER_OFFSET_HUGE];
+  const size_t hdrlen = make_array_header_into(header, HEADER_OFFSET_HUGE, pk_meta, nint, nfrac, flags);
+  if (0 == hdrlen) { return 0; }
+
+  const size_t need = hdrlen + sz(uint64_t, nint + nfrac);
+  if (NULL == out || cap < need) { return need; }
+
+  const scratch_mark_t mark = scratch_mark();
+  uint64_t* const limbs = salloc(uint64_t, nint + nfrac + 1);
+  if (NULL == limbs) { return 0; }
+
+  b10_to_pk(limbs, digits, len, int_len, NULL);
+
+  memcpy(out, header, sz(atom_t, hdrlen));
+  for (size_t i = 0; i < nint + nfrac; i++) {
+    pk_store(out + hdrlen + sz(uint64_t, i), limbs[i]);
+  }
+
+  scratch_reset(mark);
+  return need;
+}
+
+/*
+  atom_t*, size_t, size_t, atom_t, atom_t -> atom_t*
+
+  a packed array (see TYP_PACK) of len base 10 digits, of which the first
+    int_len are the integer part, with the given metadata and flags; TYP_PACK
+    is set, and TYP_ZENZ and TYP_BCD cleared, in its metadata
+
+  NULL is returned and errno is set to ERANGE if either part needs more words
+    than the header can describe (255, 65535 with TYP_BIG, or UINT32_MAX with
+    TYP_HUGE)
+*/
+atom_t* b10_to_pk_array (const atom_t* const digits, const size_t len, const size_t int_len, const atom_t metadata, const atom_t flags) {
+  const size_t need = b10_to_pk_array_into(NULL, 0, digits, len, int_len, metadata, flags);
+  if (0 == need) { return NULL; }
+
+  atom_t* const pna = alloc(atom_t, need);
+  if (NULL == pna) { return NULL; }
+
+  if (0 == b10_to_pk_array_into(pna, need, digits, len, int_len, metadata, flags)) {
+    bn_free(pna);
+    return NULL;
+  }
+  return pna;
+}
+
+/*
+  atom_t*, atom_t -> atom_t*
+
+  a packed array with the value of a base 10 array, and the other bits of
+    metadata, as from b10_to_pk_array
+
+  NULL is returned and errno is set to
+    EINVAL if bna is not a base 10 array
+    ERANGE as from b10_to_pk_array
+*/
+atom_t* b10_array_to_pk_array (const atom_t* const bna, const atom_t metadata) {
+  if (NULL == bna || bna_is_base256(bna) || bna_is_packed(bna) || bna_is_bcd(bna)) {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  const bn_view_t v = bn_view(bna);
+  return b10_to_pk_array(v.data, view_len(v), v.int_len, metadata, v.flags);
+}
+
+/*
+  atom_t* -> atom_t*
+
+  the base 10 array with the value of a packed array, with TYP_PACK cleared
+    from its metadata; the integer part has no leading zeroes
+
+  NULL is returned and errno is set to
+    EINVAL if pna is not packed
+    ERANGE if either part has more digits than the header can describe
+*/
+atom_t* pk_array_to_b10_array (const atom_t* const pna) {
+  if (NULL == pna || ! bna_is_packed(pna)) {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  const bn_view_t v = bn_view(pna);
+  const size_t nint = v.int_len,
+               len  = view_len(v);
+
+  uint64_t* const limbs  = zalloc(uint64_t, len + 1);
+  atom_t*   const digits = alloc(atom_t, len * PK_DIGITS + 1);
+
+  if (NULL == limbs || NULL == digits) {
+    bn_free(limbs), bn_free(digits);
+    return NULL;
+  }
+
+  for (size_t i = 0; i < len; i++) {
+    limbs[i] = pk_load(v.data + sz(uint64_t, i));
+  }
+
+  size_t int_len = 0;
+  const size_t ndigits = pk_to_b10(digits, limbs, len, nint, &int_len);
+  bn_free(limbs);
+
+  const atom_t   metadata = (atom_t) (pna[0] & ~TYP_PACK);
+  const size_t   max_part = meta_max_len(metadata);
+
+  if (int_len > max_part || ndigits - int_len > max_part) {
+    bn_free(digits);
+    errno = ERANGE;
+    return NULL;
+  }
+
+  atom_t* const header = make_array_header(metadata, int_len, ndigits - int_len, v.flags);
+  const atom_t  hdrlen = NULL == header ? 0 : bna_header_offset(header);
+  atom_t* const bna    = alloc(atom_t, hdrlen + ndigits);
+
+  if (NULL != header && NULL != bna) {
+    memcpy(bna, header, sz(atom_t, hdrlen));
+    memcpy(bna + hdrlen, digits, sz(atom_t, ndigits));
+  }
+
+  bn_free(header), bn_free(digits);
+  return bna;
+}
+
+#endif /* end of include guard: PACK10_H */
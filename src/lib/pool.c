@@ -0,0 +1,153 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include "bn_common.h"
+
+/*
+  an allocator (see bn_set_allocator) which keeps freed blocks for reuse, so
+    the many short-lived arrays of a few dozen atoms seldom reach malloc
+
+  sizes are rounded up to one of POOL_CLASSES classes, POOL_MIN_BLOCK atoms
+    and each power of two after it, and a block that is freed goes onto its
+    class's list in the freeing thread, from which the next one of that
+    class is taken; the lists are per thread, so nothing is locked, and a
+    block may be freed by a thread other than the one that took it
+
+  each list keeps at most POOL_MAX_FREE blocks, and larger blocks are not
+    kept at all; bn_pool_release gives a thread's blocks back to malloc,
+    which a thread should do before it ends
+
+  every block has a POOL_HEADER long header in front, saying which class it
+    is in, so blocks from the pool must only be given back to it (by bn_free,
+    or bn_realloc, while it is in use)
+*/
+
+#ifndef POOL_MIN_BLOCK
+  #define POOL_MIN_BLOCK 16
+#endif
+#ifndef POOL_CLASSES
+  #define POOL_CLASSES 9 /* up to 4096 */
+#endif
+#ifndef POOL_MAX_FREE
+  #define POOL_MAX_FREE 64
+#endif
+/* enough for the header, and keeps blocks aligned for any type */
+#define POOL_HEADER 16
+
+typedef struct st_pool_block_t {
+  struct st_pool_block_t* next; /* while it is on a list */
+  size_t cls;                   /* POOL_CLASSES for a block too large to keep */
+} pool_block_t;
+
+typedef struct {
+  pool_block_t* list[POOL_CLASSES];
+  size_t        count[POOL_CLASSES];
+} pool_t;
+
+static BN_THREAD_LOCAL pool_t pool_tls;
+
+#define pool_class_size(cls) ((size_t) POOL_MIN_BLOCK << (cls))
+#define pool_payload(block) ((void*) ((atom_t*) (block) + POOL_HEADER))
+#define pool_block(ptr) ((pool_block_t*) (void*) ((atom_t*) (ptr) - POOL_HEADER))
+
+/* the smallest class size fits in, or POOL_CLASSES if none does */
+static size_t pool_class (const size_t size) {
+  size_t cls = 0;
+  while (cls < POOL_CLASSES && pool_class_size(cls) < size) { cls++; }
+  return cls;
+}
+
+static void* pool_malloc (const size_t size, void* const ctx) {
+  (void) ctx;
+  const size_t cls = pool_class(size);
+
+  pool_block_t* block = NULL;
+  if (cls < POOL_CLASSES && NULL != pool_tls.list[cls]) {
+    block = pool_tls.list[cls];
+    pool_tls.list[cls] = block->next;
+    pool_tls.count[cls]--;
+
+  } else {
+    const size_t room = cls < POOL_CLASSES ? pool_class_size(cls) : size;
+    if (room > SIZE_MAX - POOL_HEADER) { return NULL; }
+
+    block = (pool_block_t*) malloc(POOL_HEADER + room);
+    if (NULL == block) { return NULL; }
+  }
+
+  block->cls = cls;
+  return pool_payload(block);
+}
+
+static void pool_free (void* const ptr, void* const ctx) {
+  (void) ctx;
+  if (NULL == ptr) { return; }
+
+  pool_block_t* const block = pool_block(ptr);
+  const size_t cls = block->cls;
+
+  if (cls >= POOL_CLASSES || pool_tls.count[cls] >= POOL_MAX_FREE) {
+    free(block);
+    return;
+  }
+
+  block->next = pool_tls.list[cls];
+  pool_tls.list[cls] = block;
+  pool_tls.count[cls]++;
+}
+
+static void* pool_realloc (void* const ptr, const size_t size, void* const ctx) {
+  if (NULL == ptr) { return pool_malloc(size, ctx); }
+
+  pool_block_t* const block = pool_block(ptr);
+  const size_t cls = block->cls;
+
+  /* a block of a class already has room up to the class's size */
+  if (cls < POOL_CLASSES && size <= pool_class_size(cls)) { return ptr; }
+
+  /* one too large to keep stays so, and is grown in place where malloc can */
+  if (cls == POOL_CLASSES && POOL_CLASSES == pool_class(size)) {
+    if (size > SIZE_MAX - POOL_HEADER) { return NULL; }
+
+    pool_block_t* const grown = (pool_block_t*) realloc(block, POOL_HEADER + size);
+    return NULL == grown ? NULL : pool_payload(grown);
+  }
+
+  /* a large block shrinking into a class is copied, as is one outgrowing its class */
+  void* const moved = pool_malloc(size, ctx);
+  if (NULL == moved) { return NULL; }
+
+  memcpy(moved, ptr, cls < POOL_CLASSES ? pool_class_size(cls) : size);
+  pool_free(ptr, ctx);
+  return moved;
+}
+
+/*
+  void -> bn_allocator_t
+
+  the pooling allocator, to be given to bn_set_allocator
+*/
+bn_allocator_t bn_pool_allocator (void) {
+  const bn_allocator_t pool = { pool_malloc, pool_realloc, pool_free, NULL };
+  return pool;
+}
+
+/*
+  void ->
+
+  give every block the calling thread's lists keep back to malloc at once;
+    blocks still in use are untouched, and go onto the lists again when they
+    are freed
+*/
+void bn_pool_release (void) {
+  for (size_t cls = 0; cls < POOL_CLASSES; cls++) {
+    while (NULL != pool_tls.list[cls]) {
+      pool_block_t* const block = pool_tls.list[cls];
+      pool_tls.list[cls] = block->next;
+      free(block);
+    }
+    pool_tls.count[cls] = 0;
+  }
+}
+
+#endif /* end of include guard: POOL_H */
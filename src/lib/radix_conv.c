@@ -0,0 +1,541 @@
+#ifndef RADIX_CONV_H
+#define RADIX_CONV_H
+
+#include "bn_common.h"
+
+/*
+  integers <-> text in any radix from 2 to 62
+
+  the digits are 0-9 and then a-z up to radix 36, where either case is read,
+    and 0-9, A-Z, a-z from 37 to 62, as in GMP
+
+  both directions divide and conquer over the powers big^(2^k), where big is
+    the largest power of the radix that fits a limb: a number is split at the
+    middle power, and each half is converted the same way, so with Karatsuba
+    products and division by reciprocal (see limb_math.c) the time is
+    O(M(n) log n), not the O(n^2) of taking one digit at a time
+
+  the powers, and their reciprocals, are made once per conversion and shared by
+    all of its levels
+*/
+
+#define RADIX_MIN 2
+#define RADIX_MAX 62
+
+/* below this many limbs in a power, the digit at a time conversion is faster */
+#ifndef RADIX_DC_CUTOFF
+  #define RADIX_DC_CUTOFF 24
+#endif
+
+/* more levels than any number in memory could need */
+#define RADIX_LEVELS 48
+
+static const char radix_lower[37] = "0123456789abcdefghijklmnopqrstuvwxyz",
+                  radix_mixed[63] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+
+/* the powers of a radix */
+typedef struct {
+  unsigned radix;
+  limb_t   big;                       /* radix^per_big, the most that fits a limb */
+  size_t   per_big;
+  limb_t*  pow[RADIX_LEVELS];         /* big^(2^k) */
+  size_t   pow_len[RADIX_LEVELS];
+  limb_t*  recip[RADIX_LEVELS];       /* the reciprocal of each, when it is needed */
+  size_t   recip_len[RADIX_LEVELS];
+} radix_powers_t;
+
+static void radix_powers_init (radix_powers_t* const pw, const unsigned radix) {
+  memset(pw, 0, sizeof *pw);
+  pw->radix   = radix;
+  pw->big     = radix;
+  pw->per_big = 1;
+
+  while ((dlimb_t) pw->big * radix <= UINT32_MAX) {
+    pw->big *= radix;
+    pw->per_big++;
+  }
+}
+
+static void radix_powers_free (radix_powers_t* const pw) {
+  for (size_t k = 0; k < RADIX_LEVELS; k++) {
+    bn_free(pw->pow[k]), bn_free(pw->recip[k]);
+  }
+}
+
+/*
+  make big^(2^k), and the powers below it, if they are not made yet; NULL is
+    returned when memory is exhausted
+*/
+static const limb_t* radix_power (radix_powers_t* const pw, const size_t k) {
+  if (NULL == pw->pow[0]) {
+    pw->pow[0] = alloc(limb_t, 1);
+    if (NULL == pw->pow[0]) { return NULL; }
+
+    pw->pow[0][0]  = pw->big;
+    pw->pow_len[0] = 1;
+  }
+
+  for (size_t j = 1; j <= k; j++) {
+    if (NULL != pw->pow[j]) { continue; }
+
+    pw->pow[j] = alloc(limb_t, 2 * pw->pow_len[j - 1]);
+    if (NULL == pw->pow[j]) { return NULL; }
+
+    pw->pow_len[j] = limb_mul(pw->pow[j], pw->pow[j - 1], pw->pow_len[j - 1], pw->pow[j - 1], pw->pow_len[j - 1]);
+    if (! pw->pow_len[j]) {
+      bn_free(pw->pow[j]);
+      pw->pow[j] = NULL;
+      return NULL;
+    }
+  }
+
+  return pw->pow[k];
+}
+
+/* and the reciprocal of big^(2^k), which is made already, or NULL */
+static const limb_t* radix_reciprocal (radix_powers_t* const pw, const size_t k) {
+  if (NULL == pw->recip[k]) {
+    pw->recip[k] = alloc(limb_t, pw->pow_len[k] + 2);
+    if (NULL == pw->recip[k]) { return NULL; }
+
+    pw->recip_len[k] = limb_reciprocal(pw->recip[k], pw->pow[k], pw->pow_len[k]);
+    if (! pw->recip_len[k]) {
+      bn_free(pw->recip[k]);
+      pw->recip[k] = NULL;
+    }
+  }
+  return pw->recip[k];
+}
+
+/* the value of the digit c in a radix, or radix itself if c is not one */
+static unsigned radix_char_value (const char c, const unsigned radix) {
+  unsigned v = radix;
+
+  if (c >= '0' && c <= '9') {
+    v = (unsigned) (c - '0');
+  } else if (c >= 'A' && c <= 'Z') {
+    v = (unsigned) (c - 'A') + 10;
+  } else if (c >= 'a' && c <= 'z') {
+    v = (unsigned) (c - 'a') + (radix > 36 ? 36 : 10);
+  }
+
+  return v < radix ? v : radix;
+}
+
+/*
+  atom_t*, size_t, radix_powers_t*, size_t* -> limb_t*
+
+  the value of n digits, most significant first, as limbs in scratch space
+    (see scratch.c), which stay taken after it returns
+*/
+static limb_t* radix_parse_rec (const atom_t* const digits, const size_t n, radix_powers_t* const pw, size_t* const out_len) {
+  const size_t per = pw->per_big;
+
+  if (n <= per * RADIX_DC_CUTOFF) {
+    /* a short first chunk, so that the rest are whole */
+    limb_t* const res = salloc(limb_t, n / per + 2);
+    if (NULL == res) { return NULL; }
+    size_t len = 0;
+
+    for (size_t i = 0, chunk_len = n % per ? n % per : per; i < n; i += chunk_len, chunk_len = per) {
+      limb_t chunk = 0, scale = 1;
+      for (size_t j = 0; j < chunk_len; j++) {
+        chunk  = chunk * pw->radix + digits[i + j];
+        scale *= pw->radix;
+      }
+      len = limb_mul_small(res, len, scale, chunk);
+    }
+
+    *out_len = len;
+    return res;
+  }
+
+  /* the low half is the largest power's worth of digits below n */
+  size_t k = 0;
+  while ((per << (k + 1)) < n) { k++; }
+
+  const size_t low = per << k;
+  const limb_t* const pow = radix_power(pw, k);
+
+  /* the result goes below the halves, so that they can be given back */
+  limb_t* const res = NULL == pow ? NULL : salloc(limb_t, (n - low) / per + pw->pow_len[k] + 3);
+  if (NULL == res) { return NULL; }
+  const scratch_mark_t mark = scratch_mark();
+
+  size_t hi_len = 0, lo_len = 0;
+  limb_t* const hi = radix_parse_rec(digits, n - low, pw, &hi_len);
+  limb_t* const lo = radix_parse_rec(digits + n - low, low, pw, &lo_len);
+  if (NULL == hi || NULL == lo) {
+    scratch_reset(mark);
+    return NULL;
+  }
+
+  /* hi * big^(2^k) + lo */
+  size_t len = limb_mul(res, hi, hi_len, pow, pw->pow_len[k]);
+  len = limb_add(res, res, len, lo, lo_len);
+
+  scratch_reset(mark);
+
+  *out_len = len;
+  return res;
+}
+
+/*
+  atom_t*, limb_t*, size_t, size_t, radix_powers_t* -> size_t
+
+  write the digits of n one limb's worth at a time, right to left: exactly
+    width of them, or without leading zeroes if width is 0
+*/
+static size_t radix_format_basecase (atom_t* const out, const limb_t* const n, const size_t n_len, const size_t width, radix_powers_t* const pw) {
+  const scratch_mark_t mark = scratch_mark();
+  limb_t* const tmp = salloc(limb_t, n_len + 1);
+
+  /* each limb has at most 32 digits, and the last chunk may be padded */
+  const size_t cap = width ? width : n_len * LIMB_BITS + pw->per_big;
+  atom_t* const buf = width ? out : salloc(atom_t, cap);
+  if (NULL == tmp || NULL == buf) {
+    scratch_reset(mark);
+    return 0;
+  }
+  memcpy(tmp, n, sz(limb_t, n_len));
+
+  size_t pos = cap, len = limb_normalize(tmp, n_len);
+  while (len) {
+    limb_t rem = limb_divmod_small(tmp, len, pw->big, &len);
+    for (size_t j = 0; j < pw->per_big && pos; j++) {
+      buf[--pos] = (atom_t) (rem % pw->radix);
+      rem /= pw->radix;
+    }
+  }
+
+  if (width) {
+    memset(out, 0, pos);
+    scratch_reset(mark);
+    return width;
+  }
+
+  while (pos < cap && 0 == buf[pos]) { pos++; }
+  memcpy(out, buf + pos, cap - pos);
+  scratch_reset(mark);
+
+  return cap - pos;
+}
+
+/*
+  atom_t*, limb_t*, size_t, long, size_t, radix_powers_t* -> size_t
+
+  write the digits of n, which is below big^(2^(k + 1)), as in
+    radix_format_basecase, by splitting it at big^(2^k)
+*/
+static size_t radix_format_rec (atom_t* const out, const limb_t* const n, const size_t n_len, const long k, const size_t width, radix_powers_t* const pw) {
+  if (k < 0 || pw->pow_len[k] < RADIX_DC_CUTOFF) {
+    return radix_format_basecase(out, n, n_len, width, pw);
+  }
+
+  const limb_t* const pow = pw->pow[k];
+  const size_t pow_len = pw->pow_len[k],
+               low     = pw->per_big << k;
+
+  /* nothing above the power, so all of n is the low half */
+  if (limb_cmp(n, n_len, pow, pow_len) < 0) {
+    if (! width) { return radix_format_rec(out, n, n_len, k - 1, 0, pw); }
+
+    memset(out, 0, width - low);
+    return radix_format_rec(out + width - low, n, n_len, k - 1, low, pw) ? width : 0;
+  }
+
+  const limb_t* const recip = radix_reciprocal(pw, (size_t) k);
+
+  const scratch_mark_t mark = scratch_mark();
+  limb_t* const q = salloc(limb_t, pow_len + 3),
+        * const r = salloc(limb_t, n_len + 1);
+  if (NULL == recip || NULL == q || NULL == r) {
+    scratch_reset(mark);
+    return 0;
+  }
+  size_t r_len = 0;
+  const size_t q_len = limb_div_reciprocal(q, r, &r_len, n, n_len, pow, pow_len, recip, pw->recip_len[k]);
+  if ((size_t) -1 == q_len) {
+    scratch_reset(mark);
+    return 0;
+  }
+
+  const size_t high = radix_format_rec(out, q, q_len, k - 1, width ? width - low : 0, pw);
+  const bool ok = high && radix_format_rec(out + high, r, r_len, k - 1, low, pw);
+
+  scratch_reset(mark);
+  return ok ? high + low : 0;
+}
+
+/*
+  limb_t*, atom_t*, size_t, unsigned -> size_t
+
+  convert len digits in radix (2 to 62), most significant first, to limbs
+    (see limb_math.c), and return the number of limbs
+
+  out needs room for len / 5 + 2 limbs
+
+  (size_t) -1 is returned if memory is exhausted
+*/
+size_t radix_digits_to_limbs (limb_t* const out, const atom_t* const digits, const size_t len, const unsigned radix) {
+  radix_powers_t pw;
+  radix_powers_init(&pw, radix);
+
+  const scratch_mark_t mark = scratch_mark();
+  size_t n = 0;
+  const limb_t* const res = radix_parse_rec(digits, len, &pw, &n);
+  radix_powers_free(&pw);
+
+  if (NULL == res) { n = (size_t) -1; }
+  else { memcpy(out, res, sz(limb_t, n)); }
+  scratch_reset(mark);
+
+  return n;
+}
+
+/*
+  atom_t*, limb_t*, size_t, unsigned -> size_t
+
+  write a number in limbs as digits in radix (2 to 62), most significant first,
+    with no leading zeroes, and return their count; 0 is the one digit 0
+
+  out needs room for limb_bit_length(a, len) + 1 digits
+
+  0 is returned when memory is exhausted
+*/
+size_t radix_limbs_to_digits (atom_t* const out, const limb_t* const a, const size_t len, const unsigned radix) {
+  const size_t n = limb_normalize(a, len);
+
+  if (! n) {
+    out[0] = 0;
+    return 1;
+  }
+
+  radix_powers_t pw;
+  radix_powers_init(&pw, radix);
+
+  /* the first power above a, so that the one below it splits a in two */
+  size_t k = 0;
+  for (; k + 1 < RADIX_LEVELS; k++) {
+    const limb_t* const pow = radix_power(&pw, k);
+    if (NULL == pow) {
+      radix_powers_free(&pw);
+      return 0;
+    }
+
+    if (limb_cmp(pow, pw.pow_len[k], a, n) > 0) { break; }
+  }
+
+  const size_t count = radix_format_rec(out, a, n, (long) k - 1, 0, &pw);
+  radix_powers_free(&pw);
+
+  return count;
+}
+
+/*
+  limb_t*, size_t, unsigned, size_t* -> char*
+
+  the characters of a number in limbs in radix, as a string of n_chars in
+    scratch space (see scratch.c)
+*/
+static char* radix_format_limbs (const limb_t* const a, const size_t len, const unsigned radix, size_t* const n_chars) {
+  /* the digits become their characters in place, with room for a terminator */
+  atom_t* const values = salloc(atom_t, limb_bit_length(a, len) + 2);
+  if (NULL == values) { return NULL; }
+
+  const size_t n = radix_limbs_to_digits(values, a, len, radix);
+  if (! n) { return NULL; }
+
+  const char* const alphabet = radix > 36 ? radix_mixed : radix_lower;
+  char* const str = (char*) values;
+
+  for (size_t i = 0; i < n; i++) {
+    str[i] = alphabet[values[i]];
+  }
+  str[n] = '\0';
+
+  *n_chars = n;
+  return str;
+}
+
+/*
+  atom_t*, size_t, unsigned, bool, size_t* -> char*
+
+  the characters of an integer of len base 256 or base 10 digits in radix, in
+    scratch space, or NULL, with errno set to EINVAL if radix is out of range
+*/
+static char* radix_format_digits (const atom_t* const digits, const size_t len, const unsigned radix, const bool from_b10, size_t* const n_chars) {
+  *n_chars = 0;
+  if (radix < RADIX_MIN || radix > RADIX_MAX) {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  const size_t ndigits = NULL == digits ? 0 : len;
+  limb_t* const limbs = salloc(limb_t, from_b10 ? ndigits / 9 + 2 : ndigits / sizeof (limb_t) + 1);
+  if (NULL == limbs) { return NULL; }
+
+  const size_t nlimbs = from_b10 ? b10_to_limbs(limbs, digits, ndigits) : b256_to_limbs(limbs, digits, ndigits);
+  if ((size_t) -1 == nlimbs) { return NULL; }
+
+  return radix_format_limbs(limbs, nlimbs, radix, n_chars);
+}
+
+/* copy a formatted string out of scratch space into a caller's buffer, as b10_to_ldbl_digits_into does */
+static size_t radix_into (char* const out, const size_t cap, const atom_t* const digits, const size_t len, const unsigned radix, const bool from_b10) {
+  const scratch_mark_t mark = scratch_mark();
+
+  size_t n = 0;
+  const char* const str = radix_format_digits(digits, len, radix, from_b10, &n);
+  if (NULL != str && NULL != out && cap > n) { memcpy(out, str, n + 1); }
+
+  scratch_reset(mark);
+  return n;
+}
+
+/* or into a new string */
+static char* radix_dup (const atom_t* const digits, const size_t len, const unsigned radix, const bool from_b10) {
+  const scratch_mark_t mark = scratch_mark();
+
+  size_t n = 0;
+  const char* const str = radix_format_digits(digits, len, radix, from_b10, &n);
+  char* const res = NULL == str ? NULL : alloc(char, n + 1);
+  if (NULL != res) { memcpy(res, str, n + 1); }
+
+  scratch_reset(mark);
+  return res;
+}
+
+/*
+  char*, size_t, atom_t*, size_t, unsigned -> size_t
+
+  write an integer of len base 256 digits as text in radix (2 to 62) into the
+    caller's buffer, with no leading zeroes; the return value and cap behave
+    as for b10_to_ldbl_digits_into, and only scratch space is used on the way
+
+  0 is returned, and errno set to EINVAL, if radix is out of range
+*/
+size_t b256_to_radix_into (char* const out, const size_t cap, const atom_t* const digits, const size_t len, const unsigned radix) {
+  return radix_into(out, cap, digits, len, radix, false);
+}
+
+/*
+  atom_t*, size_t, unsigned -> char*
+
+  b256_to_radix_into, into a new string
+
+  NULL is returned, and errno set to EINVAL, if radix is out of range
+*/
+char* b256_to_radix (const atom_t* const digits, const size_t len, const unsigned radix) {
+  return radix_dup(digits, len, radix, false);
+}
+
+/*
+  char*, size_t, atom_t*, size_t, unsigned -> size_t
+
+  write an integer of len base 10 digits as text in radix (2 to 62), as
+    b256_to_radix_into does
+*/
+size_t b10_to_radix_into (char* const out, const size_t cap, const atom_t* const digits, const size_t len, const unsigned radix) {
+  return radix_into(out, cap, digits, len, radix, true);
+}
+
+/*
+  atom_t*, size_t, unsigned -> char*
+
+  b10_to_radix_into, into a new string
+
+  NULL is returned, and errno set to EINVAL, if radix is out of range
+*/
+char* b10_to_radix (const atom_t* const digits, const size_t len, const unsigned radix) {
+  return radix_dup(digits, len, radix, true);
+}
+
+/*
+  char*, size_t, unsigned, size_t* -> limb_t*, size_t
+
+  the value of n characters of digits in radix, as limbs in scratch space
+*/
+static limb_t* radix_parse_chars (const char* const str, const size_t n, const unsigned radix, size_t* const nlimbs) {
+  if (radix < RADIX_MIN || radix > RADIX_MAX || NULL == str || ! n) {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  limb_t* const limbs = salloc(limb_t, n / 5 + 2);
+  const scratch_mark_t mark = scratch_mark();
+  atom_t* const values = salloc(atom_t, n);
+  if (NULL == limbs || NULL == values) { return NULL; }
+
+  for (size_t i = 0; i < n; i++) {
+    const unsigned v = radix_char_value(str[i], radix);
+    if (v == radix) {
+      errno = EINVAL;
+      return NULL;
+    }
+    values[i] = (atom_t) v;
+  }
+
+  *nlimbs = radix_digits_to_limbs(limbs, values, n, radix);
+  scratch_reset(mark);
+
+  return (size_t) -1 == *nlimbs ? NULL : limbs;
+}
+
+/*
+  char*, size_t, unsigned, size_t* -> atom_t*
+
+  parse n characters of an integer in radix (2 to 62) as base 256 digits,
+    most significant first, with no leading zeroes (0 is one zero digit); the
+    characters need not be terminated, and nothing past them is read
+
+  the value at len is changed to the number of digits
+
+  NULL is returned, and errno set to EINVAL, if n is 0, radix is out of range,
+    or any character is not a digit in it
+*/
+atom_t* radix_to_b256_n (const char* const str, const size_t n, const unsigned radix, size_t* const len) {
+  set_out_param(len, 0);
+
+  const scratch_mark_t mark = scratch_mark();
+  size_t nlimbs = 0;
+  const limb_t* const limbs = radix_parse_chars(str, n, radix, &nlimbs);
+
+  atom_t* const res = NULL == limbs ? NULL : zalloc(atom_t, nlimbs * sizeof (limb_t) + 1);
+  if (NULL != res) {
+    const size_t ndigits = limbs_to_b256(res, limbs, nlimbs);
+    set_out_param(len, ndigits ? ndigits : 1);
+  }
+
+  scratch_reset(mark);
+  return res;
+}
+
+/*
+  char*, size_t, unsigned, size_t* -> atom_t*
+
+  parse n characters of an integer in radix (2 to 62) as base 10 digits, as
+    radix_to_b256_n does
+*/
+atom_t* radix_to_b10_n (const char* const str, const size_t n, const unsigned radix, size_t* const len) {
+  set_out_param(len, 0);
+
+  const scratch_mark_t mark = scratch_mark();
+  size_t nlimbs = 0;
+  const limb_t* const limbs = radix_parse_chars(str, n, radix, &nlimbs);
+
+  atom_t* res = NULL == limbs ? NULL : alloc(atom_t, limb_bit_length(limbs, nlimbs) + 1);
+  const size_t ndigits = NULL == res ? 0 : radix_limbs_to_digits(res, limbs, nlimbs, DEC_BASE);
+
+  if (ndigits) {
+    set_out_param(len, ndigits);
+  } else {
+    bn_free(res);
+    res = NULL;
+  }
+
+  scratch_reset(mark);
+  return res;
+}
+
+#endif /* end of include guard: RADIX_CONV_H */
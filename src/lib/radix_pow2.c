@@ -0,0 +1,420 @@
+#ifndef RADIX_POW2_H
+#define RADIX_POW2_H
+
+#include "bn_common.h"
+
+/*
+  base 256 digits <-> text in the radixes that are powers of two: hex, octal
+    and base64
+
+  a base 256 digit is a byte, so these only repack bits, and are linear at any
+    length, where going through base 10 is quadratic
+
+  digits are most significant first, as everywhere else; every digit is
+    written, leading zeroes included, so that fixed width identifiers and
+    hashes survive the round trip
+
+  the _into functions behave like b10_to_ldbl_digits_into: they return the
+    length of the string, and write nothing unless cap is greater than it
+*/
+
+#define RADIX_BAD ((atom_t) 0xFF) /* the value of a character that is not a digit */
+
+static const char radix_hex_lower[17] = "0123456789abcdef",
+                  radix_hex_upper[17] = "0123456789ABCDEF",
+                  radix_b64[65]       = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/* the value of a hex digit of either case, or RADIX_BAD */
+static atom_t radix_hex_value (const char c) {
+  const atom_t d = (atom_t) ((atom_t) c - CHAR_DIGIT_DIFF);
+  if (d < DEC_BASE) { return d; }
+
+  /* setting the case bit makes A to F into a to f, and nothing into them */
+  const atom_t l = (atom_t) (((atom_t) c | 0x20) - 'a');
+  return l < 6 ? (atom_t) (l + DEC_BASE) : RADIX_BAD;
+}
+
+/* the value of a base64 digit, or RADIX_BAD */
+static atom_t radix_b64_value (const char c) {
+  if (c >= 'A' && c <= 'Z') { return (atom_t) (c - 'A'); }
+  if (c >= 'a' && c <= 'z') { return (atom_t) (c - 'a' + 26); }
+  if (c >= '0' && c <= '9') { return (atom_t) (c - '0' + 52); }
+  if ('+' == c) { return 62; }
+  if ('/' == c) { return 63; }
+  return RADIX_BAD;
+}
+
+#ifdef BN_HAVE_SSSE3
+/*
+  __m128i, __m128i* -> __m128i
+
+  the values of sixteen hex digit characters, with a nonzero byte or'd into bad
+    for each one that is not a hex digit
+*/
+static __m128i radix_sse_hex_values (const __m128i v, __m128i* const bad) {
+  const __m128i zero = _mm_setzero_si128();
+
+  const __m128i d    = _mm_sub_epi8(v, _mm_set1_epi8((char) CHAR_DIGIT_DIFF)),
+                is_d = _mm_cmpeq_epi8(_mm_subs_epu8(d, _mm_set1_epi8(DEC_BASE - 1)), zero);
+
+  const __m128i l    = _mm_sub_epi8(_mm_or_si128(v, _mm_set1_epi8(0x20)), _mm_set1_epi8('a')),
+                is_l = _mm_cmpeq_epi8(_mm_subs_epu8(l, _mm_set1_epi8(5)), zero);
+
+  *bad = _mm_or_si128(*bad, _mm_andnot_si128(_mm_or_si128(is_d, is_l), _mm_set1_epi8(-1)));
+
+  return _mm_or_si128(_mm_and_si128(is_d, d), _mm_and_si128(is_l, _mm_add_epi8(l, _mm_set1_epi8(DEC_BASE))));
+}
+#endif /* BN_HAVE_SSSE3 */
+
+/*
+  char*, size_t, atom_t*, size_t, bool -> size_t
+
+  write len base 256 digits as hex, 2 characters a digit, into the caller's
+    buffer; the letters are upper case if upper is true
+
+  the table lookup for each nibble is a byte shuffle, 16 or 32 digits at a time
+*/
+size_t b256_to_hex_into (char* const out, const size_t cap, const atom_t* const digits, const size_t len, const bool upper) {
+  const size_t need = NULL == digits ? 0 : 2 * len;
+
+  if (NULL == out || cap <= need) { return need; }
+
+  const char* const alphabet = upper ? radix_hex_upper : radix_hex_lower;
+  size_t i = 0;
+
+#ifdef BN_HAVE_AVX2
+  {
+    const __m256i table = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) alphabet)),
+                  lows  = _mm256_set1_epi8(0x0F);
+
+    for (; i + 32 <= len; i += 32) {
+      const __m256i v  = _mm256_loadu_si256((const __m256i*) (digits + i)),
+                    hi = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), lows)),
+                    lo = _mm256_shuffle_epi8(table, _mm256_and_si256(v, lows));
+
+      /* the unpacks stay in their lanes, which the permutes put back in order */
+      const __m256i first = _mm256_unpacklo_epi8(hi, lo),
+                    last  = _mm256_unpackhi_epi8(hi, lo);
+
+      _mm256_storeu_si256((__m256i*) (out + 2 * i),      _mm256_permute2x128_si256(first, last, 0x20));
+      _mm256_storeu_si256((__m256i*) (out + 2 * i + 32), _mm256_permute2x128_si256(first, last, 0x31));
+    }
+  }
+#endif /* BN_HAVE_AVX2 */
+
+#ifdef BN_HAVE_SSSE3
+  {
+    const __m128i table = _mm_loadu_si128((const __m128i*) alphabet),
+                  lows  = _mm_set1_epi8(0x0F);
+
+    for (; i + 16 <= len; i += 16) {
+      const __m128i v  = _mm_loadu_si128((const __m128i*) (digits + i)),
+                    hi = _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(v, 4), lows)),
+                    lo = _mm_shuffle_epi8(table, _mm_and_si128(v, lows));
+
+      _mm_storeu_si128((__m128i*) (out + 2 * i),      _mm_unpacklo_epi8(hi, lo));
+      _mm_storeu_si128((__m128i*) (out + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+  }
+#endif /* BN_HAVE_SSSE3 */
+
+  for (; i < len; i++) {
+    out[2 * i]     = alphabet[digits[i] >> 4];
+    out[2 * i + 1] = alphabet[digits[i] & 0x0F];
+  }
+  out[need] = '\0';
+
+  return need;
+}
+
+/*
+  atom_t*, size_t, bool -> char*
+
+  b256_to_hex_into, into a new string
+*/
+char* b256_to_hex (const atom_t* const digits, const size_t len, const bool upper) {
+  const size_t need = b256_to_hex_into(NULL, 0, digits, len, upper);
+
+  char* const str = alloc(char, need + 1);
+  b256_to_hex_into(str, need + 1, digits, len, upper);
+
+  return str;
+}
+
+/*
+  char*, size_t, size_t* -> atom_t*
+
+  parse n hex digit characters, of either case, as base 256 digits; the
+    characters need not be terminated, and nothing past them is read
+
+  an odd number of characters has an implied leading 0
+  the value at len is changed to the number of digits, which is half of n,
+    rounded up
+
+  NULL is returned when
+    n is 0 or hex is NULL
+    any character is not a hex digit, in which case errno is set to EINVAL
+    memory is exhausted, in which case errno is set to ENOMEM
+*/
+atom_t* hex_to_b256_n (const char* const hex, const size_t n, size_t* const len) {
+  set_out_param(len, 0);
+
+  if (NULL == hex || ! n) { return NULL; }
+
+  const size_t out_len = n / 2 + (n & 1);
+  atom_t* const res = alloc(atom_t, out_len);
+  if (NULL == res) { return NULL; }
+
+  size_t i = 0, o = 0;
+  bool bad = false;
+
+  if (n & 1) {
+    res[o++] = radix_hex_value(hex[i++]);
+    bad = RADIX_BAD == res[0];
+  }
+
+#ifdef BN_HAVE_SSSE3
+  {
+    /* (16, 1) in each pair of bytes, to make a digit from its two nibbles */
+    const __m128i weights = _mm_set1_epi16(0x0110);
+    __m128i bad_v = _mm_setzero_si128();
+
+    for (; i + 32 <= n; i += 32, o += 16) {
+      const __m128i a = radix_sse_hex_values(_mm_loadu_si128((const __m128i*) (hex + i)), &bad_v),
+                    b = radix_sse_hex_values(_mm_loadu_si128((const __m128i*) (hex + i + 16)), &bad_v);
+
+      _mm_storeu_si128((__m128i*) (res + o), _mm_packus_epi16(_mm_maddubs_epi16(a, weights), _mm_maddubs_epi16(b, weights)));
+    }
+
+    bad = bad || 0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi8(bad_v, _mm_setzero_si128()));
+  }
+#endif /* BN_HAVE_SSSE3 */
+
+  for (; i < n; i += 2) {
+    const atom_t hi = radix_hex_value(hex[i]),
+                 lo = radix_hex_value(hex[i + 1]);
+
+    bad = bad || RADIX_BAD == hi || RADIX_BAD == lo;
+    res[o++] = (atom_t) (hi << 4 | lo);
+  }
+
+  if (bad) {
+    bn_free(res);
+    errno = EINVAL;
+    return NULL;
+  }
+
+  set_out_param(len, out_len);
+  return res;
+}
+
+/*
+  char*, size_t, atom_t*, size_t -> size_t
+
+  write len base 256 digits as octal into the caller's buffer, 8 characters
+    for every 3 digits, and the rest rounded up
+*/
+size_t b256_to_oct_into (char* const out, const size_t cap, const atom_t* const digits, const size_t len) {
+  const size_t need = NULL == digits ? 0 : len / 3 * 8 + (len % 3 * 8 + 2) / 3;
+
+  if (NULL == out || cap <= need) { return need; }
+
+  /* least significant first, since the octal digits line up at that end */
+  uint32_t acc = 0;
+  unsigned bits = 0;
+  size_t at = need;
+
+  for (size_t i = len; i--; ) {
+    acc |= (uint32_t) digits[i] << bits;
+    for (bits += 8; bits >= 3; bits -= 3, acc >>= 3) {
+      out[--at] = (char) ('0' + (acc & 7));
+    }
+  }
+  if (at) { out[--at] = (char) ('0' + acc); }
+  out[need] = '\0';
+
+  return need;
+}
+
+/*
+  atom_t*, size_t -> char*
+
+  b256_to_oct_into, into a new string
+*/
+char* b256_to_oct (const atom_t* const digits, const size_t len) {
+  const size_t need = b256_to_oct_into(NULL, 0, digits, len);
+
+  char* const str = alloc(char, need + 1);
+  b256_to_oct_into(str, need + 1, digits, len);
+
+  return str;
+}
+
+/*
+  char*, size_t, size_t* -> atom_t*
+
+  parse n octal digit characters as base 256 digits; the characters need not
+    be terminated, and nothing past them is read
+
+  the value at len is changed to the number of digits, which is 3n / 8 (at
+    least 1), or one more when the value needs it, so that the output of
+    b256_to_oct comes back at its original length
+
+  NULL is returned when
+    n is 0 or oct is NULL
+    any character is not an octal digit, in which case errno is set to EINVAL
+    memory is exhausted, in which case errno is set to ENOMEM
+*/
+atom_t* oct_to_b256_n (const char* const oct, const size_t n, size_t* const len) {
+  set_out_param(len, 0);
+
+  if (NULL == oct || ! n) { return NULL; }
+
+  /* every bit of the characters, rounded up, and rounded down */
+  const size_t floor_len = n / 8 * 3 + n % 8 * 3 / 8;
+  size_t out_len = n / 8 * 3 + (n % 8 * 3 + 7) / 8;
+  atom_t* const res = alloc(atom_t, out_len);
+  if (NULL == res) { return NULL; }
+
+  uint32_t acc = 0;
+  unsigned bits = 0;
+  size_t at = out_len;
+
+  for (size_t i = n; i--; ) {
+    const atom_t v = (atom_t) ((atom_t) oct[i] - CHAR_DIGIT_DIFF);
+    if (v > 7) {
+      bn_free(res);
+      errno = EINVAL;
+      return NULL;
+    }
+
+    acc |= (uint32_t) v << bits;
+    if ((bits += 3) >= 8) {
+      res[--at] = (atom_t) acc;
+      acc >>= 8, bits -= 8;
+    }
+  }
+  if (at) { res[--at] = (atom_t) acc; }
+
+  /* a leading digit of only the rounded up bits is dropped if it is zero */
+  if (floor_len && out_len > floor_len && 0 == res[0]) {
+    memmove(res, res + 1, --out_len);
+  }
+
+  set_out_param(len, out_len);
+  return res;
+}
+
+/*
+  char*, size_t, atom_t*, size_t -> size_t
+
+  write len base 256 digits as base64 (RFC 4648, padded with '=') into the
+    caller's buffer, 4 characters for every 3 digits or part of 3
+*/
+size_t b256_to_base64_into (char* const out, const size_t cap, const atom_t* const digits, const size_t len) {
+  const size_t need = NULL == digits ? 0 : (len / 3 + (0 != len % 3)) * 4;
+
+  if (NULL == out || cap <= need) { return need; }
+
+  size_t i = 0, o = 0;
+  for (; i + 3 <= len; i += 3, o += 4) {
+    const uint32_t group = (uint32_t) digits[i] << 16 | (uint32_t) digits[i + 1] << 8 | digits[i + 2];
+
+    out[o]     = radix_b64[group >> 18];
+    out[o + 1] = radix_b64[(group >> 12) & 63];
+    out[o + 2] = radix_b64[(group >> 6) & 63];
+    out[o + 3] = radix_b64[group & 63];
+  }
+
+  if (i < len) {
+    const bool two = i + 2 == len;
+    const uint32_t group = (uint32_t) digits[i] << 16 | (two ? (uint32_t) digits[i + 1] << 8 : 0);
+
+    out[o]     = radix_b64[group >> 18];
+    out[o + 1] = radix_b64[(group >> 12) & 63];
+    out[o + 2] = two ? radix_b64[(group >> 6) & 63] : '=';
+    out[o + 3] = '=';
+  }
+  out[need] = '\0';
+
+  return need;
+}
+
+/*
+  atom_t*, size_t -> char*
+
+  b256_to_base64_into, into a new string
+*/
+char* b256_to_base64 (const atom_t* const digits, const size_t len) {
+  const size_t need = b256_to_base64_into(NULL, 0, digits, len);
+
+  char* const str = alloc(char, need + 1);
+  b256_to_base64_into(str, need + 1, digits, len);
+
+  return str;
+}
+
+/*
+  char*, size_t, size_t* -> atom_t*
+
+  parse n characters of base64 (RFC 4648) as base 256 digits; the characters
+    need not be terminated, and nothing past them is read
+
+  the padding may be left out, but if it is there, then n is a multiple of 4;
+    the bits of the last character that are not in a digit must be zero
+  the value at len is changed to the number of digits
+
+  NULL is returned when
+    n is 0 or b64 is NULL
+    the characters are not base64, in which case errno is set to EINVAL
+    memory is exhausted, in which case errno is set to ENOMEM
+*/
+atom_t* base64_to_b256_n (const char* const b64, const size_t n, size_t* const len) {
+  set_out_param(len, 0);
+
+  if (NULL == b64 || ! n) { return NULL; }
+
+  size_t m = n;
+  while (m && n - m < 2 && '=' == b64[m - 1]) { m--; }
+
+  /* one character in the last group is less than a digit */
+  if ((m != n && n % 4) || 1 == m % 4 || ! m) {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  const size_t out_len = m / 4 * 3 + (m % 4 ? m % 4 - 1 : 0);
+  atom_t* const res = alloc(atom_t, out_len);
+  if (NULL == res) { return NULL; }
+
+  uint32_t acc = 0;
+  unsigned bits = 0;
+  size_t o = 0;
+
+  for (size_t i = 0; i < m; i++) {
+    const atom_t v = radix_b64_value(b64[i]);
+    if (RADIX_BAD == v) {
+      bn_free(res);
+      errno = EINVAL;
+      return NULL;
+    }
+
+    acc = acc << 6 | v;
+    if ((bits += 6) >= 8) {
+      bits -= 8;
+      res[o++] = (atom_t) (acc >> bits);
+    }
+  }
+
+  /* the bits left over are only padding, and have to be zero */
+  if (acc & ((1U << bits) - 1)) {
+    bn_free(res);
+    errno = EINVAL;
+    return NULL;
+  }
+
+  set_out_param(len, out_len);
+  return res;
+}
+
+#endif /* end of include guard: RADIX_POW2_H */
@@ -0,0 +1,132 @@
+#ifndef SCRATCH_H
+#define SCRATCH_H
+
+#include "bn_common.h"
+
+/*
+  a per-thread stack of memory for the temporaries of an operation, so that
+    only what an operation returns is allocated on the heap
+
+  an operation takes a mark (scratch_mark) before it takes any scratch space,
+    and gives it all back by resetting to the mark (scratch_reset) before it
+    returns; the space is handed out by bumping a pointer, and calls nested
+    inside it take and give back their own, above it
+
+  the memory is kept in blocks from the allocator (see bn_set_allocator),
+    each at least twice the size of the one before, so nothing that was
+    handed out ever moves; the blocks are kept for the next operation until
+    bn_scratch_release, which a thread should call before it ends
+*/
+
+/* the size of the first block, and every size handed out is a multiple of SCRATCH_ALIGN */
+#ifndef SCRATCH_FIRST_BLOCK
+  #define SCRATCH_FIRST_BLOCK 4096
+#endif
+#define SCRATCH_ALIGN  16
+#define SCRATCH_BLOCKS 48
+
+typedef struct {
+  atom_t* block[SCRATCH_BLOCKS];
+  size_t  cap[SCRATCH_BLOCKS];
+  size_t  top;   /* the block being handed out from */
+  size_t  used;  /* and how much of it is taken */
+} scratch_t;
+
+static BN_THREAD_LOCAL scratch_t scratch_tls;
+
+/*
+  void -> scratch_mark_t
+
+  where the calling thread's scratch space is up to
+*/
+scratch_mark_t scratch_mark (void) {
+  const scratch_mark_t mark = { scratch_tls.top, scratch_tls.used };
+  return mark;
+}
+
+/*
+  scratch_mark_t ->
+
+  give back everything taken since the mark was made
+*/
+void scratch_reset (const scratch_mark_t mark) {
+  scratch_tls.top  = mark.block;
+  scratch_tls.used = mark.used;
+}
+
+/*
+  size_t -> void*
+
+  bytes of scratch space, aligned for any type, until the mark before it is
+    reset to; NULL is returned, and errno set to ENOMEM, when memory is
+    exhausted
+*/
+void* scratch_alloc (const size_t bytes) {
+  scratch_t* const s = &scratch_tls;
+
+  if (bytes > SIZE_MAX - SCRATCH_ALIGN) {
+    errno = ENOMEM;
+    return NULL;
+  }
+  const size_t n = (bytes + SCRATCH_ALIGN - 1) / SCRATCH_ALIGN * SCRATCH_ALIGN + (bytes ? 0 : SCRATCH_ALIGN);
+
+  if (NULL != s->block[s->top] && n <= s->cap[s->top] - s->used) {
+    atom_t* const p = s->block[s->top] + s->used;
+    s->used += n;
+    return p;
+  }
+
+  /* the rest of this block is left until a reset comes back to it */
+  const size_t next = NULL == s->block[s->top] ? s->top : s->top + 1;
+  if (SCRATCH_BLOCKS == next) {
+    errno = ENOMEM;
+    return NULL;
+  }
+
+  /* blocks past the top are not in use, so one that is too small is replaced */
+  if (NULL != s->block[next] && s->cap[next] < n) {
+    bn_free(s->block[next]);
+    s->block[next] = NULL;
+  }
+
+  if (NULL == s->block[next]) {
+    const size_t grow = next ? 2 * s->cap[next - 1] : SCRATCH_FIRST_BLOCK,
+                 cap  = max(grow, n);
+
+    s->block[next] = alloc(atom_t, cap);
+    if (NULL == s->block[next]) { return NULL; }
+    s->cap[next] = cap;
+  }
+
+  s->top  = next;
+  s->used = n;
+  return s->block[next];
+}
+
+/*
+  size_t -> void*
+
+  like scratch_alloc, but the bytes are zeroed
+*/
+void* scratch_zalloc (const size_t bytes) {
+  void* const p = scratch_alloc(bytes);
+  if (NULL != p) { memset(p, 0, bytes); }
+  return p;
+}
+
+/*
+  void ->
+
+  give the calling thread's scratch blocks back to the allocator; no
+    operation may be using them
+*/
+void bn_scratch_release (void) {
+  for (size_t i = 0; i < SCRATCH_BLOCKS; i++) {
+    bn_free(scratch_tls.block[i]);
+    scratch_tls.block[i] = NULL;
+    scratch_tls.cap[i]   = 0;
+  }
+  scratch_tls.top = scratch_tls.used = 0;
+}
+
+#endif /* end of include guard: SCRATCH_H */
@@ -0,0 +1,284 @@
+#ifndef SIMD_CONV_H
+#define SIMD_CONV_H
+
+#include "bn_common.h"
+
+/*
+  character <-> digit kernels
+
+  these convert between ASCII digit characters and base 10 digit values a
+  vector register at a time: 32 bytes with AVX2, 16 bytes with SSE2 / SSSE3,
+  and 8 bytes with the portable SWAR (SIMD within a register) fallback
+
+  define NO_SIMD to always use the SWAR kernels
+*/
+
+#define SWAR_HIGHS  ((uint64_t) 0xF0F0F0F0F0F0F0F0U)
+#define SWAR_LOWS   ((uint64_t) 0x0F0F0F0F0F0F0F0FU)
+#define SWAR_THREES ((uint64_t) 0x3030303030303030U)
+#define SWAR_SIXES  ((uint64_t) 0x0606060606060606U)
+
+/*
+  uint64_t -> uint64_t
+
+  reverse the order of the bytes in a word, independent of host byte order
+*/
+static uint64_t swar_reverse_bytes (const uint64_t x) {
+  uint64_t r = x;
+  r = ((r & 0x00FF00FF00FF00FFU) << 8)  | ((r >> 8)  & 0x00FF00FF00FF00FFU);
+  r = ((r & 0x0000FFFF0000FFFFU) << 16) | ((r >> 16) & 0x0000FFFF0000FFFFU);
+  return (r << 32) | (r >> 32);
+}
+
+/*
+  char, atom_t* -> bool
+
+  scalar tail: store the digit value of c at dst, and report whether c was a digit
+*/
+static bool scalar_char_to_digit (const char c, atom_t* const dst) {
+  const atom_t d = (atom_t) ((atom_t) c - CHAR_DIGIT_DIFF);
+  *dst = d;
+  return d < DEC_BASE;
+}
+
+#ifdef BN_HAVE_SSE2
+/*
+  __m128i -> __m128i
+
+  reverse the sixteen bytes of a register
+*/
+static __m128i sse_reverse_bytes (const __m128i v) {
+#ifdef BN_HAVE_SSSE3
+  return _mm_shuffle_epi8(v, _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+#else /* ! BN_HAVE_SSSE3 */
+  /* reverse the 4 dwords, then the 2 words in each dword, then the 2 bytes in each word */
+  __m128i r = _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+  r = _mm_shufflelo_epi16(r, _MM_SHUFFLE(2, 3, 0, 1));
+  r = _mm_shufflehi_epi16(r, _MM_SHUFFLE(2, 3, 0, 1));
+  return _mm_or_si128(_mm_slli_epi16(r, 8), _mm_srli_epi16(r, 8));
+#endif /* BN_HAVE_SSSE3 */
+}
+#endif /* BN_HAVE_SSE2 */
+
+#ifdef BN_HAVE_AVX2
+/*
+  __m256i -> __m256i
+
+  reverse the thirty two bytes of a register
+*/
+static __m256i avx_reverse_bytes (const __m256i v) {
+  const __m256i in_lane = _mm256_shuffle_epi8(v, _mm256_setr_epi8(
+    15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+    15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0
+  ));
+  /* then swap the two 128 bit lanes */
+  return _mm256_permute4x64_epi64(in_lane, _MM_SHUFFLE(1, 0, 3, 2));
+}
+#endif /* BN_HAVE_AVX2 */
+
+/*
+  atom_t*, char*, size_t, bool -> bool
+
+  convert n ASCII digit characters at src to their base 10 digit values at dst,
+    writing each value exactly once
+
+  if reverse is true, then dst receives the digits in the opposite order, so a
+    big endian string becomes a little endian array with no intermediate copy
+
+  false is returned if any of the characters is not one of 0123456789, in which
+    case the contents of dst are unspecified
+
+  dst and src must not overlap
+*/
+bool chars_to_digits (atom_t* const dst, const char* const src, const size_t n, const bool reverse) {
+  size_t i = 0;
+
+  /* for each block, the i-th block of the output comes from here in the input */
+#define src_block(width) (reverse ? src + (n - i - (width)) : src + i)
+
+#ifdef BN_HAVE_AVX2
+  {
+    const __m256i zero_ch = _mm256_set1_epi8((char) CHAR_DIGIT_DIFF),
+                  nine    = _mm256_set1_epi8(DEC_BASE - 1);
+    __m256i bad = _mm256_setzero_si256();
+
+    for (; i + 32 <= n; i += 32) {
+      __m256i v = _mm256_sub_epi8(_mm256_loadu_si256((const __m256i*) src_block(32)), zero_ch);
+      /* anything that was not a digit is now above 9, so saturates to nonzero */
+      bad = _mm256_or_si256(bad, _mm256_subs_epu8(v, nine));
+      if (reverse) { v = avx_reverse_bytes(v); }
+      _mm256_storeu_si256((__m256i*) (dst + i), v);
+    }
+
+    if ( ! _mm256_testz_si256(bad, bad) ) { return false; }
+  }
+#endif /* BN_HAVE_AVX2 */
+
+#ifdef BN_HAVE_SSE2
+  {
+    const __m128i zero_ch = _mm_set1_epi8((char) CHAR_DIGIT_DIFF),
+                  nine    = _mm_set1_epi8(DEC_BASE - 1);
+    __m128i bad = _mm_setzero_si128();
+
+    for (; i + 16 <= n; i += 16) {
+      __m128i v = _mm_sub_epi8(_mm_loadu_si128((const __m128i*) src_block(16)), zero_ch);
+      bad = _mm_or_si128(bad, _mm_subs_epu8(v, nine));
+      if (reverse) { v = sse_reverse_bytes(v); }
+      _mm_storeu_si128((__m128i*) (dst + i), v);
+    }
+
+    if ( 0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi8(bad, _mm_setzero_si128())) ) { return false; }
+  }
+#endif /* BN_HAVE_SSE2 */
+
+  /* SWAR: eight characters per 64 bit word */
+  uint64_t bad = 0;
+  for (; i + 8 <= n; i += 8) {
+    uint64_t x;
+    memcpy(&x, src_block(8), sz(uint64_t, 1));
+
+    /* every byte must be 0x3N, and must stay 0x3N after adding 6 (so N < 10) */
+    bad |= ((x & SWAR_HIGHS) ^ SWAR_THREES) | (((x + SWAR_SIXES) & SWAR_HIGHS) ^ SWAR_THREES);
+
+    x &= SWAR_LOWS;
+    if (reverse) { x = swar_reverse_bytes(x); }
+    memcpy(dst + i, &x, sz(uint64_t, 1));
+  }
+
+  if (bad) { return false; }
+
+#undef src_block
+
+  for (; i < n; i++) {
+    if ( ! scalar_char_to_digit(reverse ? src[n - i - 1] : src[i], dst + i) ) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/*
+  char*, atom_t*, size_t, bool -> void
+
+  convert n base 10 digit values at src to ASCII digit characters at dst; the
+    inverse of chars_to_digits, with the same meaning of reverse
+
+  nothing is validated, and no terminator is written
+
+  dst and src must not overlap
+*/
+void digits_to_chars (char* const dst, const atom_t* const src, const size_t n, const bool reverse) {
+  size_t i = 0;
+
+  /* for each block, the i-th block of the output comes from here in the input */
+#define src_block(width) (reverse ? src + (n - i - (width)) : src + i)
+
+#ifdef BN_HAVE_AVX2
+  {
+    const __m256i zero_ch = _mm256_set1_epi8((char) CHAR_DIGIT_DIFF);
+
+    for (; i + 32 <= n; i += 32) {
+      __m256i v = _mm256_add_epi8(_mm256_loadu_si256((const __m256i*) src_block(32)), zero_ch);
+      if (reverse) { v = avx_reverse_bytes(v); }
+      _mm256_storeu_si256((__m256i*) (dst + i), v);
+    }
+  }
+#endif /* BN_HAVE_AVX2 */
+
+#ifdef BN_HAVE_SSE2
+  {
+    const __m128i zero_ch = _mm_set1_epi8((char) CHAR_DIGIT_DIFF);
+
+    for (; i + 16 <= n; i += 16) {
+      __m128i v = _mm_add_epi8(_mm_loadu_si128((const __m128i*) src_block(16)), zero_ch);
+      if (reverse) { v = sse_reverse_bytes(v); }
+      _mm_storeu_si128((__m128i*) (dst + i), v);
+    }
+  }
+#endif /* BN_HAVE_SSE2 */
+
+  for (; i + 8 <= n; i += 8) {
+    uint64_t x;
+    memcpy(&x, src_block(8), sz(uint64_t, 1));
+    /* digits are below 0x10, so this never carries between bytes */
+    x += SWAR_THREES;
+    if (reverse) { x = swar_reverse_bytes(x); }
+    memcpy(dst + i, &x, sz(uint64_t, 1));
+  }
+
+#undef src_block
+
+  for (; i < n; i++) {
+    dst[i] = (char) ((reverse ? src[n - i - 1] : src[i]) + CHAR_DIGIT_DIFF);
+  }
+}
+
+#if defined(BN_HAVE_AVX2) || defined(BN_HAVE_SSE2)
+/*
+  unsigned -> unsigned
+
+  the index of the lowest set bit of a nonzero mask
+*/
+static unsigned simd_first_set (const unsigned mask) {
+#if defined(__GNUC__)
+  return (unsigned) __builtin_ctz(mask);
+#else
+  unsigned i = 0;
+  while (! ((mask >> i) & 1U)) { i++; }
+  return i;
+#endif
+}
+#endif /* BN_HAVE_AVX2 || BN_HAVE_SSE2 */
+
+/*
+  char*, size_t -> size_t
+
+  how many of the first n characters at src are ASCII digits, before the first
+    one which is not; like strspn(src, "0123456789"), but bounded by n rather
+    than a terminator, and a vector register at a time
+*/
+size_t digit_span (const char* const src, const size_t n) {
+  size_t i = 0;
+
+#ifdef BN_HAVE_AVX2
+  {
+    const __m256i zero_ch = _mm256_set1_epi8((char) CHAR_DIGIT_DIFF),
+                  nine    = _mm256_set1_epi8(DEC_BASE - 1);
+
+    for (; i + 32 <= n; i += 32) {
+      const __m256i v   = _mm256_sub_epi8(_mm256_loadu_si256((const __m256i*) (src + i)), zero_ch);
+      const __m256i bad = _mm256_subs_epu8(v, nine);
+      /* a set bit for every byte that is not a digit */
+      const unsigned mask = ~ (unsigned) _mm256_movemask_epi8(_mm256_cmpeq_epi8(bad, _mm256_setzero_si256()));
+      if (mask) { return i + simd_first_set(mask); }
+    }
+  }
+#endif /* BN_HAVE_AVX2 */
+
+#ifdef BN_HAVE_SSE2
+  {
+    const __m128i zero_ch = _mm_set1_epi8((char) CHAR_DIGIT_DIFF),
+                  nine    = _mm_set1_epi8(DEC_BASE - 1);
+
+    for (; i + 16 <= n; i += 16) {
+      const __m128i v   = _mm_sub_epi8(_mm_loadu_si128((const __m128i*) (src + i)), zero_ch);
+      const __m128i bad = _mm_subs_epu8(v, nine);
+      const unsigned mask = 0xFFFFU & ~ (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(bad, _mm_setzero_si128()));
+      if (mask) { return i + simd_first_set(mask); }
+    }
+  }
+#endif /* BN_HAVE_SSE2 */
+
+  /* SWAR: skip whole words of digits, then find the first bad byte in order */
+  for (; i + 8 <= n; i += 8) {
+    uint64_t x;
+    memcpy(&x, src + i, sz(uint64_t, 1));
+    if (((x & SWAR_HIGHS) ^ SWAR_THREES) | (((x + SWAR_SIXES) & SWAR_HIGHS) ^ SWAR_THREES)) { break; }
+  }
+
+  while (i < n && (atom_t) (src[i] - CHAR_DIGIT_DIFF) < DEC_BASE) { i++; }
+  return i;
+}
+
+#endif /* end of include guard: SIMD_CONV_H */
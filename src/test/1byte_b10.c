@@ -59,7 +59,7 @@ Test(a1b10, bna_s64) {
 }
 
 Test(a1b10, bna_ldbl) {
-  atom_t* a = to_digit_array((ldbl_t) 1.234, 0, FL_NONE, TYP_NONE),
+  atom_t* a = dbl_to_digit_array(1.234, FL_NONE, TYP_NONE),
     z[HEADER_OFFSET + 4] = { TYP_NONE, 1, 3, FL_NONE, 1, 2, 3, 4 };
 
   for (uint16_t i = 0; i < bna_real_len(a); i++) {
@@ -70,7 +70,7 @@ Test(a1b10, bna_ldbl) {
   free(a);
 
   #define BNALDBL_LEN 3 + 3
-  a = to_digit_array((ldbl_t) 155.235, 0, FL_SIGN, TYP_NONE);
+  a = dbl_to_digit_array(155.235, FL_SIGN, TYP_NONE);
   atom_t y[HEADER_OFFSET + BNALDBL_LEN] = { TYP_NONE, 3, 3, FL_SIGN, 1, 5, 5, 2, 3, 5 };
 
   for (uint16_t i = 0; i < bna_real_len(a); i++) {
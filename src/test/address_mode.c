@@ -41,3 +41,24 @@ Test(addrmodes, 2to1) {
 
   cr_assert_eq(0, samb_twoba_to_u16(0, 0));
 }
+
+Test(addrmodes, 1to4) {
+  atom_t a[4];
+
+  samb_u32_to_fourba(70000, a);
+  cr_assert(a[0] == 0 && a[1] == 1 && a[2] == 0x11 && a[3] == 0x70);
+
+  samb_u32_to_fourba(UINT32_MAX, a);
+  cr_assert(a[0] == 255 && a[1] == 255 && a[2] == 255 && a[3] == 255);
+
+  samb_u32_to_fourba(0x01020304, a);
+  cr_assert(a[0] == 1 && a[1] == 2 && a[2] == 3 && a[3] == 4);
+}
+
+Test(addrmodes, 4to1) {
+  const atom_t a[] = { 0, 1, 0x11, 0x70 }, b[] = { 255, 255, 255, 255 }, c[] = { 1, 2, 3, 4 };
+
+  cr_assert_eq(samb_fourarray_to_u32(a), 70000);
+  cr_assert_eq(samb_fourarray_to_u32(b), UINT32_MAX);
+  cr_assert_eq(samb_fourarray_to_u32(c), 0x01020304);
+}
@@ -0,0 +1,215 @@
+#include <criterion/criterion.h>
+
+#include "../lib/bn_common.h"
+
+/* an accounting allocator, which refuses to have more than cap blocks out */
+typedef struct {
+  size_t live, total, cap;
+} tally_t;
+
+static void* tally_malloc (const size_t size, void* const ctx) {
+  tally_t* const t = (tally_t*) ctx;
+  if (t->live == t->cap) { return NULL; }
+  t->live++, t->total++;
+  return malloc(size);
+}
+
+static void* tally_realloc (void* const ptr, const size_t size, void* const ctx) {
+  tally_t* const t = (tally_t*) ctx;
+  if (NULL == ptr) { return tally_malloc(size, ctx); }
+  t->total++;
+  return realloc(ptr, size);
+}
+
+static void tally_free (void* const ptr, void* const ctx) {
+  ((tally_t*) ctx)->live--;
+  free(ptr);
+}
+
+Test(allocator, hooks) {
+  tally_t t = { 0, 0, SIZE_MAX };
+  const bn_allocator_t a = { tally_malloc, tally_realloc, tally_free, &t };
+  cr_assert(bn_set_allocator(&a));
+  cr_assert_eq(bn_get_allocator().ctx, &t);
+
+  /* everything is made and released through it */
+  atom_t* const bna = str_to_digit_array("-1234.5e3", 9, TYP_ZENZ);
+  cr_assert_not_null(bna);
+  cr_assert_gt(t.total, 0);
+
+  /* scratch blocks are kept for the next operation, until they are released */
+  bn_scratch_release();
+  cr_assert_eq(t.live, 1);
+  bn_free(bna);
+
+  digit_stream_t* const ds = digit_stream_new(TYP_PACK);
+  cr_assert(digit_stream_feed(ds, "98765432109876543210", 20));
+  atom_t* const pna = digit_stream_finish(ds);
+  cr_assert_not_null(pna);
+  bn_free(pna);
+  digit_stream_free(ds);
+  bn_scratch_release();
+  cr_assert_eq(t.live, 0);
+
+  /* running out part of the way through leaks nothing */
+  for (size_t cap = 0; cap < 4; cap++) {
+    t.cap = cap;
+    atom_t* const m = to_digit_array(0.1L, 0, FL_NONE, TYP_ZENZ);
+    if (NULL != m) { bn_free(m); }
+    bn_scratch_release();
+    cr_assert_eq(t.live, 0);
+  }
+
+  /* and every function must be given */
+  bn_allocator_t partial = a;
+  partial.free_fn = NULL;
+  errno = 0;
+  cr_assert(! bn_set_allocator(&partial));
+  cr_assert_eq(errno, EINVAL);
+  cr_assert_eq(bn_get_allocator().ctx, &t);
+
+  cr_assert(bn_set_allocator(NULL));
+  cr_assert_null(bn_get_allocator().ctx);
+}
+
+Test(allocator, calloc) {
+  atom_t* const z = (atom_t*) bn_calloc(64, 2);
+  for (size_t i = 0; i < 128; i++) { cr_assert_eq(z[i], 0); }
+  bn_free(z);
+
+  errno = 0;
+  cr_assert_null(bn_calloc(SIZE_MAX / 2, 3));
+  cr_assert_eq(errno, ENOMEM);
+  bn_free(NULL);
+}
+
+/*
+  whether f, run under every cap up to the number of blocks it takes, either
+    gives want or fails with ENOMEM, leaking nothing either way
+*/
+static void exhausted_each_cap (tally_t* const t, atom_t* (* const f) (size_t*), const atom_t* const want, const size_t want_len) {
+  for (size_t cap = 0; cap < 16; cap++) {
+    t->cap = cap;
+    size_t len = 0;
+
+    errno = 0;
+    atom_t* const got = f(&len);
+    if (NULL == got) {
+      cr_assert_eq(errno, ENOMEM, "cap %zu", cap);
+    } else {
+      cr_assert_eq(len, want_len, "cap %zu", cap);
+      cr_assert_arr_eq(got, want, want_len, "cap %zu", cap);
+      bn_free(got);
+    }
+
+    bn_scratch_release();
+    cr_assert_eq(t->live, 0, "cap %zu", cap);
+  }
+  t->cap = SIZE_MAX;
+}
+
+static char exhausted_long[1000];
+
+static atom_t* exhausted_b10 (size_t* const len) {
+  uint16_t n = 0;
+  atom_t* const res = u64_digits_to_b10_n("12345", 5, &n, false);
+  *len = n;
+  return res;
+}
+
+static atom_t* exhausted_b256 (size_t* const len) {
+  uint16_t n = 0;
+  atom_t* const res = u64_digits_to_b256_n("4294967296", 10, &n, false);
+  *len = n;
+  return res;
+}
+
+static atom_t* exhausted_radix (size_t* const len) {
+  return radix_to_b10_n(exhausted_long, sizeof exhausted_long, 10, len);
+}
+
+static atom_t* exhausted_hex (size_t* const len) {
+  return hex_to_b256_n("1ff", 3, len);
+}
+
+static atom_t* exhausted_oct (size_t* const len) {
+  return oct_to_b256_n("777", 3, len);
+}
+
+static atom_t* exhausted_base64 (size_t* const len) {
+  return base64_to_b256_n("AQID", 4, len);
+}
+
+static atom_t* exhausted_stream (size_t* const len) {
+  digit_stream_t* const ds = digit_stream_new(TYP_ZENZ);
+  if (NULL == ds) { return NULL; }
+
+  size_t int_len = 0;
+  atom_t* const res = digit_stream_feed(ds, "65536.5", 7) ? digit_stream_raw(ds, len, &int_len) : NULL;
+  digit_stream_free(ds);
+  return res;
+}
+
+/* the size of a digit array, given back as the others give a length */
+static atom_t* exhausted_array (atom_t* const bna, size_t* const len) {
+  if (NULL != bna) { *len = bna_size(bna); }
+  return bna;
+}
+
+static atom_t* exhausted_ldbl (size_t* const len) {
+  return exhausted_array(to_digit_array(1.5L, 0, FL_NONE, TYP_NONE), len);
+}
+
+static atom_t* exhausted_u64 (size_t* const len) {
+  return exhausted_array(to_digit_array(0, 12345, FL_NONE, TYP_NONE), len);
+}
+
+static atom_t* exhausted_u64_b256 (size_t* const len) {
+  return exhausted_array(to_digit_array(0, 12345, FL_NONE, TYP_ZENZ), len);
+}
+
+static atom_t* exhausted_dbl_bcd (size_t* const len) {
+  return exhausted_array(dbl_to_digit_array(0.1, FL_NONE, TYP_BCD), len);
+}
+
+static atom_t* exhausted_u64_pack (size_t* const len) {
+  return exhausted_array(to_digit_array(0, UINT64_MAX, FL_NONE, TYP_PACK), len);
+}
+
+Test(allocator, exhausted) {
+  tally_t t = { 0, 0, SIZE_MAX };
+  const bn_allocator_t a = { tally_malloc, tally_realloc, tally_free, &t };
+  cr_assert(bn_set_allocator(&a));
+
+  memset(exhausted_long, '7', sizeof exhausted_long);
+  static atom_t sevens[sizeof exhausted_long];
+  memset(sevens, 7, sizeof sevens);
+
+  static const atom_t b10[] = { 1, 2, 3, 4, 5 }, b256[] = { 1, 0, 0, 0, 0 }, hex[] = { 1, 0xff },
+    oct[] = { 1, 0xff }, base64[] = { 1, 2, 3 }, stream[] = { 1, 0, 0, 128 };
+
+  exhausted_each_cap(&t, exhausted_b10, b10, sizeof b10);
+  exhausted_each_cap(&t, exhausted_b256, b256, sizeof b256);
+  exhausted_each_cap(&t, exhausted_radix, sevens, sizeof sevens);
+  exhausted_each_cap(&t, exhausted_hex, hex, sizeof hex);
+  exhausted_each_cap(&t, exhausted_oct, oct, sizeof oct);
+  exhausted_each_cap(&t, exhausted_base64, base64, sizeof base64);
+  exhausted_each_cap(&t, exhausted_stream, stream, sizeof stream);
+
+  /* the digit arrays made from primitives, in every base */
+  atom_t* (* const arrays[]) (size_t*) = { exhausted_ldbl, exhausted_u64, exhausted_u64_b256, exhausted_dbl_bcd, exhausted_u64_pack };
+  for (size_t i = 0; i < sizeof arrays / sizeof arrays[0]; i++) {
+    /* what is wanted is kept apart, so that nothing is out while it is tried */
+    size_t len = 0;
+    atom_t want[64];
+    atom_t* const made = arrays[i](&len);
+    cr_assert_not_null(made);
+    cr_assert(len <= sizeof want);
+    memcpy(want, made, len);
+    bn_free(made);
+
+    exhausted_each_cap(&t, arrays[i], want, len);
+  }
+
+  cr_assert(bn_set_allocator(NULL));
+}
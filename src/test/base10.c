@@ -23,6 +23,129 @@ Test(base10, strton) {
   cr_assert_str_eq(ar, "123.45");
   free(ar);
 
+  ar = b10_to_ldbl_digits(a, 2, 0);
+  cr_assert_str_eq(ar, ".12");
+  free(ar);
+
+  ar = b10_to_u64_digits(a, 4);
+  cr_assert_str_eq(ar, "1234");
+  free(ar);
+
   //b10_to_u64(const atom_t *const digits, const uint16_t len);
-  //b10_to_u64_digits(const atom_t *const digits, const uint16_t len)
+}
+
+Test(base10, strton_into) {
+  const atom_t a[] = { 1, 2, 3, 4, 5 };
+  char buf[8];
+
+  /* size query */
+  cr_assert_eq(6, b10_to_ldbl_digits_into(NULL, 0, a, 5, 3));
+  cr_assert_eq(3, b10_to_ldbl_digits_into(NULL, 0, a, 3, 3));
+  cr_assert_eq(0, b10_to_ldbl_digits_into(NULL, 0, a, 0, 0));
+
+  /* too small: nothing written */
+  memset(buf, 'x', sizeof buf);
+  cr_assert_eq(6, b10_to_ldbl_digits_into(buf, 6, a, 5, 3));
+  cr_assert_eq('x', buf[0]);
+
+  /* exactly enough for the terminator */
+  cr_assert_eq(6, b10_to_ldbl_digits_into(buf, 7, a, 5, 3));
+  cr_assert_str_eq(buf, "123.45");
+
+  cr_assert_eq(0, b10_to_ldbl_digits_into(buf, sizeof buf, NULL, 5, 3));
+  cr_assert_str_eq(buf, "");
+
+  cr_assert_eq(5, b10_to_u64_digits_into(buf, sizeof buf, a, 5));
+  cr_assert_str_eq(buf, "12345");
+
+  /* and the other way, into digits */
+  atom_t digits[20];
+  cr_assert_eq(20, u64_to_b10_into(NULL, 0, UINT64_MAX, false));
+  cr_assert_eq(20, u64_to_b10_into(digits, 20, UINT64_MAX, false));
+  cr_assert_eq(digits[0], 1);
+  cr_assert_eq(digits[19], 5);
+
+  memset(digits, 7, sizeof digits);
+  cr_assert_eq(3, u64_to_b10_into(digits, 2, 120, true));
+  cr_assert_eq(digits[0], 7);
+  cr_assert_eq(3, u64_to_b10_into(digits, 3, 120, true));
+  const atom_t le[] = { 0, 2, 1 };
+  cr_assert_arr_eq(digits, le, 3);
+  cr_assert_eq(1, u64_to_b10_into(digits, 3, 0, false));
+  cr_assert_eq(digits[0], 0);
+}
+
+Test(base10, ntostr) {
+  uint16_t len = 0, int_len = 0;
+
+  atom_t* a = ldbl_digits_to_b10("123.45", &len, &int_len, false);
+  const atom_t a1[] = { 1, 2, 3, 4, 5 };
+  cr_assert_eq(len, 5);
+  cr_assert_eq(int_len, 3);
+  cr_assert_arr_eq(a, a1, 5);
+  free(a);
+
+  a = ldbl_digits_to_b10("123.45", &len, &int_len, true);
+  const atom_t a2[] = { 5, 4, 3, 2, 1 };
+  cr_assert_eq(len, 5);
+  cr_assert_eq(int_len, 3);
+  cr_assert_arr_eq(a, a2, 5);
+  free(a);
+
+  a = ldbl_digits_to_b10("98765432109876543210.0123456789", &len, &int_len, false);
+  const atom_t a3[] = { 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+  cr_assert_eq(len, 30);
+  cr_assert_eq(int_len, 20);
+  cr_assert_arr_eq(a, a3, 30);
+  free(a);
+
+  a = ldbl_digits_to_b10("42", &len, &int_len, false);
+  cr_assert_eq(len, 2);
+  cr_assert_eq(int_len, 2);
+  cr_assert(a[0] == 4 && a[1] == 2);
+  free(a);
+
+  cr_assert_null(ldbl_digits_to_b10("12x.5", &len, &int_len, false));
+  cr_assert_null(ldbl_digits_to_b10("1.2.5", &len, &int_len, false));
+
+  a = u64_digits_to_b10("12345678901234567890", &len, true);
+  const atom_t a4[] = { 0, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 9, 8, 7, 6, 5, 4, 3, 2, 1 };
+  cr_assert_eq(len, 20);
+  cr_assert_arr_eq(a, a4, 20);
+  free(a);
+
+  cr_assert_null(u64_digits_to_b10("-1", &len, false));
+}
+
+Test(base10, strton_n) {
+  /* fields of a record, with no terminators between them */
+  static const char record[] = "12.50|0042|7.";
+  const atom_t price[] = { 1, 2, 5, 0 }, qty[] = { 0, 0, 4, 2 };
+  uint16_t len = 0, int_len = 0;
+
+  atom_t* a = ldbl_digits_to_b10_n(record, 5, &len, &int_len, false);
+  cr_assert_eq(len, 4);
+  cr_assert_eq(int_len, 2);
+  cr_assert_arr_eq(a, price, 4);
+  free(a);
+
+  a = u64_digits_to_b10_n(record + 6, 4, &len, false);
+  cr_assert_eq(len, 4);
+  cr_assert_arr_eq(a, qty, 4);
+  free(a);
+
+  /* the separator at the end of the view */
+  a = ldbl_digits_to_b10_n(record + 11, 2, &len, &int_len, true);
+  cr_assert_eq(len, 1);
+  cr_assert_eq(int_len, 1);
+  cr_assert_eq(a[0], 7);
+  free(a);
+
+  /* the field separator is inside the view */
+  errno = 0;
+  cr_assert_null(u64_digits_to_b10_n(record + 6, 5, &len, false));
+  cr_assert_eq(errno, EINVAL);
+  cr_assert_eq(len, 0);
+
+  cr_assert_null(u64_digits_to_b10_n(record, 0, &len, false));
 }
@@ -16,6 +16,17 @@ Test(b256_util, count) {
   cr_assert_eq(8, count_b256_digits_b10_digits("12345678901234567890") );
 }
 
+Test(b256_util, count_for_b10) {
+  /* 256^count is at least 10^len, with no digit to spare */
+  for (size_t len = 1; len <= 5000; len++) {
+    const size_t count = count_b256_digits_for_b10(len);
+    const ldbl_t bits = (ldbl_t) len * log2l(10.0L);
+    cr_assert((ldbl_t) (8 * count) >= bits, "%zu digits", len);
+    cr_assert((ldbl_t) (8 * (count - 1)) < bits, "%zu digits", len);
+  }
+  cr_assert_eq(count_b256_digits_for_b10(1811), 753);
+}
+
 /* base conversions from base 10 t 256 and back */
 Test(b256_to_b10, u64) {
   static const atom_t d[] = {255, 255};
@@ -28,16 +39,89 @@ Test(b256_to_b10, u64) {
 }
 
 Test(b256_to_b10, ldbl) {
-  static const atom_t d[] = {255, 255};
+  static const atom_t d[] = {255, 255}, e[] = {1, 0, 128, 64}, z[] = {0, 1};
+
+  char* f = b256_to_ldbl_digits(d, 2, 2);
+  cr_assert_str_eq(f, "65535");
+  free(f);
 
-  char* const f = b256_to_ldbl_digits(d, 1, 1);
+  /* 256 + 1/2 + 1/256^2 */
+  f = b256_to_ldbl_digits(e, 4, 2);
+  cr_assert_str_eq(f, "256.5009765625");
+  free(f);
 
-  //printf("%s\n", f);
+  f = b256_to_ldbl_digits(z, 2, 0);
+  cr_assert_str_eq(f, "0.0000152587890625");
+  free(f);
 
-  cr_assert_str_eq(f, "65535.");
+  f = b256_to_u64_digits(d + 1, 1);
+  cr_assert_str_eq(f, "255");
   free(f);
 }
 
+Test(b256_to_b10, into) {
+  static const atom_t e[] = {1, 0, 128, 64}, le[] = {0, 1};
+  char buf[16];
+
+  cr_assert_eq(14, b256_to_ldbl_digits_into(NULL, 0, e, 4, 2));
+  memset(buf, 'x', sizeof buf);
+  cr_assert_eq(14, b256_to_ldbl_digits_into(buf, 14, e, 4, 2));
+  cr_assert_eq(buf[0], 'x');
+  cr_assert_eq(14, b256_to_ldbl_digits_into(buf, 15, e, 4, 2));
+  cr_assert_str_eq(buf, "256.5009765625");
+
+  cr_assert_eq(3, b256_to_u64_digits_into(buf, sizeof buf, le, 2));
+  cr_assert_str_eq(buf, "256");
+  cr_assert_eq(0, b256_to_u64_digits_into(buf, sizeof buf, NULL, 2));
+  cr_assert_str_eq(buf, "");
+
+  atom_t digits[8];
+  cr_assert_eq(2, u64_to_b256_into(digits, 1, 258, false));
+  cr_assert_eq(2, u64_to_b256_into(digits, 2, 258, true));
+  cr_assert(2 == digits[0] && 1 == digits[1]);
+}
+
+Test(b256_to_b10, frac) {
+  /* a fraction of n base 256 digits is exactly one of 8 n base 10 digits */
+  enum { N = 700 };
+  atom_t b256[N], back[N], b10[8 * N];
+
+  uint32_t seed = 12345;
+  for (size_t i = 0; i < N; i++) {
+    seed = seed * 1103515245U + 12345U;
+    b256[i] = (atom_t) (seed >> 16);
+  }
+
+  /* short ones a digit at a time, and long ones all at once */
+  for (size_t n = 1; n <= N; n += n < 80 ? 13 : 310) {
+    cr_assert(b256_frac_to_b10(b10, 8 * n, b256, n));
+    cr_assert(b10_frac_to_b256(back, n, b10, 8 * n));
+    cr_assert_arr_eq(back, b256, n);
+  }
+
+  /* truncating: 0.1 is 0.0001100110011... in binary, and 0.3 = 0x0.4CCC... */
+  static const atom_t tenth[] = { 1 }, three[] = { 3 };
+  atom_t got[100];
+  cr_assert(b10_frac_to_b256(got, 100, tenth, 1));
+  cr_assert_eq(got[0], 0x19);
+  cr_assert_eq(got[99], 0x99);
+  cr_assert(b10_frac_to_b256(got, 100, three, 1));
+  cr_assert_eq(got[0], 0x4C);
+  cr_assert_eq(got[99], 0xCC);
+
+  /* the first digits do not depend on how many more are wanted */
+  for (size_t i = 0; i < 8 * N; i++) { b10[i] = (atom_t) ((i * 7 + i / 3) % 10); }
+  atom_t few[40], many[N];
+  cr_assert(b10_frac_to_b256(few, 40, b10, 8 * N));
+  cr_assert(b10_frac_to_b256(many, N, b10, 8 * N));
+  cr_assert_arr_eq(few, many, 40);
+
+  atom_t dec_few[40], dec_many[8 * N];
+  cr_assert(b256_frac_to_b10(dec_few, 40, b256, N));
+  cr_assert(b256_frac_to_b10(dec_many, 8 * N, b256, N));
+  cr_assert_arr_eq(dec_few, dec_many, 40);
+}
+
 Test(b10_to_b256, u64) {
   const atom_t a[1] = { 1 };
   uint16_t len = 0;
@@ -53,3 +137,31 @@ Test(b10_to_b256, u64) {
   cr_assert_arr_eq(a, f, len);
   free(f);
 }
+
+Test(b10_to_b256, digits_n) {
+  static const char record[] = "65536,255.5";
+  const atom_t a[] = { 1, 0, 0 }, b[] = { 255, 128 };
+  uint16_t len = 0, int_len = 0;
+
+  atom_t* d = u64_digits_to_b256_n(record, 5, &len, false);
+  cr_assert_eq(len, 3);
+  cr_assert_arr_eq(a, d, len);
+  free(d);
+
+  d = ldbl_digits_to_b256_n(record + 6, 5, &len, &int_len, false);
+  cr_assert_eq(len, 2);
+  cr_assert_eq(int_len, 1);
+  cr_assert_arr_eq(b, d, len);
+  free(d);
+
+  /* and little endian, turned around in place */
+  const atom_t rb[] = { 128, 255 };
+  d = ldbl_digits_to_b256_n(record + 6, 5, &len, &int_len, true);
+  cr_assert_eq(len, 2);
+  cr_assert_arr_eq(rb, d, len);
+  free(d);
+
+  errno = 0;
+  cr_assert_null(u64_digits_to_b256_n(record, 6, &len, false));
+  cr_assert_eq(errno, EINVAL);
+}
@@ -0,0 +1,109 @@
+#include <criterion/criterion.h>
+
+#include "../lib/bn_common.h"
+
+Test(bcd, digits) {
+  /* 123.4 is 01 23 . 40 */
+  static const atom_t d[] = { 1, 2, 3, 4 }, packed[] = { 0x01, 0x23, 0x40 };
+  atom_t bytes[40], back[80];
+  size_t int_len = 0;
+
+  cr_assert_eq(b10_to_bcd(bytes, d, 4, 3, &int_len), 3);
+  cr_assert_eq(int_len, 2);
+  cr_assert_arr_eq(bytes, packed, 3);
+
+  cr_assert_eq(bcd_to_b10(back, bytes, 3, 2, &int_len), 4);
+  cr_assert_eq(int_len, 3);
+  cr_assert_arr_eq(back, d, 4);
+
+  /* long enough for the vector kernels, with odd parts */
+  atom_t many[76];
+  for (size_t i = 0; i < sizeof many; i++) { many[i] = (atom_t) (1 + i % 9); }
+
+  cr_assert_eq(b10_to_bcd(bytes, many, 76, 37, &int_len), 19 + 20);
+  cr_assert_eq(int_len, 19);
+  cr_assert_eq(bytes[0], 1);
+  cr_assert_eq(bytes[1], 0x23);
+  cr_assert_eq(bytes[38], 0x40);
+
+  cr_assert_eq(bcd_to_b10(back, bytes, 39, 19, &int_len), 76);
+  cr_assert_eq(int_len, 37);
+  cr_assert_arr_eq(back, many, 76);
+}
+
+/* the value of the last 8 digits of n bytes */
+static uint32_t bcd_low (const atom_t* const b, const size_t n) {
+  uint32_t v = 0;
+  for (size_t i = n - 4; i < n; i++) { v = v * 100 + (uint32_t) (b[i] >> 4) * 10 + (b[i] & 0x0F); }
+  return v;
+}
+
+Test(bcd, add_cmp) {
+  enum { N = 45 };
+  atom_t a[N], b[N], r[N], digits[2 * N];
+
+  /* 99...9 + 00...1 carries through every word and byte */
+  memset(a, 0x99, N);
+  memset(b, 0, N);
+  b[N - 1] = 1;
+  cr_assert_eq(bcd_add(r, a, b, N), 1);
+  for (size_t i = 0; i < N; i++) { cr_assert_eq(r[i], 0); }
+
+  /* random digits, checked against the sum of their low 8 digits, and the
+    sum read back digit by digit */
+  uint32_t x = 7;
+  for (int round = 0; round < 50; round++) {
+    for (size_t i = 0; i < 2 * N; i++) { digits[i] = (atom_t) ((x = x * 1103515245U + 12345U) >> 16) % 10; }
+    b10_to_bcd(a, digits, 2 * N, 2 * N, NULL);
+    for (size_t i = 0; i < 2 * N; i++) { digits[i] = (atom_t) ((x = x * 1103515245U + 12345U) >> 16) % 10; }
+    b10_to_bcd(b, digits, 2 * N, 2 * N, NULL);
+
+    const uint32_t low = (bcd_low(a, N) + bcd_low(b, N)) % 100000000U;
+    const atom_t carry = bcd_add(r, a, b, N);
+    cr_assert_eq(bcd_low(r, N), low);
+
+    /* every nibble is still a digit */
+    for (size_t i = 0; i < N; i++) { cr_assert((r[i] >> 4) < 10 && (r[i] & 0x0F) < 10); }
+
+    /* without a carry out, a sum is never less than what was added */
+    cr_assert(carry || bcd_cmp(r, a, N) >= 0);
+  }
+
+  memcpy(b, a, N);
+  cr_assert_eq(bcd_cmp(a, b, N), 0);
+  b[40]++;
+  cr_assert_lt(bcd_cmp(a, b, N), 0);
+  cr_assert_gt(bcd_cmp(b, a, N), 0);
+}
+
+Test(bcd, arrays) {
+  static const char lit[] = "-9876543210.5";
+
+  atom_t* const bcd = str_to_digit_array(lit, sizeof lit - 1, TYP_BCD);
+  cr_assert_not_null(bcd);
+  cr_assert(bna_is_bcd(bcd));
+  cr_assert_eq(bna_int_len(bcd), 5);
+  cr_assert_eq(bna_frac_len(bcd), 1);
+  cr_assert_eq(bcd[HEADER_OFFSET], 0x98);
+  cr_assert_eq(bcd[HEADER_OFFSET + 5], 0x50);
+
+  atom_t* const bna = bcd_array_to_b10_array(bcd);
+  char* const str = b10_to_ldbl_digits(bna + HEADER_OFFSET, (uint16_t) (bna_int_len(bna) + bna_frac_len(bna)), bna_int_len(bna));
+  cr_assert_str_eq(str, lit + 1);
+  free(str), free(bna);
+
+  cr_assert(compare_eps(digit_array_to_dbl(bcd), -9876543210.5, 1e-6));
+
+  /* 9876543210.5 + 0.75 lines up the separators */
+  static const atom_t q[] = { 0x75 };
+  size_t len = 0, int_len = 0;
+  atom_t* const sum = add_bcd(bcd + HEADER_OFFSET, 6, 5, q, 1, 0, &len, &int_len);
+  static const atom_t expect[] = { 0x98, 0x76, 0x54, 0x32, 0x11, 0x25 };
+  cr_assert_eq(len, 6);
+  cr_assert_eq(int_len, 5);
+  cr_assert_arr_eq(sum, expect, 6);
+
+  cr_assert_gt(cmp_bcd(sum, len, int_len, bcd + HEADER_OFFSET, 6, 5), 0);
+  cr_assert_lt(cmp_bcd(q, 1, 0, sum, len, int_len), 0);
+  free(sum), free(bcd);
+}
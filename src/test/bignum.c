@@ -0,0 +1,138 @@
+#include <criterion/criterion.h>
+
+#include "../lib/bn_common.h"
+
+/* an allocator which counts what it hands out */
+static size_t bignum_allocs = 0;
+
+static void* count_malloc (const size_t size, void* const ctx) {
+  (void) ctx;
+  bignum_allocs++;
+  return malloc(size);
+}
+
+static void* count_realloc (void* const ptr, const size_t size, void* const ctx) {
+  (void) ctx;
+  bignum_allocs++;
+  return realloc(ptr, size);
+}
+
+static void count_free (void* const ptr, void* const ctx) {
+  (void) ctx;
+  free(ptr);
+}
+
+Test(bignum, inline) {
+  const bn_allocator_t a = { count_malloc, count_realloc, count_free, NULL };
+  cr_assert(bn_set_allocator(&a));
+
+  /* small values live in the structure, which is all there is to allocate */
+  bignum_allocs = 0;
+  bignum_t* const seven = bignum_ctor(0, 7, FL_NONE, NULL);
+  cr_assert_not_null(seven);
+  cr_assert(bignum_is_inline(seven));
+  cr_assert_eq(bignum_allocs, 1);
+
+  const atom_t want_seven[] = { TYP_COMPACT | CMP_SHORT | cmp_value_bits(1), 7 };
+  cr_assert_arr_eq(bignum_value(seven), want_seven, sizeof want_seven);
+
+  bignum_t* const neg = bignum_ctor(-12.5L, 0, FL_NONE, NULL);
+  cr_assert(bignum_is_inline(neg));
+  const atom_t want_neg[] = { TYP_COMPACT | cmp_value_bits(FL_SIGN), 0x21, 1, 2, 5 };
+  cr_assert_arr_eq(bignum_value(neg), want_neg, sizeof want_neg);
+
+  /* so is their copy */
+  bignum_allocs = 0;
+  bignum_t* const copy = bignum_copy(neg, false);
+  cr_assert_eq(bignum_allocs, 1);
+  cr_assert(bignum_is_inline(copy));
+  cr_assert_arr_eq(bignum_value(copy), want_neg, sizeof want_neg);
+
+  bignum_free(seven), bignum_free(neg), bignum_free(copy);
+  bn_scratch_release();
+  cr_assert(bn_set_allocator(NULL));
+}
+
+Test(bignum, outgrown) {
+  /* 20 digits are too many for a compact array */
+  bignum_t* const big = bignum_ctor(0, UINT64_MAX, FL_NONE, NULL);
+  cr_assert_not_null(big);
+  cr_assert(! bignum_is_inline(big));
+  cr_assert(meta_is_big(bignum_value(big)[0]));
+  cr_assert_eq(bna_int_len(bignum_value(big)), 20);
+
+  atom_t* const want = to_digit_array(0, UINT64_MAX, FL_NONE, TYP_BIG);
+  cr_assert_arr_eq(bignum_value(big), want, bna_real_len(want));
+
+  /* 15 digits on each side of the separator still fit */
+  bignum_t* const edge = bignum_ctor(0, 999999999999999U, FL_NONE, NULL);
+  cr_assert(bignum_is_inline(edge));
+
+  /* the optional parts are copied, and a copy of a copy is equal but apart */
+  const bignum_t* const opts[] = { edge, NULL, big };
+  bignum_t* const cx = bignum_ctor(0, 3, FL_NONE, opts);
+  cr_assert_arr_eq(cx->imgry, bignum_value(edge), bna_real_len(bignum_value(edge)));
+  cr_assert_null(cx->fracl);
+  cr_assert_neq(cx->expt, big);
+  cr_assert_arr_eq(bignum_value(cx->expt), want, bna_real_len(want));
+
+  bignum_t* const again = bignum_copy(cx, false);
+  cr_assert_neq(again->imgry, cx->imgry);
+  cr_assert_neq(bignum_value(again->expt), bignum_value(big));
+  cr_assert_arr_eq(bignum_value(again->expt), want, bna_real_len(want));
+
+  bignum_t* const bare = bignum_copy(cx, true);
+  cr_assert_null(bare->imgry);
+  cr_assert_null(bare->expt);
+
+  /* and nothing at all is zero */
+  bignum_t* const zero = bignum_copy(NULL, false);
+  cr_assert_eq(bna_int_len(bignum_value(zero)), 0);
+  cr_assert_eq(bna_frac_len(bignum_value(zero)), 0);
+  cr_assert_eq(bna_flags(bignum_value(zero)), FL_NONE);
+
+  free(want);
+  bignum_free(big), bignum_free(edge), bignum_free(cx);
+  bignum_free(again), bignum_free(bare), bignum_free(zero);
+}
+
+/* whether p is in bn's block */
+static bool in_block (const bignum_t* const bn, const void* const p) {
+  const atom_t* const at = (const atom_t*) p, * const base = (const atom_t*) (const void*) bn;
+  return at >= base && at < base + bn->size;
+}
+
+Test(bignum, block) {
+  const bn_allocator_t a = { count_malloc, count_realloc, count_free, NULL };
+  cr_assert(bn_set_allocator(&a));
+
+  bignum_t* const im = bignum_ctor(0, 4, FL_NONE, NULL);
+  bignum_t* const ex = bignum_ctor(1e40L, 0, FL_NONE, NULL);
+  const bignum_t* const opts[] = { im, im, ex };
+
+  /* a number with every part is still one allocation */
+  bignum_allocs = 0;
+  bignum_t* const bn = bignum_ctor(0, UINT64_MAX, FL_NONE, opts);
+  cr_assert_eq(bignum_allocs, 1);
+  cr_assert(in_block(bn, bn->value) && in_block(bn, bn->imgry) && in_block(bn, bn->fracl));
+  cr_assert(in_block(bn, bn->expt) && in_block(bn, bn->expt->value));
+  cr_assert_eq(bn->size % BIGNUM_ALIGN, 0);
+
+  /* and so is its copy, whose parts are all in the new block */
+  bignum_allocs = 0;
+  bignum_t* const copy = bignum_copy(bn, false);
+  cr_assert_eq(bignum_allocs, 1);
+  cr_assert_eq(copy->size, bn->size);
+  cr_assert(in_block(copy, copy->value) && in_block(copy, copy->imgry) && in_block(copy, copy->fracl));
+  cr_assert(in_block(copy, copy->expt) && in_block(copy, copy->expt->value));
+  cr_assert_arr_eq(copy->value, bn->value, bna_real_len(bn->value));
+  cr_assert_arr_eq(bignum_value(copy->expt), bignum_value(ex), bna_real_len(bignum_value(ex)));
+
+  /* the original can go first */
+  bignum_free(bn);
+  cr_assert_eq(bna_int_len(bignum_value(copy->expt)), 41);
+
+  bignum_free(copy), bignum_free(im), bignum_free(ex);
+  bn_scratch_release();
+  cr_assert(bn_set_allocator(NULL));
+}
@@ -0,0 +1,89 @@
+#include <criterion/criterion.h>
+
+#include "../lib/bn_common.h"
+
+/* the buffer's value as a string, in a static buffer */
+static const char* buf_str (const bn_buf_t* const b) {
+  static char str[256];
+  cr_assert_lt(bn_buf_to_ldbl_digits_into(str, sizeof str, b), sizeof str);
+  return str;
+}
+
+/* add, or take, a literal like "123.45" */
+static bool buf_op (bn_buf_t* const b, const char* const lit, const char op) {
+  size_t len = 0, int_len = 0;
+  atom_t* const digits = ldbl_digits_to_b10_z(lit, strlen(lit), &len, &int_len, false);
+  const bool ok = '+' == op ? bn_buf_add(b, digits, len, int_len) : bn_buf_sub(b, digits, len, int_len);
+  free(digits);
+  return ok;
+}
+
+Test(bn_buf, sums) {
+  bn_buf_t* const b = bn_buf_new(4);
+  cr_assert_str_eq(buf_str(b), "0");
+
+  cr_assert(buf_op(b, "99.5", '+'));
+  cr_assert(buf_op(b, "0.75", '+'));
+  cr_assert_str_eq(buf_str(b), "100.25");
+
+  cr_assert(buf_op(b, "0.25", '-'));
+  cr_assert_str_eq(buf_str(b), "100");
+  cr_assert(buf_op(b, "99.995", '-'));
+  cr_assert_str_eq(buf_str(b), "0.005");
+
+  /* below zero is refused, and changes nothing */
+  errno = 0;
+  cr_assert(! buf_op(b, "1", '-'));
+  cr_assert_eq(errno, ERANGE);
+  cr_assert_str_eq(buf_str(b), "0.005");
+
+  cr_assert(buf_op(b, "0.005", '-'));
+  cr_assert_str_eq(buf_str(b), "0");
+  cr_assert_eq(b->len, 0);
+
+  bn_buf_free(b);
+}
+
+Test(bn_buf, in_place) {
+  bn_buf_t* const b = bn_buf_new(0);
+
+  /* counting only moves the digits when the buffer grows */
+  size_t moves = 0;
+  const atom_t* data = b->data;
+  for (size_t i = 0; i < 100000; i++) {
+    cr_assert(bn_buf_succ(b));
+    if (b->data != data) { moves++, data = b->data; }
+  }
+  cr_assert_str_eq(buf_str(b), "100000");
+  cr_assert_eq(moves, 0);
+
+  cr_assert(bn_buf_mul_small(b, 4000000000U));
+  cr_assert_str_eq(buf_str(b), "400000000000000");
+
+  cr_assert(bn_buf_shift(b, -16));
+  cr_assert_str_eq(buf_str(b), "0.04");
+  cr_assert(bn_buf_shift(b, 3));
+  cr_assert_str_eq(buf_str(b), "40");
+  cr_assert(bn_buf_shift(b, 2));
+  cr_assert_str_eq(buf_str(b), "4000");
+
+  /* the view is of the same digits */
+  const bn_view_t v = bn_buf_view(b);
+  cr_assert_eq(v.data, b->data + b->off);
+  cr_assert_eq(view_len(v), 4);
+
+  static const atom_t x[] = { 1, 2, 5 };
+  cr_assert(bn_buf_set(b, x, 3, 1));
+  cr_assert(bn_buf_mul_small(b, 8));
+  cr_assert_str_eq(buf_str(b), "10");
+
+  cr_assert(bn_buf_mul_small(b, 0));
+  cr_assert_str_eq(buf_str(b), "0");
+
+  /* growing at the front many times over stays linear */
+  for (size_t i = 0; i < 200; i++) { cr_assert(bn_buf_mul_small(b, 10) && bn_buf_succ(b)); }
+  cr_assert_eq(b->len, 200);
+  cr_assert_lt(b->cap, 1024);
+
+  bn_buf_free(b);
+}
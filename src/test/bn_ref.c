@@ -0,0 +1,66 @@
+#include <criterion/criterion.h>
+#include <pthread.h>
+
+#include "../lib/bn_common.h"
+
+Test(bn_ref, copy_on_write) {
+  atom_t* const bna = to_digit_array(0, 1234, FL_NONE, TYP_NONE);
+  bn_ref_t* const a = bn_ref_new(bna);
+  cr_assert_not_null(a);
+  cr_assert_arr_eq(bn_ref_digits(a), bna, bna_size(bna));
+  cr_assert_eq(bn_ref_count(a), 1);
+
+  /* sharing copies nothing */
+  bn_ref_t* b = bn_ref_share(a);
+  cr_assert_eq(b, a);
+  cr_assert_eq(bn_ref_count(a), 2);
+
+  /* changing a shared array moves the changer's hold to a copy */
+  atom_t* const digits = bn_ref_mut(&b);
+  cr_assert_neq(b, a);
+  cr_assert_eq(bn_ref_count(a), 1);
+  cr_assert_eq(bn_ref_count(b), 1);
+  digits[HEADER_OFFSET] = 9;
+  cr_assert_eq(bn_ref_digits(a)[HEADER_OFFSET], 1);
+  cr_assert_eq(bn_ref_digits(b)[HEADER_OFFSET], 9);
+
+  /* and one held once is changed where it is */
+  bn_ref_t* const c = b;
+  cr_assert_eq(bn_ref_mut(&b), digits);
+  cr_assert_eq(b, c);
+
+  /* packed arrays are shared whole */
+  atom_t* const pna = str_to_digit_array("98765432109876543210.5", 22, TYP_PACK);
+  bn_ref_t* const p = bn_ref_new(pna);
+  cr_assert_arr_eq(bn_ref_digits(p), pna, bna_size(pna));
+
+  errno = 0;
+  cr_assert_null(bn_ref_new(NULL));
+  cr_assert_eq(errno, EINVAL);
+
+  bn_ref_release(a), bn_ref_release(b), bn_ref_release(p), bn_ref_release(NULL);
+  free(bna), free(pna);
+}
+
+static void* share_many (void* const arg) {
+  bn_ref_t* const ref = (bn_ref_t*) arg;
+  for (size_t i = 0; i < 100000; i++) {
+    bn_ref_release(bn_ref_share(bn_ref_share(ref)));
+    bn_ref_release(ref);
+  }
+  return NULL;
+}
+
+Test(bn_ref, threads) {
+  atom_t* const bna = to_digit_array(0, 7, FL_NONE, TYP_COMPACT);
+  bn_ref_t* const ref = bn_ref_new(bna);
+
+  /* every count change is seen, whichever thread makes it */
+  pthread_t threads[4];
+  for (size_t i = 0; i < 4; i++) { cr_assert_eq(pthread_create(threads + i, NULL, share_many, ref), 0); }
+  for (size_t i = 0; i < 4; i++) { pthread_join(threads[i], NULL); }
+
+  cr_assert_eq(bn_ref_count(ref), 1);
+  bn_ref_release(ref);
+  free(bna);
+}
@@ -0,0 +1,111 @@
+#include <criterion/criterion.h>
+
+#include "../lib/bn_common.h"
+
+/* the sum of two literals in the given metadata's base, as a string */
+static char* view_sum_str (const char* const a, const char* const b, const atom_t metadata, const char op) {
+  atom_t* const x = str_to_digit_array(a, strlen(a), metadata);
+  atom_t* const y = str_to_digit_array(b, strlen(b), metadata);
+  cr_assert(NULL != x && NULL != y);
+
+  bn_view_t r;
+  atom_t* const data = '+' == op ? add_view(bn_view(x), bn_view(y), &r)
+                     : '-' == op ? sub_view(bn_view(x), bn_view(y), &r)
+                     : mul_view(bn_view(x), bn_view(y), &r);
+  cr_assert_not_null(data);
+  cr_assert_eq(r.data, data);
+
+  char* const str = view_to_ldbl_digits(r);
+  free(x), free(y), free(data);
+  return str;
+}
+
+Test(bn_view, decode) {
+  /* the same value through every kind of header */
+  static const atom_t modes[] = { TYP_NONE, TYP_BIG, TYP_HUGE, TYP_COMPACT };
+  for (size_t i = 0; i < sizeof modes; i++) {
+    atom_t* const bna = str_to_digit_array("-123.45", 7, modes[i]);
+    const bn_view_t v = bn_view(bna);
+
+    cr_assert_eq(v.data, bna + bna_header_offset(bna));
+    cr_assert_eq(v.int_len, 3);
+    cr_assert_eq(v.frac_len, 2);
+    cr_assert_eq(v.base, TYP_NONE);
+    cr_assert_eq(v.flags, FL_SIGN);
+    cr_assert(compare_eps(view_to_dbl(v), -123.45, 1e-12));
+
+    /* slices share the data */
+    const bn_view_t ip = view_int_part(v), fp = view_frac_part(v);
+    cr_assert(ip.data == v.data && 3 == view_len(ip));
+    cr_assert(fp.data == v.data + 3 && 2 == view_len(fp) && 0 == fp.int_len);
+    cr_assert(compare_eps(view_to_dbl(fp), -0.45, 1e-12));
+    free(bna);
+  }
+
+  /* a packed view's elements are words */
+  atom_t* const pna = str_to_digit_array("12345678901234567890123.5", 25, TYP_PACK);
+  const bn_view_t v = bn_view(pna);
+  cr_assert_eq(v.base, TYP_PACK);
+  cr_assert_eq(view_elem_size(v), 8);
+  cr_assert_eq(view_frac_part(v).data, v.data + 16);
+
+  char* const str = view_to_ldbl_digits(v);
+  cr_assert_str_eq(str, "12345678901234567890123.5");
+  free(str), free(pna);
+
+  static const atom_t raw[] = { 4, 2, 5 };
+  const bn_view_t r = bn_view_raw(raw, 3, 2, TYP_NONE);
+  cr_assert(compare_eps(view_to_ldbl(r), 42.5, 1e-12));
+
+  /* walked from the bottom without copying */
+  cr_assert_eq(view_elem_le(r, 0), 5);
+  cr_assert_eq(view_elem_le(r, 2), 4);
+
+  atom_t* const big = str_to_digit_array("10000000000000000000.5", 22, TYP_PACK);
+  cr_assert_eq(view_elem_le(bn_view(big), 0), 5000000000000000000U);
+  cr_assert_eq(view_elem_le(bn_view(big), 1), 0);
+  cr_assert_eq(view_elem_le(bn_view(big), 2), 1);
+  free(big);
+}
+
+Test(bn_view, math) {
+  static const atom_t bases[] = { TYP_NONE, TYP_PACK, TYP_BCD, TYP_ZENZ };
+  for (size_t i = 0; i < sizeof bases; i++) {
+    char* s = view_sum_str("99999999999999999999.75", "0.25", bases[i], '+');
+    cr_assert_str_eq(s, "100000000000000000000");
+    free(s);
+
+    s = view_sum_str("1000.5", "0.75", bases[i], '-');
+    cr_assert_str_eq(s, "999.75");
+    free(s);
+
+    s = view_sum_str("12.5", "0.5", bases[i], '*');
+    cr_assert_str_eq(s, "6.25");
+    free(s);
+  }
+
+  /* a negative difference is out of range */
+  atom_t* const one = str_to_digit_array("1", 1, TYP_ZENZ);
+  atom_t* const two = str_to_digit_array("2", 1, TYP_ZENZ);
+  bn_view_t r;
+  errno = 0;
+  cr_assert_null(sub_view(bn_view(one), bn_view(two), &r));
+  cr_assert_eq(errno, ERANGE);
+
+  cr_assert_lt(cmp_view(bn_view(one), bn_view(two)), 0);
+  cr_assert_gt(cmp_view(bn_view(two), bn_view(one)), 0);
+  cr_assert_eq(cmp_view(bn_view(one), bn_view(one)), 0);
+
+  /* views in different bases do not mix */
+  atom_t* const ten = str_to_digit_array("1", 1, TYP_NONE);
+  errno = 0;
+  cr_assert_null(add_view(bn_view(one), bn_view(ten), &r));
+  cr_assert_eq(errno, EINVAL);
+  cr_assert_eq(cmp_view(bn_view(one), bn_view(ten)), 2);
+  free(one), free(two), free(ten);
+
+  /* leading and trailing zeroes do not change a comparison */
+  static const atom_t a[] = { 0, 0, 1, 2, 5, 0 }, b[] = { 1, 2, 5 };
+  cr_assert_eq(cmp_view(bn_view_raw(a, 6, 4, TYP_NONE), bn_view_raw(b, 3, 2, TYP_NONE)), 0);
+  cr_assert_lt(cmp_view(bn_view_raw(b, 3, 2, TYP_NONE), bn_view_raw(a, 6, 5, TYP_NONE)), 0);
+}
@@ -0,0 +1,177 @@
+#include <criterion/criterion.h>
+
+#include "../lib/bn_common.h"
+
+/* add a literal like "123.45" to a chain */
+static void chain_add_str (digit_chain_t* const dc, const char* const str) {
+  size_t len = 0, int_len = 0;
+  atom_t* const digits = ldbl_digits_to_b10_z(str, strlen(str), &len, &int_len, false);
+  cr_assert(digit_chain_add(dc, digits, len, int_len));
+  free(digits);
+}
+
+/* the chain as a new string */
+static char* chain_str (const digit_chain_t* const dc) {
+  const size_t need = digit_chain_to_ldbl_digits_into(NULL, 0, dc);
+  char* const str = alloc(char, need + 1);
+  cr_assert_eq(digit_chain_to_ldbl_digits_into(str, need + 1, dc), need);
+  return str;
+}
+
+Test(digit_chain, sums) {
+  digit_chain_t* const dc = digit_chain_new();
+
+  char* str = chain_str(dc);
+  cr_assert_str_eq(str, "0");
+  free(str);
+
+  chain_add_str(dc, "123.45");
+  chain_add_str(dc, "0.55");
+  str = chain_str(dc);
+  cr_assert_str_eq(str, "124");
+  free(str);
+
+  chain_add_str(dc, "0.0625");
+  str = chain_str(dc);
+  cr_assert_str_eq(str, "124.0625");
+  free(str);
+
+  digit_chain_free(dc);
+
+  /* below 1, with no integer chunk at all */
+  digit_chain_t* const small = digit_chain_new();
+  chain_add_str(small, "0.5");
+  str = chain_str(small);
+  cr_assert_str_eq(str, "0.5");
+  free(str);
+  digit_chain_free(small);
+}
+
+Test(digit_chain, chunks) {
+  enum { N = 5000 };
+  char* const nines = alloc(char, N + 1);
+  memset(nines, '9', N);
+  nines[N] = '\0';
+
+  digit_chain_t* const dc = digit_chain_new();
+  chain_add_str(dc, nines);
+  cr_assert_eq(dc->nchunks, 2);
+
+  /* the carry runs out of the top chunk's digits, but not out of the chunk */
+  chain_add_str(dc, "1");
+  cr_assert_eq(dc->nchunks, 2);
+  cr_assert_eq(dc->chunks[0][0], TYP_BIG | TYP_EXTN);
+  cr_assert_eq(dc->chunks[1][0], TYP_BIG | TYP_OVERF);
+
+  size_t len = 0, int_len = 0;
+  atom_t* raw = digit_chain_raw(dc, &len, &int_len);
+  cr_assert_eq(len, N + 1);
+  cr_assert_eq(int_len, N + 1);
+  cr_assert_eq(raw[0], 1);
+  cr_assert(raw_is_zero(raw + 1, N));
+  free(raw);
+
+  /* a fraction grows the chain downwards, and a far digit grows it upwards
+    past places with nothing in them */
+  chain_add_str(dc, "0.5");
+  chain_add_str(dc, "1e20000");
+  cr_assert_eq(dc->low, -1);
+  cr_assert_eq(dc->nchunks, 20000 / 4096 + 2);
+  cr_assert_eq(dc->chunks[0][0], TYP_BIG | TYP_EXTN);
+  cr_assert_eq(dc->chunks[1][0], TYP_BIG | TYP_EXTN | TYP_OVERF);
+  cr_assert_eq(dc->chunks[dc->nchunks - 1][0], TYP_BIG | TYP_OVERF);
+
+  /* each chunk is an array in its own right */
+  cr_assert_eq(bna_int_len(dc->chunks[0]), 0);
+  cr_assert_eq(bna_frac_len(dc->chunks[0]), 4096);
+  cr_assert_eq(bna_int_len(dc->chunks[1]), 4096);
+
+  raw = digit_chain_raw(dc, &len, &int_len);
+  cr_assert_eq(int_len, 20001);
+  cr_assert_eq(len, 20002);
+  cr_assert(1 == raw[0] && 1 == raw[20001 - N - 1] && 5 == raw[20001]);
+  free(raw);
+
+  digit_chain_free(dc);
+  free(nines);
+}
+
+/* a flat reference: digits at powers 10^-REF_SIDE up to 10^(REF_SIDE - 1) */
+#define REF_SIDE 7000
+
+Test(digit_chain, against_flat) {
+  atom_t* const ref = zalloc(atom_t, 2 * REF_SIDE);
+  atom_t* const num = alloc(atom_t, 2 * REF_SIDE);
+  digit_chain_t* const dc = digit_chain_new();
+
+  uint32_t x = 99;
+  for (int round = 0; round < 60; round++) {
+    const size_t int_len  = ((x = x * 1103515245U + 12345U) >> 8) % (REF_SIDE - 10),
+                 frac_len = ((x = x * 1103515245U + 12345U) >> 8) % REF_SIDE;
+    for (size_t i = 0; i < int_len + frac_len; i++) {
+      num[i] = (atom_t) (((x = x * 1103515245U + 12345U) >> 16) % 10);
+    }
+
+    cr_assert(digit_chain_add(dc, num, int_len + frac_len, int_len));
+
+    /* ref[REF_SIDE - 1] is the units digit */
+    atom_t carry = 0;
+    for (size_t i = int_len + frac_len; i--; ) {
+      atom_t* const d = ref + REF_SIDE - int_len + i;
+      const atom_t sum = (atom_t) (*d + num[i] + carry);
+      carry = sum >= 10;
+      *d    = (atom_t) (sum % 10);
+    }
+    for (size_t at = REF_SIDE - int_len; carry; at--) {
+      const atom_t sum = (atom_t) (ref[at - 1] + 1);
+      carry = sum >= 10;
+      ref[at - 1] = (atom_t) (sum % 10);
+    }
+  }
+
+  size_t first = 0, last = 2 * REF_SIDE;
+  while (! ref[first]) { first++; }
+  while (! ref[last - 1]) { last--; }
+
+  size_t len = 0, int_len = 0;
+  atom_t* const raw = digit_chain_raw(dc, &len, &int_len);
+  cr_assert_eq(int_len, REF_SIDE - first);
+  cr_assert_eq(len, last - first);
+  cr_assert_arr_eq(raw, ref + first, len);
+
+  free(raw), free(ref), free(num);
+  digit_chain_free(dc);
+}
+
+Test(digit_chain, arrays) {
+  digit_chain_t* const dc = digit_chain_new();
+  chain_add_str(dc, "255.5");
+
+  atom_t* a = digit_chain_to_array(dc, TYP_NONE, FL_SIGN);
+  atom_t z[HEADER_OFFSET + 4] = { TYP_NONE, 3, 1, FL_SIGN, 2, 5, 5, 5 };
+  cr_assert_arr_eq(a, z, sz(atom_t, HEADER_OFFSET + 4));
+  free(a);
+
+  a = digit_chain_to_array(dc, TYP_ZENZ, FL_NONE);
+  atom_t b[HEADER_OFFSET + 2] = { TYP_ZENZ, 1, 1, FL_NONE, 255, 128 };
+  cr_assert_arr_eq(a, b, sz(atom_t, HEADER_OFFSET + 2));
+  free(a);
+
+  a = digit_chain_to_array(dc, TYP_PACK, FL_NONE);
+  cr_assert(bna_is_packed(a));
+  cr_assert_eq(pk_load(a + HEADER_OFFSET), 255);
+  free(a);
+
+  /* 300 integer digits need a bigger header */
+  chain_add_str(dc, "1e299");
+  errno = 0;
+  cr_assert_null(digit_chain_to_array(dc, TYP_NONE, FL_NONE));
+  cr_assert_eq(errno, ERANGE);
+
+  a = digit_chain_to_array(dc, TYP_HUGE, FL_NONE);
+  cr_assert_eq(bna_int_len(a), 300);
+  cr_assert_eq(a[HEADER_OFFSET_HUGE], 1);
+  free(a);
+
+  digit_chain_free(dc);
+}
@@ -0,0 +1,104 @@
+#include <criterion/criterion.h>
+
+#include "../lib/bn_common.h"
+
+/* incremental parsing, in pieces of every size */
+
+Test(digit_stream, feed_b10) {
+  static const char num[] = "  -00123.4560\n";
+  atom_t z[HEADER_OFFSET + 7] = { TYP_NONE, 3, 4, FL_SIGN, 1, 2, 3, 4, 5, 6, 0 };
+
+  for (size_t piece = 1; piece <= sizeof num - 1; piece++) {
+    digit_stream_t* const ds = digit_stream_new(TYP_NONE);
+
+    for (size_t at = 0; at < sizeof num - 1; at += piece) {
+      cr_assert(digit_stream_feed(ds, num + at, min(piece, sizeof num - 1 - at)));
+    }
+
+    atom_t* const a = digit_stream_finish(ds);
+    cr_assert_arr_eq(z, a, sz(atom_t, HEADER_OFFSET + 7));
+    free(a);
+    digit_stream_free(ds);
+  }
+}
+
+Test(digit_stream, feed_b256) {
+  digit_stream_t* const ds = digit_stream_new(TYP_ZENZ);
+
+  /* 2^64 + 0.5, split inside the digits */
+  cr_assert(digit_stream_feed(ds, "184467440", 9));
+  cr_assert(digit_stream_feed(ds, "73709551616.", 12));
+  cr_assert(digit_stream_feed(ds, "5", 1));
+
+  atom_t* const a = digit_stream_finish(ds);
+  atom_t z[HEADER_OFFSET + 10] = { TYP_ZENZ, 9, 1, FL_NONE, 1, 0, 0, 0, 0, 0, 0, 0, 0, 128 };
+  cr_assert_arr_eq(z, a, sz(atom_t, HEADER_OFFSET + 10));
+
+  free(a);
+  digit_stream_free(ds);
+}
+
+Test(digit_stream, invalid) {
+  static const char* const bad[] = { "", "-", ".", "1.2.3", "12a", "1 2", "--1", "1-" };
+
+  for (size_t i = 0; i < sizeof bad / sizeof bad[0]; i++) {
+    digit_stream_t* const ds = digit_stream_new(TYP_NONE);
+    digit_stream_feed(ds, bad[i], strlen(bad[i]));
+
+    errno = 0;
+    cr_assert_null(digit_stream_finish(ds));
+    cr_assert_eq(errno, EINVAL);
+    digit_stream_free(ds);
+  }
+}
+
+Test(digit_stream, long_file) {
+  /* far beyond MAX_STR_LDBL_DIGITS and the header's limit */
+  const size_t n = 100000;
+  FILE* const file = tmpfile();
+  for (size_t i = 0; i < n; i++) { fputc('0' + (int) (i % 10), file); }
+  fputs(".25\n", file);
+  rewind(file);
+
+  digit_stream_t* const ds = digit_stream_new(TYP_BIG);
+  cr_assert(digit_stream_read_file(ds, file));
+  fclose(file);
+
+  errno = 0;
+  cr_assert_null(digit_stream_finish(ds));
+  cr_assert_eq(errno, ERANGE);
+
+  size_t len = 0, int_len = 0;
+  atom_t* const raw = digit_stream_raw(ds, &len, &int_len);
+  /* the leading zero is dropped */
+  cr_assert_eq(int_len, n - 1);
+  cr_assert_eq(len, n + 1);
+  for (size_t i = 0; i < int_len; i++) {
+    cr_assert_eq(raw[i], (i + 1) % 10);
+  }
+  cr_assert_eq(raw[n - 1], 2);
+  cr_assert_eq(raw[n], 5);
+
+  free(raw);
+  digit_stream_free(ds);
+}
+
+#ifdef BN_HAVE_POSIX
+Test(digit_stream, from_fd) {
+  int fds[2];
+  cr_assert_eq(pipe(fds), 0);
+  cr_assert_eq(write(fds[1], "65536\n", 6), 6);
+  close(fds[1]);
+
+  digit_stream_t* const ds = digit_stream_new(TYP_ZENZ);
+  cr_assert(digit_stream_read_fd(ds, fds[0]));
+  close(fds[0]);
+
+  atom_t* const a = digit_stream_finish(ds);
+  atom_t z[HEADER_OFFSET + 3] = { TYP_ZENZ, 3, 0, FL_NONE, 1, 0, 0 };
+  cr_assert_arr_eq(z, a, sz(atom_t, HEADER_OFFSET + 3));
+
+  free(a);
+  digit_stream_free(ds);
+}
+#endif /* BN_HAVE_POSIX */
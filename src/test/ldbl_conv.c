@@ -0,0 +1,241 @@
+#include <criterion/criterion.h>
+
+#include "../lib/bn_common.h"
+
+/* shortest round-trip digits of floating point values */
+
+static void assert_digits (const atom_t* const got, const atom_t len, const char* const want) {
+  cr_assert_eq(len, strlen(want));
+  for (atom_t i = 0; i < len; i++) {
+    cr_assert_eq(got[i], want[i] - '0');
+  }
+}
+
+Test(ldbl_conv, dbl_shortest) {
+  atom_t d[MAX_PRIMITIVE_LDBL_DIGITS];
+  int32_t k = 0;
+
+  assert_digits(d, dbl_to_shortest_digits(0.1, d, &k), "1");
+  cr_assert_eq(k, 0);
+
+  assert_digits(d, dbl_to_shortest_digits(-1234.5678, d, &k), "12345678");
+  cr_assert_eq(k, 4);
+
+  assert_digits(d, dbl_to_shortest_digits(1e23, d, &k), "1");
+  cr_assert_eq(k, 24);
+
+  assert_digits(d, dbl_to_shortest_digits(5e-324, d, &k), "5");
+  cr_assert_eq(k, -323);
+
+  assert_digits(d, dbl_to_shortest_digits(DBL_MAX, d, &k), "17976931348623157");
+  cr_assert_eq(k, 309);
+
+  assert_digits(d, dbl_to_shortest_digits(0.3, d, &k), "3");
+  assert_digits(d, dbl_to_shortest_digits(0.1 + 0.2, d, &k), "30000000000000004");
+
+  cr_assert_eq(dbl_to_shortest_digits(0.0, d, &k), 0);
+  cr_assert_eq(k, 0);
+  cr_assert_eq(dbl_to_shortest_digits(INFINITY, d, &k), 0);
+  cr_assert_eq(dbl_to_shortest_digits(NAN, d, &k), 0);
+}
+
+Test(ldbl_conv, ldbl_shortest) {
+  atom_t d[MAX_PRIMITIVE_LDBL_DIGITS];
+  int32_t k = 0;
+
+  assert_digits(d, ldbl_to_shortest_digits(1234.5678L, d, &k), "12345678");
+  cr_assert_eq(k, 4);
+
+  assert_digits(d, ldbl_to_shortest_digits(0.25L, d, &k), "25");
+  cr_assert_eq(k, 0);
+
+  /* every round trip is exact */
+  const ldbl_t values[] = { 1.0L / 3.0L, 2.0L / 3.0L, 0.1L, 123456789.987654321L, LDBL_MIN, LDBL_MAX, LDBL_MIN / 1024 };
+  for (size_t i = 0; i < sizeof values / sizeof values[0]; i++) {
+    const atom_t n = ldbl_to_shortest_digits(values[i], d, &k);
+    char buf[MAX_PRIMITIVE_LDBL_DIGITS + 16] = "0.";
+    for (atom_t j = 0; j < n; j++) { buf[2 + j] = (char) ('0' + d[j]); }
+    snprintf(buf + 2 + n, 16, "e%d", (int) k);
+    cr_assert_eq(strtold(buf, NULL), values[i], "%s", buf);
+  }
+}
+
+Test(ldbl_conv, to_digit_array) {
+  atom_t* a = to_digit_array(1234.5678L, 0, FL_NONE, TYP_NONE),
+    z[HEADER_OFFSET + 8] = { TYP_NONE, 4, 4, FL_NONE, 1, 2, 3, 4, 5, 6, 7, 8 };
+  cr_assert_arr_eq(z, a, sz(atom_t, 8 + HEADER_OFFSET));
+  free(a);
+
+  a = to_digit_array(-0.0625L, 0, FL_NONE, TYP_NONE);
+  atom_t y[HEADER_OFFSET + 4] = { TYP_NONE, 0, 4, FL_SIGN, 0, 6, 2, 5 };
+  cr_assert_arr_eq(y, a, sz(atom_t, 4 + HEADER_OFFSET));
+  free(a);
+
+  /* 301 integer digits only fit with 2 byte lengths */
+  errno = 0;
+  cr_assert_null(to_digit_array(1e300L, 0, FL_NONE, TYP_NONE));
+  cr_assert_eq(errno, ERANGE);
+
+  a = to_digit_array(1e300L, 0, FL_NONE, TYP_BIG);
+  cr_assert_not_null(a);
+  cr_assert_eq(bna_int_len(a), 301);
+  cr_assert_eq(bna_frac_len(a), 0);
+  cr_assert_eq(a[HEADER_OFFSET_BIG], 1);
+  free(a);
+
+  a = to_digit_array(NAN, 0, FL_NONE, TYP_NONE);
+  cr_assert(bna_flags(a) & FL_NAN);
+  free(a);
+
+  a = to_digit_array(-INFINITY, 0, FL_NONE, TYP_NONE);
+  cr_assert(bna_flags(a) & FL_INF);
+  cr_assert(bna_flags(a) & FL_SIGN);
+  free(a);
+}
+
+/* correctly rounded export back to hardware floating point */
+
+Test(ldbl_conv, b10_to_float) {
+  static const atom_t tenth[] = { 0, 1 };
+  cr_assert_eq(b10_to_dbl(tenth, 2, 1), 0.1);
+  cr_assert_eq(b10_to_ldbl(tenth, 2, 1), 0.1L);
+
+  static const atom_t big[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 1, 2, 3, 4, 5 };
+  cr_assert_eq(b10_to_dbl(big, 25, 25), 1234567890123456789012345.0);
+  cr_assert_eq(b10_to_dbl(big, 25, 3), 123.4567890123456789012345);
+  cr_assert_eq(b10_to_ldbl(big, 25, 3), 123.4567890123456789012345L);
+
+  /* 2^53 + 1 is halfway between two doubles, and ties to the even one */
+  static const atom_t tie[] = { 9, 0, 0, 7, 1, 9, 9, 2, 5, 4, 7, 4, 0, 9, 9, 3 };
+  cr_assert_eq(b10_to_dbl(tie, 16, 16), 9007199254740992.0);
+
+  /* leading and trailing zeroes are not significant */
+  static const atom_t padded[] = { 0, 0, 2, 5, 0, 0 };
+  cr_assert_eq(b10_to_dbl(padded, 6, 3), 2.5);
+
+  static const atom_t zero[] = { 0, 0, 0 };
+  cr_assert_eq(b10_to_dbl(zero, 3, 1), 0.0);
+  cr_assert_eq(b10_to_dbl(NULL, 0, 0), 0.0);
+
+  /* 10^400 overflows a double */
+  atom_t huge[401] = { 1 };
+  errno = 0;
+  cr_assert_eq(b10_to_dbl(huge, 401, 401), HUGE_VAL);
+  cr_assert_eq(errno, ERANGE);
+  cr_assert_eq(b10_to_ldbl(huge, 401, 401), 1e400L);
+}
+
+static void* refuse_malloc (const size_t size, void* const ctx) {
+  (void) size, (void) ctx;
+  return NULL;
+}
+
+static void* refuse_realloc (void* const ptr, const size_t size, void* const ctx) {
+  (void) ptr, (void) size, (void) ctx;
+  return NULL;
+}
+
+static void refuse_free (void* const ptr, void* const ctx) {
+  (void) ctx;
+  free(ptr);
+}
+
+Test(ldbl_conv, b10_to_float_no_memory) {
+  /* 1.000...0001, whose exact comparison is too large for the stack */
+  static atom_t near_one[5000] = { 1 };
+  near_one[4999] = 1;
+  cr_assert_eq(b10_to_ldbl(near_one, 5000, 1), 1.0L);
+
+  const bn_allocator_t none = { refuse_malloc, refuse_realloc, refuse_free, NULL };
+  cr_assert(bn_set_allocator(&none));
+
+  /* is reported, and nothing is written past the stack's buffers */
+  errno = 0;
+  const ldbl_t l = b10_to_ldbl(near_one, 5000, 1);
+  const int l_errno = errno;
+  cr_assert(isnan(l));
+  cr_assert_eq(l_errno, ENOMEM);
+
+  /* a double is only compared exactly near a halfway point, here 1 + 2^-53 */
+  static const char half[] = "100000000000000011102230246251565404236316680908203125";
+  static atom_t near_half[5000];
+  for (size_t i = 0; i < sizeof half - 1; i++) { near_half[i] = (atom_t) (half[i] - '0'); }
+  near_half[4999] = 1;
+
+  errno = 0;
+  const double d = b10_to_dbl(near_half, 5000, 1);
+  const int d_errno = errno;
+  cr_assert(isnan(d));
+  cr_assert_eq(d_errno, ENOMEM);
+
+  cr_assert(bn_set_allocator(NULL));
+}
+
+Test(ldbl_conv, b256_to_float) {
+  static const atom_t d[] = { 1, 0, 128 };
+  cr_assert_eq(b256_to_dbl(d, 3, 2), 256.5);
+  cr_assert_eq(b256_to_ldbl(d, 3, 2), 256.5L);
+
+  /* 2^64 - 1 rounds up to 2^64 as a double */
+  static const atom_t ones[] = { 255, 255, 255, 255, 255, 255, 255, 255 };
+  cr_assert_eq(b256_to_dbl(ones, 8, 8), 18446744073709551616.0);
+}
+
+Test(ldbl_conv, digit_array_round_trip) {
+  const double values[] = { 0.1, -1234.5678, 6.02214076e23, 1.0 / 3.0, 5e-324 };
+
+  for (size_t i = 0; i < sizeof values / sizeof values[0]; i++) {
+    atom_t* const a = dbl_to_digit_array(values[i], FL_NONE, TYP_BIG);
+    cr_assert_eq(digit_array_to_dbl(a), values[i]);
+    free(a);
+  }
+
+  /* a long double made from a double keeps every bit of it */
+  const ldbl_t lvalues[] = { (ldbl_t) 0.1, (ldbl_t) 0.3, (ldbl_t) 1234.5678, 0.1L };
+  for (size_t i = 0; i < sizeof lvalues / sizeof lvalues[0]; i++) {
+    atom_t* const a = to_digit_array(lvalues[i], 0, FL_NONE, TYP_BIG);
+    cr_assert_eq(digit_array_to_ldbl(a), lvalues[i]);
+    free(a);
+
+    atom_t b[64];
+    const size_t n = to_digit_array_into(b, sizeof b, lvalues[i], 0, FL_NONE, TYP_BIG);
+    cr_assert(n > 0 && n <= sizeof b);
+    cr_assert_eq(digit_array_to_ldbl(b), lvalues[i]);
+  }
+
+  /* while the double's own shortest digits are the double's */
+  atom_t* const tenth = dbl_to_digit_array(0.1, FL_NONE, TYP_NONE);
+  cr_assert_eq(bna_frac_len(tenth), 1);
+  free(tenth);
+
+  atom_t* const a = to_digit_array(-INFINITY, 0, FL_NONE, TYP_NONE);
+  cr_assert_eq(digit_array_to_ldbl(a), -INFINITY);
+  free(a);
+}
+
+Test(ldbl_conv, digit_array_into) {
+  const ldbl_t values[] = { 0.5L, -1234.5678L, 1e30L, 1e-30L, 0.0L, -INFINITY };
+  const atom_t modes[] = { TYP_NONE, TYP_ZENZ, TYP_BIG | TYP_ZENZ, TYP_PACK, TYP_BCD, TYP_COMPACT | TYP_PACK, TYP_HUGE | TYP_BCD };
+
+  for (size_t i = 0; i < sizeof values / sizeof values[0]; i++) {
+    for (size_t j = 0; j < sizeof modes; j++) {
+      atom_t* const want = to_digit_array(values[i], 0, FL_NONE, modes[j]);
+      cr_assert_not_null(want, "value %zu in mode %d", i, modes[j]);
+
+      /* the same array, in every base and packing */
+      atom_t out[128];
+      const size_t need = to_digit_array_into(NULL, 0, values[i], 0, FL_NONE, modes[j]);
+      cr_assert_eq(need, bna_size(want), "value %zu in mode %d", i, modes[j]);
+      cr_assert_eq(to_digit_array_into(out, sizeof out, values[i], 0, FL_NONE, modes[j]), need);
+      cr_assert_arr_eq(out, want, need, "value %zu in mode %d", i, modes[j]);
+      free(want);
+    }
+  }
+
+  /* and from a u64 */
+  atom_t* const want = to_digit_array(0, UINT64_MAX, FL_NONE, TYP_ZENZ);
+  atom_t out[16];
+  cr_assert_eq(to_digit_array_into(out, sizeof out, 0, UINT64_MAX, FL_NONE, TYP_ZENZ), bna_size(want));
+  cr_assert_arr_eq(out, want, bna_size(want));
+  free(want);
+}
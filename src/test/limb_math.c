@@ -0,0 +1,131 @@
+#include <criterion/criterion.h>
+
+#include "../lib/bn_common.h"
+
+/* binary multi-word kernels, checked against native 64 bit arithmetic */
+
+static uint64_t limbs_to_u64 (const limb_t* const a, const size_t len) {
+  uint64_t v = 0;
+  for (size_t i = len; i--; ) { v = (v << LIMB_BITS) | a[i]; }
+  return v;
+}
+
+Test(limb_math, add_sub) {
+  limb_t a[3] = { 0xFFFFFFFFU, 0x1U }, b[3] = { 0x1U }, r[3];
+
+  size_t n = limb_add(r, a, 2, b, 1);
+  cr_assert_eq(n, 2);
+  cr_assert_eq(limbs_to_u64(r, n), 0x200000000U);
+
+  n = limb_sub(r, r, n, b, 1);
+  cr_assert_eq(n, 2);
+  cr_assert_eq(limbs_to_u64(r, n), 0x1FFFFFFFFU);
+
+  /* carry into a new limb, and subtraction down to zero */
+  limb_t c[2] = { 0xFFFFFFFFU };
+  n = limb_add(r, c, 1, b, 1);
+  cr_assert_eq(n, 2);
+  cr_assert_eq(limbs_to_u64(r, n), 0x100000000U);
+  cr_assert_eq(limb_sub(r, c, 1, c, 1), 0);
+
+  cr_assert_lt(limb_cmp(b, 1, a, 2), 0);
+  cr_assert_gt(limb_cmp(a, 2, b, 1), 0);
+  cr_assert_eq(limb_cmp(a, 2, a, 2), 0);
+}
+
+Test(limb_math, mul_div) {
+  limb_t a[4] = { 12345 };
+  size_t n = limb_mul_pow10(a, 1, 12);
+  cr_assert_eq(limbs_to_u64(a, n), 12345000000000000U);
+
+  cr_assert_eq(limb_divmod_small(a, n, 1000, &n), 0);
+  cr_assert_eq(limbs_to_u64(a, n), 12345000000000U);
+  cr_assert_eq(limb_divmod_small(a, n, 7, &n), 12345000000000U % 7);
+  cr_assert_eq(limbs_to_u64(a, n), 12345000000000U / 7);
+
+  limb_t b[3] = { 3 };
+  n = limb_mul_small(b, 1, 0x80000000U, 5);
+  cr_assert_eq(limbs_to_u64(b, n), 0x180000005U);
+}
+
+Test(limb_math, shift_bits) {
+  limb_t a[4] = { 0x89ABCDEFU, 0x1U }, r[4];
+
+  size_t n = limb_shl(r, a, 2, 28);
+  cr_assert_eq(limbs_to_u64(r, n), 0x189ABCDEFU << 28);
+  cr_assert_eq(limb_bit_length(r, n), 61);
+  cr_assert(limb_test_bit(r, n, 60));
+  cr_assert_not(limb_test_bit(r, n, 61));
+  cr_assert_not(limb_test_bit(r, n, 200));
+
+  n = limb_shr(r, r, n, 28);
+  cr_assert_eq(limbs_to_u64(r, n), 0x189ABCDEFU);
+
+  n = limb_shl(r, a, 2, 32);
+  cr_assert_eq(n, 3);
+  cr_assert_eq(r[0], 0);
+  cr_assert_eq(limb_shr(r, r, n, 100), 0);
+  cr_assert_eq(limb_bit_length(r, 0), 0);
+}
+
+/* a number's remainder by a small prime, without changing it */
+static limb_t limbs_mod (const limb_t* const a, const size_t len, const limb_t p) {
+  limb_t* const tmp = alloc(limb_t, len + 1);
+  memcpy(tmp, a, sz(limb_t, len));
+  const limb_t m = limb_divmod_small(tmp, len, p, NULL);
+  free(tmp);
+  return m;
+}
+
+Test(limb_math, karatsuba_reciprocal) {
+  enum { N = 300, M = 170 };
+  static limb_t a[N], b[M], r[N + M], q[N + M], rem[N + M + 1], v[M + 2];
+  static const limb_t primes[] = { 4294967291U, 4294967279U, 1000000007U };
+
+  uint32_t x = 99;
+  for (size_t i = 0; i < N; i++) { a[i] = x = x * 1664525U + 1013904223U; }
+  for (size_t i = 0; i < M; i++) { b[i] = x = x * 1664525U + 1013904223U; }
+
+  /* the product agrees modulo a few primes */
+  const size_t n = limb_mul(r, a, N, b, M);
+  cr_assert_eq(n, N + M - (0 == r[N + M - 1]));
+  for (size_t i = 0; i < sizeof primes / sizeof primes[0]; i++) {
+    const limb_t p = primes[i];
+    cr_assert_eq(limbs_mod(r, n, p), (limb_t) ((dlimb_t) limbs_mod(a, N, p) * limbs_mod(b, M, p) % p));
+  }
+
+  /* (a' * b + 12345) / b, for an a' short enough to be below B^(2 M) */
+  const size_t v_len = limb_reciprocal(v, b, M);
+  cr_assert_gt(v_len, 0);
+
+  const limb_t extra = 12345;
+  size_t ab = limb_mul(r, a, M - 1, b, M);
+  ab = limb_add(r, r, ab, &extra, 1);
+
+  size_t rem_len = 0;
+  const size_t q_len = limb_div_reciprocal(q, rem, &rem_len, r, ab, b, M, v, v_len);
+  cr_assert_eq(q_len, limb_normalize(a, M - 1));
+  cr_assert_eq(limb_cmp(q, q_len, a, q_len), 0);
+  cr_assert_eq(rem_len, 1);
+  cr_assert_eq(rem[0], extra);
+}
+
+Test(limb_math, pow5_div) {
+  enum { E = 2000 };
+  static limb_t p[E / 13 + 3], slow[E / 13 + 3], q[2 * (E / 13 + 3)], n[2 * (E / 13 + 3)];
+
+  /* squaring agrees with multiplying by 5^13 over and over */
+  const size_t p_len = limb_pow5(p, E);
+  slow[0] = 1;
+  cr_assert_eq(p_len, limb_mul_pow5(slow, 1, E));
+  cr_assert_eq(limb_cmp(p, p_len, slow, p_len), 0);
+
+  /* 5^E 5^100 / 5^100 = 5^E, with n far longer than twice d */
+  const size_t d_len = limb_pow5(slow, 100);
+  const size_t n_len = limb_mul(n, p, p_len, slow, d_len);
+  const size_t q_len = limb_div(q, n, n_len, slow, d_len);
+  cr_assert_eq(q_len, p_len);
+  cr_assert_eq(limb_cmp(q, q_len, p, p_len), 0);
+
+  cr_assert_eq(limb_div(q, slow, d_len, p, p_len), 0);
+}
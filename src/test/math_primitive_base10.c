@@ -29,6 +29,15 @@ Test(mathpr_b10, int_pred) {
   const atom_t e1[] = { 9, 9, 9 };
   cr_assert_arr_eq(e1, f, 3);
   free(f);
+
+  /* a zero before the last nonzero digit is kept */
+  const atom_t g[] = { 1, 0, 2, 0 };
+  uint16_t g_len = 0;
+  f = pred_b10(g, 4, 4, 0, &g_len, NULL);
+  const atom_t g1[] = { 1, 0, 1, 9 };
+  cr_assert_eq(g_len, 4);
+  cr_assert_arr_eq(g1, f, 4);
+  free(f);
 }
 
 Test(mathpr_b10, flot_pred) {
@@ -45,4 +54,59 @@ Test(mathpr_b10, int_succ) {
   const atom_t a1[] = { 1, 2, 4 };
   cr_assert_arr_eq(a1, f, 3);
   free(f);
+
+  const atom_t b[] = { 1, 9, 9 };
+  f = succ_b10(b, 3, 3, 0, NULL, NULL);
+  const atom_t b1[] = { 2, 0, 0 };
+  cr_assert_arr_eq(b1, f, 3);
+  free(f);
+
+  uint16_t c_len = 0;
+  const atom_t c[] = { 9, 9 };
+  f = succ_b10(c, 2, 2, 0, &c_len, NULL);
+  const atom_t c1[] = { 1, 0, 0 };
+  cr_assert_eq(c_len, 3);
+  cr_assert_arr_eq(c1, f, 3);
+  free(f);
+}
+
+Test(mathpr_b10, into) {
+  /* counting up in place, in one buffer */
+  atom_t buf[4] = { 0 };
+  size_t len = 1, int_len = 0;
+  for (size_t i = 0; i < 999; i++) {
+    len = succ_b10_into(buf, sizeof buf, buf, len, len, 0, &int_len);
+  }
+  const atom_t nines[] = { 9, 9, 9 };
+  cr_assert_eq(len, 3);
+  cr_assert_eq(int_len, 3);
+  cr_assert_arr_eq(buf, nines, 3);
+
+  /* too small: the size is returned, and nothing written */
+  cr_assert_eq(4, succ_b10_into(buf, 3, buf, 3, 3, 0, NULL));
+  cr_assert_arr_eq(buf, nines, 3);
+  cr_assert_eq(4, succ_b10_into(buf, 4, buf, 3, 3, 0, NULL));
+
+  len = pred_b10_into(buf, sizeof buf, buf, 4, 4, 0, NULL);
+  cr_assert_eq(len, 3);
+  cr_assert_arr_eq(buf, nines, 3);
+
+  /* floor and ceiling of 12.5 and 12.0 */
+  const atom_t a[] = { 1, 2, 5 }, b[] = { 1, 2, 0 };
+  atom_t out[4];
+  cr_assert_eq(2, floor_b10_into(out, sizeof out, a, 3, 2, NULL));
+  cr_assert(1 == out[0] && 2 == out[1]);
+  cr_assert_eq(2, ceil_b10_into(out, sizeof out, a, 3, 2, NULL));
+  cr_assert(1 == out[0] && 3 == out[1]);
+  cr_assert_eq(2, ceil_b10_into(out, sizeof out, b, 3, 2, NULL));
+  cr_assert(1 == out[0] && 2 == out[1]);
+
+  /* lengths past a big array's */
+  static atom_t wide[70001];
+  memset(wide, 9, 70000);
+  cr_assert_eq(70001, succ_b10_into(wide, sizeof wide, wide, 70000, 70000, 0, &int_len));
+  cr_assert_eq(int_len, 70001);
+  cr_assert(1 == wide[0] && 0 == wide[70000]);
+  cr_assert_eq(70000, pred_b10_into(wide, sizeof wide, wide, 70001, 70001, 0, &int_len));
+  cr_assert(9 == wide[0] && 9 == wide[69999]);
 }
@@ -49,3 +49,152 @@ Test(metadata, basic) {
   cr_assert_arr_eq(m, f, sz(atom_t, HEADER_OFFSET));
   free(m);
 }
+
+Test(metadata, huge) {
+  atom_t* m = make_array_header(TYP_HUGE | TYP_ZENZ, 70000, 3, FL_SIGN);
+  atom_t a[HEADER_OFFSET_HUGE] = { TYP_HUGE | TYP_ZENZ, 0, 1, 0x11, 0x70, 0, 0, 0, 3, FL_SIGN };
+
+  cr_assert_arr_eq(m, a, sz(atom_t, HEADER_OFFSET_HUGE));
+  cr_assert_eq(bna_header_offset(m), HEADER_OFFSET_HUGE);
+  cr_assert_eq(bna_int_len(m), 70000);
+  cr_assert_eq(bna_frac_len(m), 3);
+  cr_assert_eq(bna_flags(m), FL_SIGN);
+  free(m);
+
+  /* both modes set is huge */
+  m = make_array_header(TYP_HUGE | TYP_BIG, 1, 2, FL_NONE);
+  cr_assert_eq(bna_header_offset(m), HEADER_OFFSET_HUGE);
+  cr_assert_eq(bna_frac_len(m), 2);
+  free(m);
+
+  /* lengths past the mode are an error rather than cut short */
+  errno = 0;
+  cr_assert_null(make_array_header(TYP_BIG, 65536, 0, FL_NONE));
+  cr_assert_eq(errno, ERANGE);
+
+  errno = 0;
+  cr_assert_null(make_array_header(TYP_NONE, 0, 256, FL_NONE));
+  cr_assert_eq(errno, ERANGE);
+
+  cr_assert_eq(meta_max_len(TYP_HUGE), UINT32_MAX);
+}
+
+Test(metadata, huge_arrays) {
+  /* 70000 digits of integer part and one of fraction */
+  enum { N = 70002 };
+  char* const str = alloc(char, N + 1);
+  memset(str, '3', N);
+  str[N - 2] = '.', str[N] = '\0';
+
+  errno = 0;
+  cr_assert_null(str_to_digit_array(str, N, TYP_BIG));
+  cr_assert_eq(errno, ERANGE);
+
+  atom_t* const bna = str_to_digit_array(str, N, TYP_HUGE);
+  cr_assert_not_null(bna);
+  cr_assert_eq(bna_int_len(bna), 70000);
+  cr_assert_eq(bna_frac_len(bna), 1);
+  cr_assert_eq(bna_real_len(bna), HEADER_OFFSET_HUGE + 70001);
+
+  char* const back = b10_to_ldbl_digits(bna + HEADER_OFFSET_HUGE, bna_int_len(bna) + bna_frac_len(bna), bna_int_len(bna));
+  cr_assert_str_eq(back, str);
+  free(back);
+
+  /* far past the range of a double, and of an int32_t exponent once scaled */
+  errno = 0;
+  cr_assert(isinf(digit_array_to_dbl(bna)));
+  cr_assert_eq(errno, ERANGE);
+  free(bna);
+
+  /* and the same in base 256 */
+  atom_t* const zna = str_to_digit_array(str, N, TYP_HUGE | TYP_ZENZ);
+  cr_assert_not_null(zna);
+  cr_assert(bna_int_len(zna) > UINT16_MAX / 3);
+  cr_assert(isinf(digit_array_to_ldbl(zna)));
+  free(zna);
+
+  free(str);
+}
+
+Test(metadata, compact) {
+  /* a small integer takes one byte */
+  atom_t* m = make_array_header(TYP_COMPACT, 6, 0, FL_NONE);
+  cr_assert_eq(m[0], TYP_COMPACT | CMP_SHORT | 0x04 | 0x08);
+  cr_assert_eq(bna_header_offset(m), HEADER_OFFSET_SHORT);
+  cr_assert_eq(bna_int_len(m), 6);
+  cr_assert_eq(bna_frac_len(m), 0);
+  cr_assert_eq(bna_flags(m), FL_NONE);
+  cr_assert(! bna_is_big(m) && ! bna_is_huge(m));
+  free(m);
+
+  /* anything else takes two */
+  m = make_array_header(TYP_COMPACT | TYP_ZENZ, 15, 9, FL_SIGN | FL_INF);
+  atom_t a[HEADER_OFFSET_COMPACT] = { TYP_COMPACT | TYP_ZENZ | 0x01 | 0x08, 0xF9 };
+  cr_assert_arr_eq(m, a, sz(atom_t, HEADER_OFFSET_COMPACT));
+  cr_assert(bna_is_base256(m));
+  cr_assert_eq(bna_int_len(m), 15);
+  cr_assert_eq(bna_frac_len(m), 9);
+  cr_assert_eq(bna_flags(m), FL_SIGN | FL_INF);
+  free(m);
+
+  m = make_array_header(TYP_COMPACT, 8, 0, FL_NONE);
+  cr_assert_eq(bna_header_offset(m), HEADER_OFFSET_COMPACT);
+  cr_assert_eq(bna_int_len(m), 8);
+  free(m);
+
+  /* the other modes' bits mean nothing, and are not kept */
+  m = make_array_header(TYP_COMPACT | TYP_HUGE | TYP_BIG | TYP_EXTN, 1, 1, FL_NAN);
+  cr_assert_eq(m[0], TYP_COMPACT | 0x04);
+  cr_assert_eq(bna_flags(m), FL_NAN);
+  free(m);
+
+  errno = 0;
+  cr_assert_null(make_array_header(TYP_COMPACT, 16, 0, FL_NONE));
+  cr_assert_eq(errno, ERANGE);
+  cr_assert_eq(meta_max_len(TYP_COMPACT | TYP_HUGE), CMP_MAX_LEN);
+}
+
+Test(metadata, compact_arrays) {
+  atom_t* m = to_digit_array(0, 123456, FL_NONE, TYP_COMPACT);
+  atom_t a[] = { TYP_COMPACT | CMP_SHORT | 0x04 | 0x08, 1, 2, 3, 4, 5, 6 };
+  cr_assert_arr_eq(m, a, sizeof a);
+  cr_assert_eq(bna_real_len(m), sizeof a);
+  free(m);
+
+  m = str_to_digit_array("-12.5", 5, TYP_COMPACT);
+  atom_t b[] = { TYP_COMPACT | 0x01, 0x21, 1, 2, 5 };
+  cr_assert_arr_eq(m, b, sizeof b);
+  cr_assert(compare_eps(digit_array_to_dbl(m), -12.5, 1e-12));
+  free(m);
+
+  m = to_digit_array(0.25L, 0, FL_NONE, TYP_COMPACT | TYP_ZENZ);
+  cr_assert_eq(bna_header_offset(m), HEADER_OFFSET_COMPACT);
+  cr_assert(compare_eps(digit_array_to_dbl(m), 0.25, 1e-12));
+  free(m);
+
+  m = to_digit_array(NAN, 0, FL_NONE, TYP_COMPACT);
+  cr_assert_eq(bna_real_len(m), HEADER_OFFSET_COMPACT);
+  cr_assert(isnan(digit_array_to_dbl(m)));
+  free(m);
+
+  /* packed words and BCD bytes are counted just the same */
+  m = str_to_digit_array("98765", 5, TYP_COMPACT | TYP_BCD);
+  cr_assert(bna_is_bcd(m));
+  cr_assert_eq(bna_header_offset(m), HEADER_OFFSET_SHORT);
+  cr_assert_eq(bna_int_len(m), 3);
+  atom_t* const back = bcd_array_to_b10_array(m);
+  atom_t c[] = { TYP_COMPACT | CMP_SHORT | 0x01 | 0x08, 9, 8, 7, 6, 5 };
+  cr_assert_arr_eq(back, c, sizeof c);
+  free(back), free(m);
+
+  m = to_digit_array(0, UINT64_MAX, FL_NONE, TYP_COMPACT | TYP_PACK);
+  cr_assert(bna_is_packed(m));
+  cr_assert_eq(bna_int_len(m), 2);
+  cr_assert_eq(pk_load(m + HEADER_OFFSET_SHORT + 8), UINT64_MAX % 10000000000000000000U);
+  free(m);
+
+  /* past 15 digits, a compact array cannot be made */
+  errno = 0;
+  cr_assert_null(to_digit_array(0, 1234567890123456, FL_NONE, TYP_COMPACT));
+  cr_assert_eq(errno, ERANGE);
+}
@@ -0,0 +1,154 @@
+#include <criterion/criterion.h>
+
+#include "../lib/bn_common.h"
+
+/* scanning numeric literals, and the arrays made from them */
+
+Test(numlit, scan) {
+  numlit_t lit;
+
+  cr_assert(scan_numlit(&lit, "-012.50e+3", 10));
+  cr_assert(lit.has_sign && lit.has_sep && lit.has_exp);
+  cr_assert_eq(lit.flags, FL_SIGN);
+  cr_assert_eq(lit.int_len, 3);
+  cr_assert_eq(lit.frac_len, 2);
+  cr_assert_eq(lit.exp, 3);
+  cr_assert_eq(lit.frac_digits[0], '5');
+
+  cr_assert(scan_numlit(&lit, ".5", 2));
+  cr_assert_eq(lit.int_len, 0);
+  cr_assert_eq(lit.frac_len, 1);
+
+  cr_assert(scan_numlit(&lit, "7.E-2", 5));
+  cr_assert_eq(lit.int_len, 1);
+  cr_assert_eq(lit.frac_len, 0);
+  cr_assert_eq(lit.exp, -2);
+
+  /* only the view is scanned */
+  cr_assert(scan_numlit(&lit, "42x", 2));
+  cr_assert_eq(lit.int_len, 2);
+
+  static const char* const bad[] = { "", "-", ".", "+.", "1e", "1e+", "e5", "1.2.3", "1 ", "--1", "1x", "1e5.0" };
+  for (size_t i = 0; i < sizeof bad / sizeof bad[0]; i++) {
+    errno = 0;
+    cr_assert_not(scan_numlit(&lit, bad[i], strlen(bad[i])));
+    cr_assert_eq(errno, EINVAL);
+  }
+
+  errno = 0;
+  cr_assert_not(scan_numlit(&lit, "1e1000000000", 12));
+  cr_assert_eq(errno, ERANGE);
+}
+
+Test(numlit, laid_out) {
+  numlit_t lit;
+  size_t lead = 0, trail = 0, int_len = 0;
+  atom_t out[8];
+
+  /* 1500 */
+  cr_assert(scan_numlit(&lit, "1.5e3", 5));
+  cr_assert_eq(numlit_layout(&lit, &lead, &trail, &int_len), 4);
+  cr_assert_eq(lead, 0);
+  cr_assert_eq(trail, 2);
+  cr_assert_eq(int_len, 4);
+
+  const atom_t big[] = { 1, 5, 0, 0 }, little[] = { 0, 0, 5, 1 };
+  cr_assert_eq(numlit_to_b10(out, &lit, false), 4);
+  cr_assert_arr_eq(out, big, 4);
+  numlit_to_b10(out, &lit, true);
+  cr_assert_arr_eq(out, little, 4);
+
+  /* .0015 */
+  cr_assert(scan_numlit(&lit, "1.5e-3", 6));
+  cr_assert_eq(numlit_layout(&lit, &lead, &trail, &int_len), 4);
+  cr_assert_eq(lead, 2);
+  cr_assert_eq(trail, 0);
+  cr_assert_eq(int_len, 0);
+
+  const atom_t frac[] = { 0, 0, 1, 5 };
+  numlit_to_b10(out, &lit, false);
+  cr_assert_arr_eq(out, frac, 4);
+}
+
+Test(numlit, to_array) {
+  atom_t* a = str_to_digit_array("-0012.5", 7, TYP_NONE);
+  const atom_t neg[] = { TYP_NONE, 2, 1, FL_SIGN, 1, 2, 5 };
+  cr_assert_arr_eq(a, neg, sizeof neg);
+  free(a);
+
+  a = str_to_digit_array("25e-3", 5, TYP_BIG);
+  const atom_t small[] = { TYP_BIG, 0, 0, 0, 3, FL_NONE, 0, 2, 5 };
+  cr_assert_arr_eq(a, small, sizeof small);
+  free(a);
+
+  /* 2^16 + 0.5 */
+  a = str_to_digit_array("+655365e-1", 10, TYP_ZENZ);
+  const atom_t zenz[] = { TYP_ZENZ, 3, 1, FL_NONE, 1, 0, 0, 128 };
+  cr_assert_arr_eq(a, zenz, sizeof zenz);
+  free(a);
+
+  /* zero, however it is written */
+  a = str_to_digit_array("0e999999999", 11, TYP_NONE);
+  const atom_t zero[] = { TYP_NONE, 0, 0, FL_NONE };
+  cr_assert_arr_eq(a, zero, sizeof zero);
+  free(a);
+
+  errno = 0;
+  cr_assert_null(str_to_digit_array("1e255", 5, TYP_NONE));
+  cr_assert_eq(errno, ERANGE);
+
+  errno = 0;
+  cr_assert_null(str_to_digit_array("1.5.", 4, TYP_NONE));
+  cr_assert_eq(errno, EINVAL);
+}
+
+Test(numlit, too_many_zeroes) {
+  size_t len = 0, int_len = 0;
+
+  /* a huge array's header could describe these, but they are refused before they are made */
+  static const char* const far[] = { "1e999999999", "1e-999999999", "0e-999999999" };
+  for (size_t i = 0; i < sizeof far / sizeof far[0]; i++) {
+    errno = 0;
+    cr_assert_null(str_to_digit_array(far[i], strlen(far[i]), TYP_HUGE));
+    cr_assert_eq(errno, ERANGE);
+  }
+
+  errno = 0;
+  cr_assert_null(ldbl_digits_to_b10_z("1e999999999", 11, &len, &int_len, false));
+  cr_assert_eq(errno, ERANGE);
+
+  errno = 0;
+  cr_assert_null(ldbl_digits_to_b256_z("1e-999999999", 12, &len, &int_len, false));
+  cr_assert_eq(errno, ERANGE);
+
+  /* up to the limit is fine */
+  atom_t* const a = ldbl_digits_to_b10_z("1e70000", 7, &len, &int_len, false);
+  cr_assert_not_null(a);
+  cr_assert_eq(len, 70001);
+  free(a);
+}
+
+Test(numlit, into) {
+  static const char* const lits[] = { "-0012.5", "25e-3", "+655365e-1", "0e99", "98765432109876543210.5", "0.000" };
+  const atom_t modes[] = { TYP_NONE, TYP_BIG, TYP_ZENZ, TYP_PACK, TYP_BCD, TYP_COMPACT | TYP_PACK, TYP_HUGE | TYP_BCD };
+
+  for (size_t i = 0; i < sizeof lits / sizeof lits[0]; i++) {
+    for (size_t j = 0; j < sizeof modes; j++) {
+      atom_t* const want = str_to_digit_array(lits[i], strlen(lits[i]), modes[j]);
+      cr_assert_not_null(want, "%s in mode %d", lits[i], modes[j]);
+
+      /* the same array, of a size asked for first */
+      atom_t out[64];
+      const size_t need = str_to_digit_array_into(NULL, 0, lits[i], strlen(lits[i]), modes[j]);
+      cr_assert_eq(need, bna_size(want), "%s in mode %d", lits[i], modes[j]);
+      cr_assert_eq(str_to_digit_array_into(out, need - 1, lits[i], strlen(lits[i]), modes[j]), need);
+      cr_assert_eq(str_to_digit_array_into(out, sizeof out, lits[i], strlen(lits[i]), modes[j]), need);
+      cr_assert_arr_eq(out, want, need, "%s in mode %d", lits[i], modes[j]);
+      free(want);
+    }
+  }
+
+  errno = 0;
+  cr_assert_eq(str_to_digit_array_into(NULL, 0, "1e999999999", 11, TYP_HUGE | TYP_PACK), 0);
+  cr_assert_eq(errno, ERANGE);
+}
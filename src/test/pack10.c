@@ -0,0 +1,114 @@
+#include <criterion/criterion.h>
+
+#include "../lib/bn_common.h"
+
+Test(pack10, digits) {
+  /* 12345678901234567890123.45 */
+  static const atom_t d[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 1, 2, 3, 4, 5 };
+  uint64_t w[4];
+  atom_t back[4 * PK_DIGITS];
+  size_t int_len = 0;
+
+  cr_assert_eq(b10_to_pk(w, d, 25, 23, &int_len), 3);
+  cr_assert_eq(int_len, 2);
+  cr_assert_eq(w[0], 1234);
+  cr_assert_eq(w[1], 5678901234567890123U);
+  cr_assert_eq(w[2], 4500000000000000000U);
+
+  cr_assert_eq(pk_to_b10(back, w, 3, 2, &int_len), 25);
+  cr_assert_eq(int_len, 23);
+  cr_assert_arr_eq(back, d, 25);
+
+  /* no integer part, and zeroes are dropped at both ends */
+  w[0] = 0, w[1] = 7, w[2] = 0;
+  cr_assert_eq(pk_to_b10(back, w, 3, 1, &int_len), 19);
+  cr_assert_eq(int_len, 0);
+  cr_assert_eq(back[18], 7);
+
+  atom_t raw[8];
+  pk_store(raw, 0x0102030405060708U);
+  /* most significant byte first, like the lengths in a header */
+  cr_assert_eq(raw[0], 1);
+  cr_assert_eq(raw[7], 8);
+  cr_assert_eq(pk_load(raw), 0x0102030405060708U);
+}
+
+Test(pack10, math) {
+  static const uint64_t nines[] = { PK_BASE - 1, PK_BASE - 1 }, one[] = { 1 }, half[] = { 0, 5000000000000000000U };
+  size_t len = 0, int_len = 0;
+
+  /* 10^38 - 1 + 1 carries all the way */
+  uint64_t* r = add_pk(nines, 2, 2, one, 1, 1, &len, &int_len);
+  cr_assert_eq(len, 3);
+  cr_assert_eq(int_len, 3);
+  cr_assert(1 == r[0] && 0 == r[1] && 0 == r[2]);
+  free(r);
+
+  /* and borrows back */
+  const uint64_t big[] = { 1, 0, 0 };
+  r = sub_pk(big, 3, 3, one, 1, 1, &len, &int_len);
+  cr_assert_eq(len, 2);
+  cr_assert_arr_eq(r, nines, 2);
+  free(r);
+
+  errno = 0;
+  cr_assert_null(sub_pk(one, 1, 1, big, 3, 3, &len, &int_len));
+  cr_assert_eq(errno, ERANGE);
+
+  /* 0.5 + 0.5 = 1, with the fraction gone */
+  r = add_pk(half, 2, 1, half, 2, 1, &len, &int_len);
+  cr_assert_eq(len, 1);
+  cr_assert_eq(int_len, 1);
+  cr_assert_eq(r[0], 1);
+  free(r);
+
+  /* (10^38 - 1)^2 = 10^76 - 2 10^38 + 1 */
+  r = mul_pk(nines, 2, 2, nines, 2, 2, &len, &int_len);
+  cr_assert_eq(len, 4);
+  cr_assert(PK_BASE - 1 == r[0] && PK_BASE - 2 == r[1] && 0 == r[2] && 1 == r[3]);
+  free(r);
+
+  /* 0.5 * 0.5 = 0.25, in the first fractional word */
+  r = mul_pk(half + 1, 1, 0, half + 1, 1, 0, &len, &int_len);
+  cr_assert_eq(len, 1);
+  cr_assert_eq(int_len, 0);
+  cr_assert_eq(r[0], 2500000000000000000U);
+  free(r);
+}
+
+Test(pack10, arrays) {
+  static const char lit[] = "-123456789012345678901.0625";
+
+  atom_t* const pna = str_to_digit_array(lit, sizeof lit - 1, TYP_PACK);
+  cr_assert_not_null(pna);
+  cr_assert(bna_is_packed(pna));
+  cr_assert_eq(bna_int_len(pna), 2);
+  cr_assert_eq(bna_frac_len(pna), 1);
+  cr_assert_eq(bna_flags(pna), FL_SIGN);
+  cr_assert_eq(pk_load(pna + HEADER_OFFSET), 12);
+  cr_assert_eq(pk_load(pna + HEADER_OFFSET + 16), 625000000000000000U);
+
+  atom_t* const bna = pk_array_to_b10_array(pna);
+  char* const str = b10_to_ldbl_digits(bna + HEADER_OFFSET, (uint16_t) (bna_int_len(bna) + bna_frac_len(bna)), bna_int_len(bna));
+  cr_assert_str_eq(str, lit + 1);
+  cr_assert_eq(bna_flags(bna), FL_SIGN);
+  free(str), free(bna);
+
+  cr_assert(compare_eps(digit_array_to_dbl(pna), -123456789012345678901.0625, 1));
+  free(pna);
+
+  /* 255 words of 19 digits fit, where a base 10 array takes 255 digits */
+  char many[400];
+  memset(many, '9', sizeof many);
+  atom_t* const wide = str_to_digit_array(many, sizeof many, TYP_PACK);
+  cr_assert_not_null(wide);
+  cr_assert_eq(bna_int_len(wide), 22);
+  free(wide);
+
+  atom_t* const from_u64 = to_digit_array(0, 12345678901234567890U, FL_NONE, TYP_PACK | TYP_BIG);
+  cr_assert_not_null(from_u64);
+  cr_assert_eq(bna_int_len(from_u64), 2);
+  cr_assert_eq(pk_load(from_u64 + HEADER_OFFSET_BIG), 1);
+  cr_assert_eq(pk_load(from_u64 + HEADER_OFFSET_BIG + 8), 2345678901234567890U);
+  free(from_u64);
+}
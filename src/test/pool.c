@@ -0,0 +1,43 @@
+#include <criterion/criterion.h>
+
+#include "../lib/bn_common.h"
+
+Test(pool, reuse) {
+  const bn_allocator_t pool = bn_pool_allocator();
+  cr_assert(bn_set_allocator(&pool));
+
+  /* a freed block is the next one of its class to be handed out */
+  atom_t* const a = alloc(atom_t, 40);
+  cr_assert_not_null(a);
+  cr_assert_eq((uintptr_t) a % 16, 0);
+  bn_free(a);
+  atom_t* const b = alloc(atom_t, 33);
+  cr_assert_eq(b, a);
+
+  /* but not one of another class */
+  atom_t* const c = alloc(atom_t, 20);
+  cr_assert_neq(c, a);
+
+  /* growing within the class keeps the block, and out of it keeps the atoms */
+  for (size_t i = 0; i < 40; i++) { b[i] = (atom_t) i; }
+  cr_assert_eq(bn_realloc(b, 64), b);
+  atom_t* const d = (atom_t*) bn_realloc(b, 5000);
+  cr_assert_neq(d, b);
+  for (size_t i = 0; i < 40; i++) { cr_assert_eq(d[i], i); }
+
+  /* blocks too large to keep are grown and shrunk like any other */
+  atom_t* const e = (atom_t*) bn_realloc(d, 9000);
+  for (size_t i = 0; i < 40; i++) { cr_assert_eq(e[i], i); }
+  atom_t* const f = (atom_t*) bn_realloc(e, 50);
+  for (size_t i = 0; i < 40; i++) { cr_assert_eq(f[i], i); }
+  bn_free(f), bn_free(c);
+
+  /* the library works the same on top of it */
+  atom_t* const bna = str_to_digit_array("-1234.5e3", 9, TYP_ZENZ);
+  atom_t* const want = str_to_digit_array("-1234500", 8, TYP_ZENZ);
+  cr_assert_arr_eq(bna, want, bna_real_len(want));
+  bn_free(bna), bn_free(want);
+
+  bn_pool_release();
+  cr_assert(bn_set_allocator(NULL));
+}
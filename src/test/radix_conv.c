@@ -0,0 +1,104 @@
+#include <criterion/criterion.h>
+
+#include "../lib/bn_common.h"
+
+/* integers in any radix, checked against known values and other conversions */
+
+Test(radix_conv, small) {
+  const atom_t ff[] = { 0xff }, zero[] = { 0 }, b10[] = { 0, 0, 6, 2 };
+  size_t len = 0;
+
+  char* s = b256_to_radix(ff, 1, 2);
+  cr_assert_str_eq(s, "11111111");
+  free(s);
+
+  s = b256_to_radix(ff, 1, 36);
+  cr_assert_str_eq(s, "73");
+  free(s);
+
+  /* leading zeroes are not written, and zero is one digit */
+  s = b10_to_radix(b10, 4, 62);
+  cr_assert_str_eq(s, "10");
+  free(s);
+
+  s = b256_to_radix(zero, 1, 7);
+  cr_assert_str_eq(s, "0");
+  free(s);
+
+  /* either case up to 36, and both from 37 */
+  atom_t* a = radix_to_b256_n("3Zz", 2, 36, &len);
+  cr_assert_eq(len, 1);
+  cr_assert_eq(a[0], 3 * 36 + 35);
+  free(a);
+
+  a = radix_to_b10_n("zZ", 2, 62, &len);
+  /* 61 * 62 + 35 */
+  const atom_t mixed[] = { 3, 8, 1, 7 };
+  cr_assert_eq(len, 4);
+  cr_assert_arr_eq(a, mixed, 4);
+  free(a);
+
+  a = radix_to_b256_n("000", 3, 10, &len);
+  cr_assert_eq(len, 1);
+  cr_assert_eq(a[0], 0);
+  free(a);
+
+  char buf[4] = "?";
+  cr_assert_eq(b256_to_radix_into(buf, 2, ff, 1, 16), 2);
+  cr_assert_eq(buf[0], '?');
+  cr_assert_eq(b256_to_radix_into(buf, 3, ff, 1, 16), 2);
+  cr_assert_str_eq(buf, "ff");
+
+  errno = 0;
+  cr_assert_null(radix_to_b10_n("19", 2, 9, &len));
+  cr_assert_eq(errno, EINVAL);
+
+  errno = 0;
+  cr_assert_null(b256_to_radix(ff, 1, 63));
+  cr_assert_eq(errno, EINVAL);
+  cr_assert_null(b256_to_radix(ff, 1, 1));
+}
+
+/* long enough for every level of the divide and conquer */
+Test(radix_conv, large) {
+  enum { N = 20000 };
+  atom_t* const digits = alloc(atom_t, N);
+  char* const expect = alloc(char, N + 1);
+  size_t len = 0;
+
+  uint32_t x = 12345;
+  for (size_t i = 0; i < N; i++) {
+    x = x * 1103515245U + 12345U;
+    digits[i] = (atom_t) ((x >> 16) % 10);
+  }
+  digits[0] = 7;
+
+  /* base 10 to base 10 is the same digits, through limbs and back */
+  char* s = b10_to_radix(digits, N, 10);
+  digits_to_chars(expect, digits, N, false);
+  expect[N] = '\0';
+  cr_assert_str_eq(s, expect);
+  free(s);
+
+  /* to radix 36 and back */
+  s = b10_to_radix(digits, N, 36);
+  atom_t* a = radix_to_b10_n(s, strlen(s), 36, &len);
+  cr_assert_eq(len, N);
+  cr_assert_arr_eq(a, digits, N);
+  free(a), free(s);
+
+  /* radix 16 agrees with the bit repacking of radix_pow2 */
+  atom_t* const bytes = alloc(atom_t, N);
+  for (size_t i = 0; i < N; i++) { bytes[i] = (atom_t) (digits[i] * 25 + i); }
+
+  s = b256_to_radix(bytes, N, 16);
+  char* const hex = b256_to_hex(bytes, N, false);
+  cr_assert_str_eq(s, hex + (hex[0] == '0'));
+
+  a = radix_to_b256_n(s, strlen(s), 16, &len);
+  cr_assert_eq(len, N);
+  cr_assert_arr_eq(a, bytes, N);
+  free(a), free(s), free(hex);
+
+  free(bytes), free(digits), free(expect);
+}
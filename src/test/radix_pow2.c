@@ -0,0 +1,155 @@
+#include <criterion/criterion.h>
+
+#include "../lib/bn_common.h"
+
+/* base 256 <-> hex, octal and base64 */
+
+Test(radix_pow2, hex) {
+  const atom_t id[] = { 0x00, 0x1f, 0xa0, 0xff };
+  size_t len = 0;
+
+  char* s = b256_to_hex(id, 4, false);
+  cr_assert_str_eq(s, "001fa0ff");
+  free(s);
+
+  s = b256_to_hex(id, 4, true);
+  cr_assert_str_eq(s, "001FA0FF");
+  free(s);
+
+  atom_t* a = hex_to_b256_n("001fA0Ff", 8, &len);
+  cr_assert_eq(len, 4);
+  cr_assert_arr_eq(a, id, 4);
+  free(a);
+
+  /* an implied leading zero */
+  a = hex_to_b256_n("1fa0ffx", 6, &len);
+  cr_assert_eq(len, 3);
+  cr_assert_arr_eq(a, id + 1, 3);
+  free(a);
+
+  errno = 0;
+  cr_assert_null(hex_to_b256_n("0g", 2, &len));
+  cr_assert_eq(errno, EINVAL);
+  cr_assert_eq(len, 0);
+
+  cr_assert_null(hex_to_b256_n("", 0, &len));
+}
+
+Test(radix_pow2, hex_round_trip) {
+  atom_t digits[100];
+  char str[201];
+  size_t len = 0;
+
+  for (size_t i = 0; i < 100; i++) {
+    digits[i] = (atom_t) (i * 37 + 11);
+  }
+
+  /* every length, through every vector width and the tails */
+  for (size_t n = 1; n <= 100; n++) {
+    cr_assert_eq(b256_to_hex_into(str, sizeof str, digits, n, n & 1), 2 * n);
+
+    for (size_t i = 0; i < n; i++) {
+      char pair[3];
+      snprintf(pair, sizeof pair, n & 1 ? "%02X" : "%02x", digits[i]);
+      cr_assert(pair[0] == str[2 * i] && pair[1] == str[2 * i + 1]);
+    }
+
+    atom_t* const a = hex_to_b256_n(str, 2 * n, &len);
+    cr_assert_eq(len, n);
+    cr_assert_arr_eq(a, digits, n);
+    free(a);
+
+    /* a bad character anywhere */
+    for (size_t at = 0; at < 2 * n; at += 7) {
+      const char keep = str[at];
+      str[at] = ':';
+      cr_assert_null(hex_to_b256_n(str, 2 * n, &len));
+      str[at] = keep;
+    }
+  }
+
+  /* too small a buffer is left alone */
+  str[0] = '?';
+  cr_assert_eq(b256_to_hex_into(str, 8, digits, 4, false), 8);
+  cr_assert_eq(str[0], '?');
+}
+
+Test(radix_pow2, oct) {
+  const atom_t one[] = { 0xff }, three[] = { 0x12, 0x34, 0x56 };
+  size_t len = 0;
+
+  char* s = b256_to_oct(one, 1);
+  cr_assert_str_eq(s, "377");
+  free(s);
+
+  /* 0x123456 */
+  s = b256_to_oct(three, 3);
+  cr_assert_str_eq(s, "04432126");
+
+  atom_t* a = oct_to_b256_n(s, 8, &len);
+  cr_assert_eq(len, 3);
+  cr_assert_arr_eq(a, three, 3);
+  free(a), free(s);
+
+  /* 511 needs the rounded up digit */
+  a = oct_to_b256_n("777", 3, &len);
+  const atom_t nines[] = { 0x01, 0xff };
+  cr_assert_eq(len, 2);
+  cr_assert_arr_eq(a, nines, 2);
+  free(a);
+
+  a = oct_to_b256_n("0", 1, &len);
+  cr_assert_eq(len, 1);
+  cr_assert_eq(a[0], 0);
+  free(a);
+
+  errno = 0;
+  cr_assert_null(oct_to_b256_n("18", 2, &len));
+  cr_assert_eq(errno, EINVAL);
+
+  /* every length comes back at its own */
+  atom_t digits[40];
+  for (size_t i = 0; i < 40; i++) {
+    digits[i] = (atom_t) (i * 53);
+  }
+  for (size_t n = 1; n <= 40; n++) {
+    char* const str = b256_to_oct(digits, n);
+    a = oct_to_b256_n(str, strlen(str), &len);
+    cr_assert_eq(len, n);
+    cr_assert_arr_eq(a, digits, n);
+    free(a), free(str);
+  }
+}
+
+Test(radix_pow2, base64) {
+  /* the test vectors of RFC 4648 */
+  static const char* const plain[]   = { "f", "fo", "foo", "foob", "fooba", "foobar" };
+  static const char* const encoded[] = { "Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy" };
+  size_t len = 0;
+
+  for (size_t i = 0; i < 6; i++) {
+    const atom_t* const digits = (const atom_t*) plain[i];
+
+    char* const s = b256_to_base64(digits, i + 1);
+    cr_assert_str_eq(s, encoded[i]);
+    free(s);
+
+    atom_t* a = base64_to_b256_n(encoded[i], strlen(encoded[i]), &len);
+    cr_assert_eq(len, i + 1);
+    cr_assert_arr_eq(a, digits, i + 1);
+    free(a);
+
+    /* without the padding */
+    a = base64_to_b256_n(encoded[i], strcspn(encoded[i], "="), &len);
+    cr_assert_eq(len, i + 1);
+    cr_assert_arr_eq(a, digits, i + 1);
+    free(a);
+  }
+
+  static const char* const bad[] = { "Z", "Zm9=", "Zg=", "Z===", "Zm-v", "====" };
+  for (size_t i = 0; i < sizeof bad / sizeof bad[0]; i++) {
+    errno = 0;
+    cr_assert_null(base64_to_b256_n(bad[i], strlen(bad[i]), &len));
+    cr_assert_eq(errno, EINVAL);
+  }
+}
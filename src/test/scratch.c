@@ -0,0 +1,50 @@
+#include <criterion/criterion.h>
+
+#include "../lib/bn_common.h"
+
+Test(scratch, stack) {
+  const scratch_mark_t mark = scratch_mark();
+
+  atom_t* const a = salloc(atom_t, 5);
+  uint64_t* const b = salloc(uint64_t, 3);
+  cr_assert(NULL != a && NULL != b);
+  cr_assert_eq((uintptr_t) a % 16, 0);
+  cr_assert_eq((uintptr_t) b % 16, 0);
+  cr_assert_neq((void*) a, (void*) b);
+
+  /* after a reset the same space is handed out again */
+  scratch_reset(mark);
+  atom_t* const c = salloc(atom_t, 5);
+  cr_assert_eq(c, a);
+
+  /* a nested mark gives back only what came after it */
+  const scratch_mark_t inner = scratch_mark();
+  atom_t* const d = zsalloc(atom_t, 40);
+  for (size_t i = 0; i < 40; i++) { cr_assert_eq(d[i], 0); }
+  scratch_reset(inner);
+  cr_assert_eq(salloc(atom_t, 1), d);
+
+  scratch_reset(mark);
+}
+
+Test(scratch, growth) {
+  const scratch_mark_t mark = scratch_mark();
+
+  /* what was handed out does not move when more blocks are taken */
+  atom_t* const a = salloc(atom_t, 100);
+  memset(a, 7, 100);
+  atom_t* const big = salloc(atom_t, 1 << 20);
+  cr_assert_not_null(big);
+  memset(big, 1, 1 << 20);
+  for (size_t i = 0; i < 100; i++) { cr_assert_eq(a[i], 7); }
+
+  scratch_reset(mark);
+  cr_assert_eq(salloc(atom_t, 100), a);
+  scratch_reset(mark);
+
+  /* and after a release it is all made afresh */
+  bn_scratch_release();
+  cr_assert_not_null(salloc(atom_t, 10));
+  scratch_reset(mark);
+  bn_scratch_release();
+}
@@ -0,0 +1,85 @@
+#include <criterion/criterion.h>
+
+#include "../lib/bn_common.h"
+
+/* character <-> digit kernels, at every length around the vector widths */
+
+Test(simd_conv, chars_to_digits) {
+  char src[100];
+  atom_t dst[100];
+
+  for (size_t i = 0; i < 100; i++) {
+    src[i] = (char) ('0' + ((i * 7) % 10));
+  }
+
+  for (size_t n = 0; n <= 100; n++) {
+    cr_assert(chars_to_digits(dst, src, n, false));
+    for (size_t i = 0; i < n; i++) {
+      cr_assert_eq(dst[i], (i * 7) % 10);
+    }
+
+    cr_assert(chars_to_digits(dst, src, n, true));
+    for (size_t i = 0; i < n; i++) {
+      cr_assert_eq(dst[i], ((n - 1 - i) * 7) % 10);
+    }
+  }
+}
+
+Test(simd_conv, chars_to_digits_invalid) {
+  static const char bad[] = { '/', ':', '.', ' ', '\0', 'a', (char) 0xB0, (char) 0x3F };
+  char src[70];
+  atom_t dst[70];
+
+  for (size_t n = 1; n <= 70; n++) {
+    for (size_t at = 0; at < n; at++) {
+      for (size_t b = 0; b < sizeof bad; b++) {
+        memset(src, '5', n);
+        src[at] = bad[b];
+        cr_assert_not(chars_to_digits(dst, src, n, false));
+        cr_assert_not(chars_to_digits(dst, src, n, true));
+      }
+    }
+  }
+}
+
+Test(simd_conv, digits_to_chars) {
+  atom_t src[100];
+  char dst[100];
+
+  for (size_t i = 0; i < 100; i++) {
+    src[i] = (atom_t) ((i * 3) % 10);
+  }
+
+  for (size_t n = 0; n <= 100; n++) {
+    digits_to_chars(dst, src, n, false);
+    for (size_t i = 0; i < n; i++) {
+      cr_assert_eq(dst[i], (char) ('0' + (i * 3) % 10));
+    }
+
+    digits_to_chars(dst, src, n, true);
+    for (size_t i = 0; i < n; i++) {
+      cr_assert_eq(dst[i], (char) ('0' + ((n - 1 - i) * 3) % 10));
+    }
+  }
+}
+
+Test(simd_conv, digit_span) {
+  char src[100];
+
+  for (size_t n = 0; n <= 100; n++) {
+    memset(src, '7', n);
+    cr_assert_eq(digit_span(src, n), n);
+
+    /* the first non-digit, in every lane position, and the ones after it */
+    for (size_t at = 0; at < n; at++) {
+      memset(src, '7', n);
+      src[at] = '.';
+      if (at + 1 < n) { src[n - 1] = 'x'; }
+      cr_assert_eq(digit_span(src, n), at);
+    }
+  }
+
+  /* just past either end of the digits */
+  cr_assert_eq(digit_span("/0123456789:", 12), 0);
+  cr_assert_eq(digit_span("0123456789:", 11), 10);
+}
@@ -1,7 +1,23 @@
 #include "lib/addr_interp.c"
+#include "lib/allocator.c"
 #include "lib/array_factory.c"
 #include "lib/base256.c"
 #include "lib/base10.c"
+#include "lib/bcd.c"
 #include "lib/bignum.c"
+#include "lib/bn_buf.c"
+#include "lib/bn_ref.c"
+#include "lib/bn_view.c"
+#include "lib/digit_chain.c"
+#include "lib/digit_stream.c"
+#include "lib/ldbl_conv.c"
+#include "lib/limb_math.c"
 #include "lib/math_primitive_base10.c"
 #include "lib/misc_util.c"
+#include "lib/numlit.c"
+#include "lib/pack10.c"
+#include "lib/pool.c"
+#include "lib/radix_conv.c"
+#include "lib/radix_pow2.c"
+#include "lib/scratch.c"
+#include "lib/simd_conv.c"